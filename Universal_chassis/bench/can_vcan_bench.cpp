@@ -0,0 +1,226 @@
+/*
+ * @Description: CAN 传输层主机测试（Linux SocketCAN，vcan0）
+ *
+ * 在同一虚拟 CAN 接口上运行：
+ *  - 主机侧：SocketCanTransport，与 MotorBus 使用相同的 writeFrames()/read() 接口
+ *  - 驱动器侧：四个仿真 Emm42 驱动器（地址 1~4，独立线程），应答速度模式、多机同步与系统状态读取
+ * 每个周期一次写出四轮速度命令（带同步标志）与广播同步触发帧，再读取四轮系统状态（0x43，31 字节，
+ * 每帧拆为 5 个 CAN 包），统计周期耗时与重组结果。
+ *
+ * 准备虚拟接口（需 root）：
+ *   ip link add dev vcan0 type vcan && ip link set up vcan0
+ * 编译运行（在 Universal_chassis 目录下）：
+ *   g++ -O2 -std=gnu++17 -pthread -Iinclude bench/can_vcan_bench.cpp src/CanTransport.cpp -o can_vcan_bench
+ *   ./can_vcan_bench [接口名]
+ */
+
+#include "StepperMotor/CanTransport.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint32_t nowUs() {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// 仿真驱动器组：一个套接字服务多个地址
+class EmulatedDrivers {
+public:
+    explicit EmulatedDrivers(const char* ifname) {
+        fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+        if (fd < 0) {
+            return;
+        }
+        struct ifreq ifr;
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+        struct sockaddr_can addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.can_family = AF_CAN;
+        if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+            close(fd);
+            fd = -1;
+            return;
+        }
+        addr.can_ifindex = ifr.ifr_ifindex;
+        struct timeval tv = {0, 100000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    ~EmulatedDrivers() {
+        stop();
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool ok() const { return fd >= 0; }
+
+    void start() {
+        running = true;
+        worker = std::thread([this] { loop(); });
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+private:
+    void loop() {
+        struct can_frame frame;
+        while (running) {
+            if (::read(fd, &frame, sizeof(frame)) != static_cast<ssize_t>(sizeof(frame))) {
+                continue;
+            }
+            if (!(frame.can_id & CAN_EFF_FLAG) || frame.can_dlc == 0) {
+                continue;
+            }
+            const uint8_t addr = static_cast<uint8_t>((frame.can_id >> 8) & 0xFF);
+            const uint8_t index = static_cast<uint8_t>(frame.can_id & 0xFF);
+            const uint8_t func = frame.data[0];
+            // 只处理发往地址 1~4 或广播（由地址 1 应答）的命令的最后一包
+            if (addr > 4 || static_cast<size_t>(index) + 1 != Emm42::Can::packetCount(Emm42::requestLength(func))) {
+                continue;
+            }
+            const uint8_t replyAddr = addr == 0 ? 1 : addr;
+
+            Emm42::Frame reply;
+            reply.push(replyAddr);
+            reply.push(func);
+            if (func == 0x43) {
+                // 系统状态：字节数 + 参数个数 + 27 字节参数
+                reply.push(0x1F);
+                reply.push(0x09);
+                for (int i = 0; i < 26; ++i) {
+                    reply.push(static_cast<uint8_t>(replyAddr + i));
+                }
+            } else {
+                reply.push(Emm42::REPLY_OK);
+            }
+            reply.push(Emm42::FIXED_CHECKSUM);
+
+            Emm42::Can::Packet packets[Emm42::Can::MAX_PACKETS];
+            size_t count = Emm42::Can::fragment(reply.span(), packets, Emm42::Can::MAX_PACKETS);
+            for (size_t i = 0; i < count; ++i) {
+                struct can_frame out;
+                memset(&out, 0, sizeof(out));
+                out.can_id = packets[i].id | CAN_EFF_FLAG;
+                out.can_dlc = packets[i].length;
+                memcpy(out.data, packets[i].data, packets[i].length);
+                ::write(fd, &out, sizeof(out));
+            }
+        }
+    }
+
+    int fd = -1;
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
+
+// 等待一组应答：每个解析器各自认领匹配的应答帧
+bool awaitReplies(CanTransport& link, Emm42::ResponseParser* parsers, size_t count, uint32_t timeoutUs) {
+    const uint32_t startUs = nowUs();
+    size_t pending = count;
+    while (pending > 0) {
+        while (pending > 0 && link.available() > 0) {
+            uint8_t byte = static_cast<uint8_t>(link.read());
+            for (size_t i = 0; i < count; ++i) {
+                if (parsers[i].state() == Emm42::ResponseParser::Status::PENDING &&
+                    parsers[i].feed(byte) == Emm42::ResponseParser::Status::COMPLETE) {
+                    --pending;
+                }
+            }
+        }
+        if (nowUs() - startUs > timeoutUs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* ifname = argc > 1 ? argv[1] : "vcan0";
+
+    SocketCanTransport link(ifname);
+    EmulatedDrivers drivers(ifname);
+    if (!link.begin() || !drivers.ok()) {
+        printf("cannot open %s (ip link add dev vcan0 type vcan && ip link set up vcan0)\n", ifname);
+        return 1;
+    }
+    drivers.start();
+
+    const int cycles = 2000;
+    std::vector<uint32_t> samples;
+    samples.reserve(cycles);
+    int failed = 0;
+
+    for (int c = 0; c < cycles; ++c) {
+        const uint32_t startUs = nowUs();
+
+        // 四轮速度命令 + 广播同步触发帧，一次写出
+        Emm42::FixedFrame<8> speed[4];
+        Emm42::ByteSpan frames[5];
+        Emm42::ResponseParser parsers[5];
+        for (uint8_t i = 0; i < 4; ++i) {
+            speed[i] = Emm42::encode<0xF6>(static_cast<uint8_t>(i + 1), ChecksumType::FIXED,
+                                           0, Emm42::U16{60}, 0, 1);
+            frames[i] = speed[i].span();
+            parsers[i].begin(static_cast<uint8_t>(i + 1), 0xF6, ChecksumType::FIXED);
+        }
+        auto sync = Emm42::encode<0xFF>(0, ChecksumType::FIXED, 0x66);
+        frames[4] = sync.span();
+        parsers[4].begin(0, 0xFF, ChecksumType::FIXED);
+        bool ok = link.writeFrames(frames, 5) && awaitReplies(link, parsers, 5, 20000);
+
+        // 四轮系统状态读取
+        Emm42::FixedFrame<4> status[4];
+        for (uint8_t i = 0; i < 4; ++i) {
+            status[i] = Emm42::encode<0x43>(static_cast<uint8_t>(i + 1), ChecksumType::FIXED, 0x7A);
+            frames[i] = status[i].span();
+            parsers[i].begin(static_cast<uint8_t>(i + 1), 0x43, ChecksumType::FIXED);
+        }
+        ok = ok && link.writeFrames(frames, 4) && awaitReplies(link, parsers, 4, 20000);
+
+        if (!ok) {
+            ++failed;
+            continue;
+        }
+        samples.push_back(nowUs() - startUs);
+    }
+    drivers.stop();
+
+    uint64_t sum = 0;
+    uint32_t worst = 0;
+    for (auto us : samples) {
+        sum += us;
+        worst = us > worst ? us : worst;
+    }
+    printf("cycles %d, failed %d, dropped packets %u\n", cycles, failed, link.droppedPackets());
+    if (!samples.empty()) {
+        printf("cycle mean %.1f us, max %u us\n", static_cast<double>(sum) / samples.size(), worst);
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+/*
+ * @Description: 控制命令洪泛基准（主机，NativeHal）
+ *
+ * 测量 ControlManager 命令入口在高频命令下的表现，结果以 JSON 输出，格式与 hot_paths_bench 相同，
+ * 另附 "latency" 数组，可用 bench/compare.py 对比两次提交：
+ *  - 生产者开销（results）：控制任务未启动时反复调用 setSpeed 的单次耗时；
+ *    post.speed.idle 只有速度命令待执行，post.speed.backlog 另有移动与里程计清零命令待执行；
+ *  - 端到端延迟（latency）：虚拟时间下两个优先级 1 的生产者任务（模拟 USB 与 MQTT）交替以合计 500 Hz
+ *    调用 setSpeed，控制任务与总线任务照常运行，仿真总线接四个驱动器。每条命令的延迟为调用 setSpeed
+ *    到其后第一组速度命令帧（0xF6）开始发送的时间；被更新的命令覆盖而未单独执行的命令同样计入，
+ *    即“命令发出到总线上出现不旧于它的设定值”的时间。
+ *
+ * 虚拟时间下控制任务与总线任务的优先级都高于生产者，控制任务取出命令到总线写出速度帧之间生产者不会运行，
+ * 因此按写出时刻结算此前的全部命令是准确的。结果逐次相同，与主机负载无关。
+ *
+ * 运行（在 Universal_chassis 目录下）：
+ *   pio run -e native_command_bench && .pio/build/native_command_bench/program [标签] > flood.json
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+#include "StepperMotor/MotorDiscovery.h"
+#include "CarController/CarController.h"
+#include "KinematicsModel/KinematicsModel.h"
+#include "control/ControlManager.hpp"
+#include "utils/Logger.hpp"
+#include "config.h"
+#include "NativeSim.h"
+#include "EmulatedTransport.h"
+
+namespace {
+
+// ---------------- 生产者开销 ----------------
+
+constexpr uint64_t MIN_RUN_NS = 100000000;     // 单轮最短 0.1 s
+constexpr uint32_t MAX_ITERATIONS = 1u << 24;
+constexpr int RUNS = 5;
+
+struct Result {
+    const char* name;
+    uint32_t iterations;
+    double nsPerOp;         // 5 轮中位数
+    double minNsPerOp;      // 5 轮最小值
+};
+
+std::vector<Result> g_results;
+
+inline uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <typename Fn>
+uint64_t runOnce(uint32_t iterations, Fn& fn) {
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    return nowNs() - start;
+}
+
+template <typename Fn>
+void measure(const char* name, Fn fn) {
+    uint32_t iterations = 64;
+    while (iterations < MAX_ITERATIONS && runOnce(iterations, fn) < MIN_RUN_NS) {
+        iterations *= 2;
+    }
+    double perOp[RUNS];
+    for (int r = 0; r < RUNS; ++r) {
+        perOp[r] = static_cast<double>(runOnce(iterations, fn)) / iterations;
+    }
+    std::sort(perOp, perOp + RUNS);
+    g_results.push_back({name, iterations, perOp[RUNS / 2], perOp[0]});
+}
+
+// 控制任务未启动：命令只写入、不执行
+void benchProducer(ControlManager& manager) {
+    measure("post.speed.idle", [&](uint32_t i) {
+        manager.setSpeed(i & 1 ? 0.3f : 0.2f, 0.0f, 0.1f);
+    });
+
+    manager.moveDistance(0.2f, 0.0f, 0.0f);
+    manager.resetOdometer();
+    measure("post.speed.backlog", [&](uint32_t i) {
+        manager.setSpeed(i & 1 ? 0.3f : 0.2f, 0.0f, 0.1f);
+    });
+}
+
+// ---------------- 端到端延迟 ----------------
+
+constexpr uint32_t FLOOD_HZ = 500;
+constexpr uint32_t FLOOD_MS = 5000;
+constexpr size_t PRODUCERS = 2;
+
+// 仿真总线时钟：虚拟时间
+class VirtualClock : public Emm42Sim::SimClock {
+public:
+    uint64_t nowUs() override { return NativeSim::nowUs(); }
+    void sleepUntil(uint64_t us) override { NativeSim::sleepUntilUs(us); }
+};
+
+// 记录命令发出时刻，在速度命令帧写出时结算
+class FloodRecorder {
+public:
+    void arm() {
+        std::lock_guard<std::mutex> lock(mutex);
+        armed = true;
+    }
+
+    void posted(uint64_t us) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (armed) {
+            pending.push_back(us);
+            ++posts;
+        }
+    }
+
+    void speedFramesWritten(uint64_t us) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!armed || pending.empty()) {
+            return;
+        }
+        ++bursts;
+        for (uint64_t postUs : pending) {
+            latencies.push_back(static_cast<uint32_t>(us - postUs));
+        }
+        pending.clear();
+    }
+
+    std::mutex mutex;
+    bool armed = false;
+    std::vector<uint64_t> pending;
+    std::vector<uint32_t> latencies;
+    uint32_t posts = 0;
+    uint32_t bursts = 0;
+};
+
+FloodRecorder g_recorder;
+
+// 写出帧时检查功能码（帧格式：地址、功能码、…）
+class TapTransport : public Emm42Sim::EmulatedTransport {
+public:
+    using EmulatedTransport::EmulatedTransport;
+
+    bool writeFrames(const Emm42::ByteSpan* frames, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            if (frames[i].size > 1 && frames[i].data[1] == 0xF6) {
+                g_recorder.speedFramesWritten(NativeSim::nowUs());
+                break;
+            }
+        }
+        return EmulatedTransport::writeFrames(frames, count);
+    }
+};
+
+struct ProducerArgs {
+    uint64_t startUs;
+    uint32_t phaseUs;
+};
+
+// 每个生产者以 FLOOD_HZ / PRODUCERS 的频率发送，相位错开，合计 FLOOD_HZ
+void producerTask(void* param) {
+    const ProducerArgs* args = static_cast<const ProducerArgs*>(param);
+    const uint32_t periodUs = 1000000 / FLOOD_HZ * PRODUCERS;
+    ControlManager& manager = ControlManager::getInstance();
+    for (uint32_t k = 0;; ++k) {
+        NativeSim::sleepUntilUs(args->startUs + args->phaseUs + static_cast<uint64_t>(k) * periodUs);
+        g_recorder.posted(NativeSim::nowUs());
+        manager.setSpeed(0.1f + 0.05f * (k % 8), 0.0f, k & 1 ? 0.2f : -0.2f);
+    }
+}
+
+struct Latency {
+    const char* name;
+    uint32_t posts;
+    uint32_t bursts;
+    double avgUs;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+};
+
+Latency summarize(const char* name) {
+    std::lock_guard<std::mutex> lock(g_recorder.mutex);
+    Latency result = {name, g_recorder.posts, g_recorder.bursts, 0, 0, 0, 0};
+    std::vector<uint32_t>& samples = g_recorder.latencies;
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    uint64_t total = 0;
+    for (uint32_t s : samples) {
+        total += s;
+    }
+    result.avgUs = static_cast<double>(total) / samples.size();
+    result.p50Us = samples[samples.size() / 2];
+    result.p99Us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    result.maxUs = samples.back();
+    return result;
+}
+
+const char* platformName() {
+#if defined(__x86_64__)
+    return "host-x86_64";
+#elif defined(__aarch64__)
+    return "host-aarch64";
+#else
+    return "host";
+#endif
+}
+
+// 输出 JSON 报告：{"suite", "platform", "timer", "cpu_mhz", "label", "results": [...], "latency": [...]}
+void report(const char* label, const Latency& latency) {
+    printf("{\"suite\":\"command_flood\",\"platform\":\"%s\",\"timer\":\"steady_clock\",\"cpu_mhz\":0,"
+           "\"label\":\"%s\",\"results\":[\n", platformName(), label);
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const Result& r = g_results[i];
+        printf("  {\"name\":\"%s\",\"iterations\":%lu,\"ns_per_op\":%.3f,\"min_ns_per_op\":%.3f,\"cycles_per_op\":0.0}%s\n",
+               r.name, static_cast<unsigned long>(r.iterations), r.nsPerOp, r.minNsPerOp,
+               i + 1 < g_results.size() ? "," : "");
+    }
+    printf("],\"latency\":[\n");
+    printf("  {\"name\":\"%s\",\"posts\":%lu,\"bursts\":%lu,\"avg_us\":%.1f,\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu}\n",
+           latency.name, static_cast<unsigned long>(latency.posts), static_cast<unsigned long>(latency.bursts),
+           latency.avgUs, static_cast<unsigned long>(latency.p50Us), static_cast<unsigned long>(latency.p99Us),
+           static_cast<unsigned long>(latency.maxUs));
+    printf("]}\n");
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* label = argc > 1 ? argv[1] : "";
+    Serial.begin(115200);
+    // 日志与报告共用 stdout，只保留错误
+    Logger::init(LOG_LEVEL_ERROR);
+
+    static Emm42Sim::Emm42Bus simBus(MOTOR_BUS_BAUD);
+    static VirtualClock clock;
+    static TapTransport transport(simBus, clock);
+    for (uint8_t addr = 1; addr <= 4; ++addr) {
+        simBus.addDriver(addr);
+    }
+    static MotorBus motorBus(&transport);
+    static StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+    static StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+    static StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+    static StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+    static StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
+    static NormalWheelKinematics kinematics(0.09f, 0.45f, 6);
+    static CarController carController(&motor1, &motor2, &motor3, &motor4, &motor0, &kinematics);
+
+    ControlManager& manager = ControlManager::getInstance();
+    manager.init(&carController, false);
+    benchProducer(manager);
+
+    // 以下在虚拟时间下运行，启动流程与 main.cpp 相同：总线任务 → 探测 → 使能 → 周期预算 → 控制任务
+    NativeSim::beginVirtualTime("loopTask", 1, 0);
+    motorBus.begin();
+    MotorTable motorTable;
+    MotorBus* buses[] = {&motorBus};
+    MotorDiscovery discovery(buses, 1);
+    discovery.run(motorTable);
+    if (!carController.applyMotorTable(motorTable) || !carController.enableMotors(true)) {
+        fprintf(stderr, "motor bus setup failed\n");
+        return 1;
+    }
+    motorBus.setCycleBudget(MOTOR_BUS_CYCLE_US, MOTOR_BUS_SETPOINT_BUDGET_US,
+                            MOTOR_BUS_TELEMETRY_BUDGET_US, MOTOR_BUS_DIAGNOSTIC_BUDGET_US);
+    manager.stop();
+    manager.start();
+    delay(200);
+
+    const uint64_t startUs = NativeSim::nowUs() + 1000;
+    const uint32_t periodUs = 1000000 / FLOOD_HZ;
+    static ProducerArgs args[PRODUCERS];
+    static const char* const names[PRODUCERS] = {"usbFlood", "mqttFlood"};
+    g_recorder.arm();
+    for (size_t i = 0; i < PRODUCERS; ++i) {
+        args[i] = {startUs, static_cast<uint32_t>(i) * periodUs};
+        xTaskCreate(producerTask, names[i], 4096, &args[i], 1, NULL);
+    }
+    NativeSim::sleepUntilUs(startUs + static_cast<uint64_t>(FLOOD_MS) * 1000);
+
+    report(label, summarize("flood.500hz.set_speed"));
+    // 后台任务（总线、控制、生产者）不会退出，直接结束进程
+    _Exit(0);
+}
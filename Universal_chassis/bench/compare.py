@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+对比两次基准（hot_paths_bench、command_flood_bench）的 JSON 输出，列出每个用例的变化，超过阈值的变慢记为回归。
+
+用法：
+    python3 bench/compare.py base.json new.json [--threshold 10]
+
+输入文件可以是串口监视器的完整记录，脚本只取其中第一个 {"suite": ...} 报告。
+两份报告都带有周期数（目标板）时按 cycles_per_op 比较，否则按 ns_per_op 比较。
+报告带有 latency 数组（command_flood_bench）时，另按 p50_us / p99_us 比较端到端延迟。
+存在回归时退出码为 1。
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_report(path):
+    """读取报告：跳过报告之前的日志输出"""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    start = text.find('{"suite"')
+    if start < 0:
+        sys.exit(f"{path}: no benchmark report found")
+    report, _ = json.JSONDecoder().raw_decode(text[start:])
+    return report
+
+
+def compare_latency(base, new, threshold):
+    """比较端到端延迟（us），返回回归数"""
+    if "latency" not in base or "latency" not in new:
+        return 0
+    base_latency = {r["name"]: r for r in base["latency"]}
+    print(f"\n{'latency':<32} {'base':>10} {'new':>10} {'change':>8}   (us)")
+    regressions = 0
+    for r in new["latency"]:
+        old = base_latency.get(r["name"])
+        for key in ("p50_us", "p99_us"):
+            label = f"{r['name']}.{key[:-3]}"
+            if old is None:
+                print(f"{label:<32} {'-':>10} {r[key]:>10} {'new':>8}")
+                continue
+            change = (r[key] - old[key]) / old[key] * 100.0 if old[key] > 0 else 0.0
+            flag = ""
+            if change > threshold:
+                flag = "  REGRESSION"
+                regressions += 1
+            print(f"{label:<32} {old[key]:>10} {r[key]:>10} {change:>+7.1f}%{flag}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark reports")
+    parser.add_argument("base", help="基准报告（旧提交）")
+    parser.add_argument("new", help="新报告")
+    parser.add_argument("--threshold", type=float, default=10.0, help="判定回归的变慢百分比（默认 10）")
+    args = parser.parse_args()
+
+    base = load_report(args.base)
+    new = load_report(args.new)
+    if base.get("platform") != new.get("platform"):
+        print(f"warning: comparing {base.get('platform')} against {new.get('platform')}")
+
+    base_results = {r["name"]: r for r in base["results"]}
+    use_cycles = all(r.get("cycles_per_op", 0) > 0 for r in base["results"] + new["results"])
+    key = "cycles_per_op" if use_cycles else "ns_per_op"
+
+    print(f"{'case':<32} {'base':>10} {'new':>10} {'change':>8}   ({key})")
+    regressions = 0
+    for r in new["results"]:
+        name = r["name"]
+        if name not in base_results:
+            print(f"{name:<32} {'-':>10} {r[key]:>10.2f} {'new':>8}")
+            continue
+        old_value = base_results.pop(name)[key]
+        change = (r[key] - old_value) / old_value * 100.0 if old_value > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<32} {old_value:>10.2f} {r[key]:>10.2f} {change:>+7.1f}%{flag}")
+    for name, r in base_results.items():
+        print(f"{name:<32} {r[key]:>10.2f} {'-':>10} {'removed':>8}")
+
+    regressions += compare_latency(base, new, args.threshold)
+
+    if regressions:
+        print(f"\n{regressions} case(s) slower than {args.threshold:.0f}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,148 @@
+/*
+ * @Description: Emm42 帧编解码主机基准测试
+ *
+ * 对比旧版基于 std::vector 的实现（before）与 Emm42Frame.h 零堆分配实现（after）
+ * 在编码速度模式命令、解码实时转速应答时的单帧耗时（ns/frame）。
+ *
+ * 编译运行（在 Universal_chassis 目录下）：
+ *   g++ -O2 -std=gnu++17 -Iinclude bench/frame_codec_bench.cpp -o frame_codec_bench && ./frame_codec_bench
+ */
+
+#include "StepperMotor/Emm42Frame.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace legacy {
+
+// 旧版 StepperMotor::calculateChecksum（逐位 CRC-8）
+uint8_t calculateChecksum(ChecksumType type, const std::vector<uint8_t>& data) {
+    switch (type) {
+        case ChecksumType::FIXED:
+            return 0x6B;
+        case ChecksumType::XOR: {
+            uint8_t checksum = 0;
+            for (auto byte : data) checksum ^= byte;
+            return checksum;
+        }
+        case ChecksumType::CRC8: {
+            uint8_t crc = 0;
+            for (auto byte : data) {
+                crc ^= byte;
+                for (int i = 0; i < 8; ++i) {
+                    crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+                }
+            }
+            return crc;
+        }
+    }
+    return 0x6B;
+}
+
+// 旧版 setSpeedMode 的 payload + buildFrame
+std::vector<uint8_t> encodeSpeed(ChecksumType type, uint8_t addr, uint8_t dir, uint16_t rpm, uint8_t acc, bool sync) {
+    std::vector<uint8_t> payload;
+    payload.push_back(dir);
+    payload.push_back(static_cast<uint8_t>((rpm >> 8) & 0xFF));
+    payload.push_back(static_cast<uint8_t>(rpm & 0xFF));
+    payload.push_back(acc);
+    payload.push_back(sync ? 0x01 : 0x00);
+    std::vector<uint8_t> frame;
+    frame.push_back(addr);
+    frame.push_back(0xF6);
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.push_back(calculateChecksum(type, frame));
+    return frame;
+}
+
+// 旧版 sendCommand 的应答拷贝、校验 + readRealTimeSpeed 解析
+bool decodeSpeed(ChecksumType type, const uint8_t* rx, size_t n, uint8_t addr, int16_t& speed) {
+    std::vector<uint8_t> response;
+    for (size_t i = 0; i < n; ++i) response.push_back(rx[i]);
+    std::vector<uint8_t> dataWithoutChecksum(response.begin(), response.end() - 1);
+    if (calculateChecksum(type, dataWithoutChecksum) != response.back()) return false;
+    if (response.size() != 6 || response[0] != addr || response[1] != 0x35) return false;
+    uint16_t raw = (static_cast<uint16_t>(response[3]) << 8) | response[4];
+    speed = (response[2] == 0x01) ? -static_cast<int16_t>(raw) : static_cast<int16_t>(raw);
+    return true;
+}
+
+} // namespace legacy
+
+namespace current {
+
+bool decodeSpeed(ChecksumType type, const uint8_t* rx, size_t n, uint8_t addr, int16_t& speed) {
+    Emm42::Frame response;
+    if (!response.append(Emm42::ByteSpan(rx, n))) return false;
+    if (!Emm42::verifyChecksum(type, response.span())) return false;
+    if (response.size() != Emm42::responseLength(0x35) || response[0] != addr || response[1] != 0x35) return false;
+    speed = Emm42::readSigned16(&response.bytes[2]);
+    return true;
+}
+
+} // namespace current
+
+// 防止编译器优化掉被测代码
+static volatile uint32_t g_sink;
+
+template <typename Fn>
+static double nsPerIteration(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) fn(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+}
+
+static const char* checksumName(ChecksumType type) {
+    switch (type) {
+        case ChecksumType::XOR:  return "XOR";
+        case ChecksumType::CRC8: return "CRC8";
+        default:                 return "FIXED";
+    }
+}
+
+int main() {
+    const size_t iterations = 2000000;
+    const ChecksumType types[] = {ChecksumType::FIXED, ChecksumType::XOR, ChecksumType::CRC8};
+
+    std::printf("%-6s %-8s %12s %12s %8s\n", "check", "op", "before(ns)", "after(ns)", "speedup");
+    for (ChecksumType type : types) {
+        // 编码：速度模式命令
+        double before = nsPerIteration(iterations, [&](size_t i) {
+            auto f = legacy::encodeSpeed(type, 1 + (i & 3), i & 1, static_cast<uint16_t>(i), 10, false);
+            g_sink = g_sink + f.back();
+        });
+        double after = nsPerIteration(iterations, [&](size_t i) {
+            auto f = Emm42::encode<0xF6>(static_cast<uint8_t>(1 + (i & 3)), type, static_cast<uint8_t>(i & 1),
+                                         Emm42::U16{static_cast<uint16_t>(i)}, 10, 0x00);
+            g_sink = g_sink + f.bytes[f.size() - 1];
+        });
+        std::printf("%-6s %-8s %12.1f %12.1f %7.1fx\n", checksumName(type), "encode", before, after, before / after);
+
+        // 解码：实时转速应答
+        uint8_t rx[6] = {0x02, 0x35, 0x01, 0x05, 0xDC, 0x00};
+        rx[5] = Emm42::checksum(type, Emm42::ByteSpan(rx, 5));
+        before = nsPerIteration(iterations, [&](size_t) {
+            int16_t speed = 0;
+            legacy::decodeSpeed(type, rx, sizeof(rx), 0x02, speed);
+            g_sink = g_sink + static_cast<uint16_t>(speed);
+        });
+        after = nsPerIteration(iterations, [&](size_t) {
+            int16_t speed = 0;
+            current::decodeSpeed(type, rx, sizeof(rx), 0x02, speed);
+            g_sink = g_sink + static_cast<uint16_t>(speed);
+        });
+        std::printf("%-6s %-8s %12.1f %12.1f %7.1fx\n", checksumName(type), "decode", before, after, before / after);
+
+        // 一致性检查：新旧实现的编码结果必须逐字节相同
+        auto a = legacy::encodeSpeed(type, 3, 1, 1500, 20, true);
+        auto b = Emm42::encode<0xF6>(3, type, 1, Emm42::U16{1500}, 20, 0x01);
+        for (size_t i = 0; i < b.size(); ++i) {
+            if (a[i] != b.bytes[i]) {
+                std::printf("MISMATCH at byte %zu for %s\n", i, checksumName(type));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
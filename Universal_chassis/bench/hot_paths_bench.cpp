@@ -0,0 +1,365 @@
+/*
+ * @Description: 控制栈热点路径微基准（主机 + ESP32-S3）
+ *
+ * 测量以下路径的单次耗时，结果以 JSON 输出，便于用 bench/compare.py 对比两次提交：
+ *  - StepperMotor 命令帧构造（prepareSpeedMode / preparePositionMode）与应答解析
+ *    （verifyChecksum + parseRealTimeSpeed / parseSystemStatus），三种校验方式各一组；
+ *  - Emm42::checksum（XOR / CRC8，系统状态应答去掉校验字节后的 30 字节）；
+ *  - 运动学模型（NormalWheelKinematics）的 calculateSpeedCommands / calculatePositionCommands / calculateWheelSpeeds；
+ *  - ControlManager::integrateOdometer（updateOdometer 的积分步）；
+ *  - 状态快照的发布与读取（DoubleBuffer<CarState>，getCarState / getCarStateSnapshot 的实现）；
+ *  - USB / MQTT processCommand 的 JSON 命令解析与 publishStatus 的状态序列化（protocol/JsonCommands.hpp），
+ *    仅在能找到 ArduinoJson 时编译。
+ *
+ * 计时：主机使用 std::chrono::steady_clock（纳秒），ESP32 使用 CPU 周期计数器（ESP.getCycleCount），
+ * 同时给出 ns_per_op 与 cycles_per_op。每个用例先倍增迭代次数直到单轮不短于最小时长，
+ * 再重复 5 轮取中位数。
+ *
+ * 主机运行（在 Universal_chassis 目录下）：
+ *   pio run -e native_bench && .pio/build/native_bench/program [标签] > bench.json
+ * 目标板运行（结果经 USB 串口输出一次）：
+ *   pio run -e bench_esp32s3 -t upload && pio device monitor
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+#include "KinematicsModel/KinematicsModel.h"
+#include "control/ControlManager.hpp"
+
+#if __has_include(<ArduinoJson.h>)
+#include "protocol/JsonCommands.hpp"
+#define BENCH_HAS_JSON 1
+#else
+#define BENCH_HAS_JSON 0
+#endif
+
+#if defined(ESP_PLATFORM)
+#include <Esp.h>
+#else
+#include <chrono>
+#endif
+
+namespace {
+
+// 防止编译器优化掉被测代码
+volatile uint32_t g_sink;
+
+#if defined(ESP_PLATFORM)
+constexpr const char* TIMER_NAME = "ccount";
+constexpr uint32_t MIN_RUN_TICKS = 24000000;    // 单轮最短 0.1 s（240 MHz）
+inline uint32_t ticks() { return ESP.getCycleCount(); }
+#else
+constexpr const char* TIMER_NAME = "steady_clock";
+constexpr uint64_t MIN_RUN_TICKS = 100000000;   // 单轮最短 0.1 s（ns）
+inline uint64_t ticks() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+constexpr int RUNS = 5;
+constexpr size_t MAX_RESULTS = 64;
+constexpr uint32_t MAX_ITERATIONS = 1u << 26;
+
+struct Result {
+    char name[40];
+    uint32_t iterations;
+    double nsPerOp;         // 5 轮中位数
+    double minNsPerOp;      // 5 轮最小值
+    double cyclesPerOp;     // 目标板有效，主机为 0
+};
+
+Result g_results[MAX_RESULTS];
+size_t g_resultCount = 0;
+
+template <typename Fn>
+uint64_t runOnce(uint32_t iterations, Fn& fn) {
+    auto start = ticks();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    return static_cast<uint64_t>(static_cast<decltype(start)>(ticks() - start));
+}
+
+template <typename Fn>
+void measure(const char* name, Fn fn) {
+    uint32_t iterations = 64;
+    while (iterations < MAX_ITERATIONS && runOnce(iterations, fn) < MIN_RUN_TICKS) {
+        iterations *= 2;
+    }
+    double perOp[RUNS];
+    for (int r = 0; r < RUNS; ++r) {
+        perOp[r] = static_cast<double>(runOnce(iterations, fn)) / iterations;
+    }
+    std::sort(perOp, perOp + RUNS);
+
+    if (g_resultCount >= MAX_RESULTS) {
+        return;
+    }
+    Result& res = g_results[g_resultCount++];
+    snprintf(res.name, sizeof(res.name), "%s", name);
+    res.iterations = iterations;
+#if defined(ESP_PLATFORM)
+    const double mhz = ESP.getCpuFreqMHz();
+    res.cyclesPerOp = perOp[RUNS / 2];
+    res.nsPerOp = perOp[RUNS / 2] * 1000.0 / mhz;
+    res.minNsPerOp = perOp[0] * 1000.0 / mhz;
+#else
+    res.cyclesPerOp = 0;
+    res.nsPerOp = perOp[RUNS / 2];
+    res.minNsPerOp = perOp[0];
+#endif
+}
+
+const char* checksumName(ChecksumType type) {
+    switch (type) {
+        case ChecksumType::XOR:  return "xor";
+        case ChecksumType::CRC8: return "crc8";
+        default:                 return "fixed";
+    }
+}
+
+// 将应答帧写入事务并标记为成功完成（跳过总线，直接测量解析）
+void fillReply(BusTransaction& tx, const uint8_t* reply, size_t length, ChecksumType type) {
+    tx.response.clear();
+    tx.response.append(Emm42::ByteSpan(reply, length));
+    tx.response.bytes[length - 1] = Emm42::checksum(type, Emm42::ByteSpan(reply, length - 1));
+    tx.done.store(true);
+    tx.error = BusError::NONE;
+}
+
+void benchFrames() {
+    static MotorBus bus(static_cast<MotorTransport*>(nullptr));
+    const ChecksumType types[] = {ChecksumType::FIXED, ChecksumType::XOR, ChecksumType::CRC8};
+    char name[40];
+
+    for (ChecksumType type : types) {
+        StepperMotor motor(2, &bus, type);
+        BusTransaction tx;
+
+        snprintf(name, sizeof(name), "frame.build_speed.%s", checksumName(type));
+        measure(name, [&](uint32_t i) {
+            motor.prepareSpeedMode(tx, i & 1, static_cast<uint16_t>(i & 0x3FF), 10);
+            g_sink = g_sink + tx.request.bytes[tx.request.length - 1];
+        });
+
+        snprintf(name, sizeof(name), "frame.build_position.%s", checksumName(type));
+        measure(name, [&](uint32_t i) {
+            motor.preparePositionMode(tx, i & 1, 300, 10, i, false, true);
+            g_sink = g_sink + tx.request.bytes[tx.request.length - 1];
+        });
+
+        // 实时转速应答：02 35 01 05 DC cs
+        const uint8_t speedReply[] = {0x02, 0x35, 0x01, 0x05, 0xDC, 0x00};
+        motor.prepareReadRealTimeSpeed(tx);
+        fillReply(tx, speedReply, sizeof(speedReply), type);
+        snprintf(name, sizeof(name), "frame.parse_speed.%s", checksumName(type));
+        measure(name, [&](uint32_t) {
+            int16_t speed = 0;
+            if (Emm42::verifyChecksum(type, tx.response.span()) && motor.parseRealTimeSpeed(tx, speed)) {
+                g_sink = g_sink + static_cast<uint16_t>(speed);
+            }
+        });
+
+        // 系统状态应答（31 字节）
+        const uint8_t statusReply[31] = {0x02, 0x43, 0x1F, 0x09, 0x5D, 0xC0, 0x01, 0x2C, 0x40, 0x00,
+                                         0x00, 0x00, 0x01, 0x86, 0xA0, 0x00, 0x05, 0xDC, 0x00, 0x00,
+                                         0x01, 0x86, 0x9F, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03};
+        motor.prepareReadSystemStatus(tx);
+        fillReply(tx, statusReply, sizeof(statusReply), type);
+        snprintf(name, sizeof(name), "frame.parse_status.%s", checksumName(type));
+        measure(name, [&](uint32_t) {
+            SystemStatus status;
+            if (Emm42::verifyChecksum(type, tx.response.span()) && motor.parseSystemStatus(tx, status)) {
+                g_sink = g_sink + static_cast<uint32_t>(status.realTimePosition);
+            }
+        });
+
+        if (type != ChecksumType::FIXED) {
+            snprintf(name, sizeof(name), "checksum.%s.30B", checksumName(type));
+            measure(name, [&](uint32_t i) {
+                tx.response.bytes[4] = static_cast<uint8_t>(i);
+                g_sink = g_sink + Emm42::checksum(type, Emm42::ByteSpan(tx.response.bytes, 30));
+            });
+        }
+    }
+}
+
+void benchKinematics(const char* model, KinematicsModel& kinematics) {
+    char name[40];
+    std::array<uint16_t, 4> speeds;
+    std::array<int32_t, 4> pulses;
+    std::array<int16_t, 4> wheels = {120, -118, 121, -119};
+
+    snprintf(name, sizeof(name), "kinematics.%s.speed", model);
+    measure(name, [&](uint32_t i) {
+        const float k = static_cast<float>(i & 0xFF) * 0.002f;
+        kinematics.calculateSpeedCommands(0.3f + k, 0.1f - k, 0.2f + k, speeds);
+        g_sink = g_sink + speeds[0] + speeds[3];
+    });
+
+    snprintf(name, sizeof(name), "kinematics.%s.position", model);
+    measure(name, [&](uint32_t i) {
+        const float k = static_cast<float>(i & 0xFF) * 0.002f;
+        kinematics.calculatePositionCommands(1.0f + k, 0.5f - k, 0.3f + k, pulses, 256);
+        g_sink = g_sink + static_cast<uint32_t>(pulses[0] + pulses[3]);
+    });
+
+    snprintf(name, sizeof(name), "kinematics.%s.forward", model);
+    measure(name, [&](uint32_t i) {
+        wheels[0] = static_cast<int16_t>(100 + (i & 0x3F));
+        float vx, vy, omega;
+        kinematics.calculateWheelSpeeds(wheels, vx, vy, omega);
+        g_sink = g_sink + static_cast<uint32_t>((vx + vy + omega) * 1000.0f);
+    });
+}
+
+void benchOdometer() {
+    Odometer odom = {};
+    CarState state = {};
+    measure("odometer.integrate", [&](uint32_t i) {
+        state.vx = 0.3f + static_cast<float>(i & 0x0F) * 0.01f;
+        state.omega = 0.5f;
+        ControlManager::integrateOdometer(odom, state, 0.01f);
+        g_sink = g_sink + static_cast<uint32_t>(odom.x * 1000.0f);
+    });
+}
+
+// 控制任务发布状态快照、读取任务取最新快照（ControlManager 的 stateBuffer，无并发写入）
+void benchSnapshot() {
+    static DoubleBuffer<CarState> buffer;
+    CarState state = {};
+    state.wheelSpeeds = {120, -118, 121, -119};
+    measure("snapshot.publish_state", [&](uint32_t i) {
+        state.wheelSpeeds[0] = static_cast<int16_t>(i & 0x3FF);
+        buffer.publish(state, i);
+    });
+    measure("snapshot.read_state", [&](uint32_t) {
+        CarStateSnapshot snapshot = buffer.read();
+        g_sink = g_sink + snapshot.sequence + static_cast<uint32_t>(snapshot.value.wheelSpeeds[0]);
+    });
+}
+
+#if BENCH_HAS_JSON
+// 与 UsbControl / MqttControl::processCommand 相同的解析步骤：反序列化 → 取 command → 读取参数
+void benchJson() {
+    static const char speedCommand[] =
+        "{\"command\":\"speed\",\"vx\":0.5,\"vy\":0.0,\"omega\":0.1,\"acceleration\":10.0,\"subdivision\":256}";
+    static const char moveCommand[] =
+        "{\"command\":\"move\",\"dx\":1.0,\"dy\":0.0,\"dtheta\":0.0,\"speed\":0.5}";
+
+    measure("json.parse_speed", [&](uint32_t) {
+        JsonDocument doc;
+        if (deserializeJson(doc, speedCommand, sizeof(speedCommand) - 1)) return;
+        const char* command = doc["command"];
+        if (command && strcmp(command, "speed") == 0) {
+            JsonCommands::SpeedArgs a = JsonCommands::readSpeedArgs(doc);
+            g_sink = g_sink + a.subdivision;
+        }
+    });
+
+    measure("json.parse_move", [&](uint32_t) {
+        JsonDocument doc;
+        if (deserializeJson(doc, moveCommand, sizeof(moveCommand) - 1)) return;
+        const char* command = doc["command"];
+        if (command && strcmp(command, "move") == 0) {
+            JsonCommands::MoveArgs a = JsonCommands::readMoveArgs(doc);
+            g_sink = g_sink + a.subdivision;
+        }
+    });
+
+    CarState state = {};
+    state.vx = 0.42f;
+    state.omega = -0.13f;
+    state.wheelSpeeds = {120, -118, 121, -119};
+    state.wheelHealth = {MotorHealth::HEALTHY, MotorHealth::HEALTHY, MotorHealth::HEALTHY, MotorHealth::HEALTHY};
+    measure("json.serialize_status", [&](uint32_t i) {
+        state.wheelSpeeds[0] = static_cast<int16_t>(i & 0x3FF);
+        JsonDocument doc;
+        JsonCommands::writeStatus(doc, state, i, i * 10000u);
+        char buffer[256];
+        g_sink = g_sink + static_cast<uint32_t>(serializeJson(doc, buffer));
+    });
+}
+#endif
+
+void runAll() {
+    g_resultCount = 0;
+    benchFrames();
+
+    // MecanumKinematics / OmnidirectionalKinematics 尚未实现 calculateWheelSpeeds（抽象类），暂不测量
+    NormalWheelKinematics normal(0.09f, 0.45f, 6);
+    benchKinematics("normal", normal);
+
+    benchOdometer();
+    benchSnapshot();
+#if BENCH_HAS_JSON
+    benchJson();
+#endif
+}
+
+const char* platformName() {
+#if defined(ESP_PLATFORM)
+    return "esp32s3";
+#elif defined(__x86_64__)
+    return "host-x86_64";
+#elif defined(__aarch64__)
+    return "host-aarch64";
+#else
+    return "host";
+#endif
+}
+
+// 输出 JSON 报告：{"suite", "platform", "timer", "cpu_mhz", "label", "results": [...]}
+template <typename Out>
+void report(Out out, const char* label) {
+    char line[256];
+#if defined(ESP_PLATFORM)
+    const unsigned cpuMhz = ESP.getCpuFreqMHz();
+#else
+    const unsigned cpuMhz = 0;
+#endif
+    snprintf(line, sizeof(line),
+             "{\"suite\":\"hot_paths\",\"platform\":\"%s\",\"timer\":\"%s\",\"cpu_mhz\":%u,\"label\":\"%s\",\"results\":[\n",
+             platformName(), TIMER_NAME, cpuMhz, label);
+    out(line);
+    for (size_t i = 0; i < g_resultCount; ++i) {
+        const Result& r = g_results[i];
+        snprintf(line, sizeof(line),
+                 "  {\"name\":\"%.39s\",\"iterations\":%lu,\"ns_per_op\":%.3f,\"min_ns_per_op\":%.3f,\"cycles_per_op\":%.1f}%s\n",
+                 r.name, static_cast<unsigned long>(r.iterations), r.nsPerOp, r.minNsPerOp, r.cyclesPerOp,
+                 i + 1 < g_resultCount ? "," : "");
+        out(line);
+    }
+    out("]}\n");
+}
+
+} // namespace
+
+#if defined(ESP_PLATFORM)
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);    // 等待 USB 串口枚举
+    runAll();
+    report([](const char* s) { Serial.print(s); }, "");
+}
+
+void loop() {
+    delay(1000);
+}
+
+#else
+
+int main(int argc, char** argv) {
+    runAll();
+    report([](const char* s) { fputs(s, stdout); }, argc > 1 ? argv[1] : "");
+    return 0;
+}
+
+#endif
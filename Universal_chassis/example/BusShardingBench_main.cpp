@@ -0,0 +1,164 @@
+/*
+ * @Description: 多串口总线分片（bus sharding）性能对比示例
+ *
+ * 对比一个完整控制周期（四轮速度设定 + 同步触发 + 四轮系统状态读取）的耗时：
+ *  - 1-bus：两条总线上的事务依次执行（一条总线完成后再开始另一条），等价于四轮共用一个串口
+ *  - 2-bus：两条总线上的事务同时提交、并行执行，最后统一等待
+ *
+ * 接线：右侧两轮（电机 1、2）接 UART1，左侧两轮（电机 3、4）接 UART2，引脚见 pins.h（与 main.cpp 的双总线接线一致）；
+ * 广播同步触发帧由地址 1 的驱动器应答，左侧总线没有应答者，其广播命令不等待应答。
+ *
+ * 注意：测试时请将车轮架空。
+ */
+
+#include <Arduino.h>
+#include <array>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+#include "config.h"
+#include "pins.h"
+
+HardwareSerial Serial01(1);
+HardwareSerial Serial02(2);
+MotorBus busRight(&Serial01);
+MotorBus busLeft(&Serial02);
+
+StepperMotor motor0Right(0, &busRight, ChecksumType::FIXED);
+StepperMotor motor0Left(0, &busLeft, ChecksumType::FIXED);
+StepperMotor motor1(1, &busRight, ChecksumType::FIXED);
+StepperMotor motor2(2, &busRight, ChecksumType::FIXED);
+StepperMotor motor3(3, &busLeft, ChecksumType::FIXED);
+StepperMotor motor4(4, &busLeft, ChecksumType::FIXED);
+
+// 单条总线上的一组电机：广播电机 + 两个车轮
+struct BusGroup {
+    StepperMotor* broadcaster;
+    std::array<StepperMotor*, 2> wheels;
+
+    // 本周期使用的事务
+    std::array<BusTransaction, 2> speedTxs;
+    BusTransaction syncTx;
+    std::array<BusTransaction, 2> statusTxs;
+};
+
+static BusGroup groups[2] = {
+    {&motor0Right, {&motor1, &motor2}, {}, {}, {}},
+    {&motor0Left, {&motor3, &motor4}, {}, {}, {}},
+};
+
+static const uint16_t TEST_RPM = 60;
+static const int CYCLES = 200;
+
+// 提交速度设定突发（含同步触发帧）
+static bool submitSetpoints(BusGroup& g) {
+    BusTransaction* burst[2];
+    for (size_t i = 0; i < g.wheels.size(); ++i) {
+        g.wheels[i]->prepareSpeedMode(g.speedTxs[i], 0, TEST_RPM, 0, true);
+        burst[i] = &g.speedTxs[i];
+    }
+    return g.broadcaster->submitSyncBurst(burst, g.wheels.size(), g.syncTx);
+}
+
+// 提交系统状态读取
+static void submitStatusReads(BusGroup& g) {
+    for (size_t i = 0; i < g.wheels.size(); ++i) {
+        g.wheels[i]->prepareReadSystemStatus(g.statusTxs[i]);
+        g.wheels[i]->bus()->submit(g.statusTxs[i]);
+    }
+}
+
+// 等待速度设定事务完成
+static bool awaitSetpoints(BusGroup& g) {
+    bool ok = true;
+    for (size_t i = 0; i < g.wheels.size(); ++i) {
+        g.wheels[i]->bus()->wait(g.speedTxs[i]);
+        ok &= g.wheels[i]->checkAck(g.speedTxs[i]);
+    }
+    g.broadcaster->bus()->wait(g.syncTx);
+    return ok && g.broadcaster->checkAck(g.syncTx);
+}
+
+// 等待状态读取事务完成
+static bool awaitStatusReads(BusGroup& g) {
+    bool ok = true;
+    for (size_t i = 0; i < g.wheels.size(); ++i) {
+        g.wheels[i]->bus()->wait(g.statusTxs[i]);
+        SystemStatus status;
+        ok &= g.wheels[i]->parseSystemStatus(g.statusTxs[i], status);
+    }
+    return ok;
+}
+
+// 1-bus：两组事务依次执行
+static bool cycleSequential() {
+    bool ok = true;
+    for (auto& g : groups) {
+        ok &= submitSetpoints(g) && awaitSetpoints(g);
+    }
+    for (auto& g : groups) {
+        submitStatusReads(g);
+        ok &= awaitStatusReads(g);
+    }
+    return ok;
+}
+
+// 2-bus：两组事务同时提交，并行执行
+static bool cycleParallel() {
+    bool ok = true;
+    for (auto& g : groups) {
+        ok &= submitSetpoints(g);
+    }
+    for (auto& g : groups) {
+        ok &= awaitSetpoints(g);
+    }
+    for (auto& g : groups) {
+        submitStatusReads(g);
+    }
+    for (auto& g : groups) {
+        ok &= awaitStatusReads(g);
+    }
+    return ok;
+}
+
+static void runMode(const char* name, bool (*cycle)()) {
+    uint32_t sum = 0, worst = 0;
+    int failed = 0;
+    for (int c = 0; c < CYCLES; ++c) {
+        uint32_t start = micros();
+        if (!cycle()) {
+            ++failed;
+        }
+        uint32_t elapsed = micros() - start;
+        sum += elapsed;
+        worst = elapsed > worst ? elapsed : worst;
+        delay(5);
+    }
+    Serial.printf("%s: mean %lu us, max %lu us, failed %d/%d\n",
+                  name, static_cast<unsigned long>(sum / CYCLES),
+                  static_cast<unsigned long>(worst), failed, CYCLES);
+}
+
+void setup() {
+    Serial01.begin(MOTOR_BUS_BAUD, SERIAL_8N1, MOTOR_UART_RIGHT_RX, MOTOR_UART_RIGHT_TX);
+    Serial02.begin(MOTOR_BUS_BAUD, SERIAL_8N1, MOTOR_UART_LEFT_RX, MOTOR_UART_LEFT_TX);
+    Serial.begin(115200);
+    delay(1000);
+    busRight.begin();
+    busLeft.begin();
+    // 左侧总线只有电机 3、4，广播命令无人应答
+    motor0Left.setBroadcastReplies(false);
+
+    motor0Right.enableMotor(true, false);
+    motor0Left.enableMotor(true, false);
+    delay(500);
+
+    runMode("1-bus", cycleSequential);
+    runMode("2-bus", cycleParallel);
+
+    motor0Right.stopMotor(false);
+    motor0Left.stopMotor(false);
+}
+
+void loop() {
+    delay(1000);
+}
@@ -6,6 +6,7 @@
 
 #include <Arduino.h>
 #include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
 #include "CarController/CarController.h"
 #include "KinematicsModel/KinematicsModel.h"
 #include <vector>
@@ -14,13 +15,14 @@
 
 // 初始化 ESP32 硬件串口（示例使用 Serial00）
 HardwareSerial Serial00(0);
+MotorBus motorBus(&Serial00);
 
 // 创建步进电机实例，分别对应小车的四个轮（编号1~4）
-StepperMotor motor0(0, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor1(1, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor2(2, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor3(3, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor4(4, &Serial00, ChecksumType::FIXED, 1000);
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
 
 // 创建普通轮运动学模型实例：参数为轮子半径 0.1m 和左右轮距 0.3m
 NormalWheelKinematics normalKinematics(0.08f, 0.6f);
@@ -31,6 +33,7 @@ CarController carController(&motor1, &motor2, &motor3, &motor4, &motor0, &normal
 void setup() {
     
     Serial00.begin(115200, SERIAL_8N1, RX, TX);
+    carController.enableMotors(true);   // 串口打开后再使能电机
     
     Serial.begin(115200);
     //一直循环直到Serial 初始化成功
@@ -49,25 +52,25 @@ void loop() {
 
 
 
-    bool output = motor1.modifySubdivision(0, true);
+    BusResult output = motor1.modifySubdivision(0, true);
     Serial.print("motor1 subdivision: ");
-    Serial.println(output);
+    Serial.println(busErrorName(output.error));
 
     output = motor2.modifySubdivision(0, true);
     Serial.print("motor2 subdivision: ");
-    Serial.println(output);
+    Serial.println(busErrorName(output.error));
 
     output = motor3.modifySubdivision(0, true);
     Serial.print("motor3 subdivision: ");
-    Serial.println(output);
+    Serial.println(busErrorName(output.error));
      
     output = motor4.modifySubdivision(0, true);
     Serial.print("motor4 subdivision: ");
-    Serial.println(output);
+    Serial.println(busErrorName(output.error));
 
    
 
-    bool result = false;
+    BusResult result;
 
     // --------------------------
     // CarController 速度模式示例
@@ -75,7 +78,7 @@ void loop() {
 
     // result = carController.setSpeed(1, 0, 0, 5000);
     // Serial.print("speed mode result: ");
-    // Serial.println(result ? "success" : "failure");
+    // Serial.println(result ? "success" : busErrorName(result.error));
 
     // --------------------------
     // CarController 位置模式示例
@@ -83,7 +86,7 @@ void loop() {
     // 控制小车前进 1.0 m（位置模式下，旋转角度为 0）
     result = carController.moveDistance(0.56, 0, 0);
     Serial.print("position mode result: ");
-    Serial.println(result ? "success" : "failure");
+    Serial.println(result ? "success" : busErrorName(result.error));
 
     // // 获取当前小车状态
     // CarState state = carController.getCarState();
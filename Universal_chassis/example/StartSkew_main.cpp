@@ -0,0 +1,145 @@
+/*
+ * @Description: 四轮启动时间差（start skew）测量示例
+ *
+ * 对比两种下发方式下四个车轮实际开始转动的时间差：
+ *  - before：逐个下发 sync = false 的速度命令并等待应答，再发送同步触发（原 CarController 行为）
+ *  - after ：四个 sync = true 的速度命令与广播同步触发帧在一次串口写入中发出（submitSyncBurst）
+ *
+ * 测量方法：加速度档位为 0（直接启动），运行固定时间后读取各轮实时位置（0x36，一圈 65536），
+ * 由 "读取时刻 - 已转过位置 / 转速" 反推每个车轮的启动时刻，启动时刻的极差即为启动时间差。
+ * 读取时刻取每次读取事务的发送与完成的中点，消除逐个读取带来的偏差。
+ *
+ * 注意：测试时请将车轮架空。
+ */
+
+#include <Arduino.h>
+#include <array>
+#include <cstdlib>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+
+HardwareSerial Serial00(0);
+MotorBus motorBus(&Serial00);
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
+
+static std::array<StepperMotor*, 4> wheels = {&motor1, &motor2, &motor3, &motor4};
+
+static const uint16_t TEST_RPM = 60;          // 60 RPM：每微秒约 1.09 个位置单位
+static const uint32_t RUN_TIME_MS = 300;      // 启动后运行时间
+static const int TRIALS = 10;                 // 每种方式的测试次数
+
+// 读取四个车轮的实时位置及对应的读取时刻（微秒）
+static bool readPositions(std::array<int32_t, 4>& positions, std::array<uint32_t, 4>& stampsUs) {
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        uint32_t before = micros();
+        if (!wheels[i]->readRealTimePosition(positions[i])) {
+            return false;
+        }
+        stampsUs[i] = before + (micros() - before) / 2;
+    }
+    return true;
+}
+
+// 原方式：逐个下发并等待应答，最后触发同步
+static bool startSequential() {
+    bool ok = true;
+    for (auto wheel : wheels) {
+        ok &= wheel->setSpeedMode(0, TEST_RPM, 0, false).ok();
+    }
+    ok &= motor0.syncMove().ok();
+    return ok;
+}
+
+// 新方式：一次写入下发全部命令与广播同步触发帧
+static bool startBurst() {
+    std::array<BusTransaction, 4> txs;
+    BusTransaction* burst[4];
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        wheels[i]->prepareSpeedMode(txs[i], 0, TEST_RPM, 0, true);
+        burst[i] = &txs[i];
+    }
+    BusTransaction syncTx;
+    if (!motor0.submitSyncBurst(burst, txs.size(), syncTx)) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        motorBus.wait(txs[i]);
+        ok &= wheels[i]->checkAck(txs[i]);
+    }
+    motorBus.wait(syncTx);
+    ok &= motor0.checkAck(syncTx);
+    return ok;
+}
+
+// 执行一次测量，返回启动时间差（微秒），失败返回负值
+static int32_t measureSkew(bool (*start)()) {
+    motor0.stopMotor(false);
+    delay(500);
+
+    std::array<int32_t, 4> startPos, endPos;
+    std::array<uint32_t, 4> startStamp, endStamp;
+    if (!readPositions(startPos, startStamp)) {
+        return -1;
+    }
+    if (!start()) {
+        return -1;
+    }
+    delay(RUN_TIME_MS);
+    if (!readPositions(endPos, endStamp)) {
+        return -1;
+    }
+    motor0.stopMotor(false);
+
+    // 位置单位/微秒
+    const float unitsPerUs = TEST_RPM * 65536.0f / 60.0f / 1e6f;
+    float earliest = 0, latest = 0;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        float travelled = static_cast<float>(std::abs(endPos[i] - startPos[i]));
+        float startUs = static_cast<float>(endStamp[i] - endStamp[0]) - travelled / unitsPerUs;
+        if (i == 0 || startUs < earliest) earliest = startUs;
+        if (i == 0 || startUs > latest) latest = startUs;
+    }
+    return static_cast<int32_t>(latest - earliest);
+}
+
+static void runMode(const char* name, bool (*start)()) {
+    int32_t sum = 0, worst = 0;
+    int valid = 0;
+    for (int t = 0; t < TRIALS; ++t) {
+        int32_t skew = measureSkew(start);
+        if (skew < 0) {
+            Serial.printf("%s trial %d: failed\n", name, t);
+            continue;
+        }
+        Serial.printf("%s trial %d: skew %ld us\n", name, t, static_cast<long>(skew));
+        sum += skew;
+        worst = skew > worst ? skew : worst;
+        ++valid;
+    }
+    if (valid > 0) {
+        Serial.printf("%s: mean %ld us, max %ld us (%d trials)\n",
+                      name, static_cast<long>(sum / valid), static_cast<long>(worst), valid);
+    }
+}
+
+void setup() {
+    Serial00.begin(115200, SERIAL_8N1, RX, TX);
+    Serial.begin(115200);
+    delay(1000);
+    motorBus.begin();
+
+    motor0.enableMotor(true, false);
+    delay(500);
+
+    runMode("before", startSequential);
+    runMode("after", startBurst);
+}
+
+void loop() {
+    delay(1000);
+}
@@ -13,16 +13,18 @@
 
 #include <Arduino.h>
 #include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
 #include <vector>
 
 // 创建一个 StepperMotor 实例，电机地址默认 1，使用 Serial 端口，校验方式为 FIXED，超时 1000 毫秒
 // StepperMotor motor(1, &Serial, ChecksumType::FIXED, 1000); 
 HardwareSerial Serial00(0);
-StepperMotor motor0(0, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor1(1, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor2(2, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor3(3, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor4(4, &Serial00, ChecksumType::FIXED, 1000);
+MotorBus motorBus(&Serial00);
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
 
 void setup() {
     Serial00.begin(115200, SERIAL_8N1, RX, TX);
@@ -35,41 +37,41 @@ void setup() {
     delay(1000);
 
 
-    bool result;
+    BusResult result;
 
     //使能所有电机
     Serial.println("Calling enableMotor(true, false)");
     result = motor0.enableMotor(true, false);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
     delay(3000);
 
     //电机1,2顺时针，电机3,4逆时针。
     Serial.println("Calling setSpeedMode(0, 1000, 100, true)");
     result = motor1.setSpeedMode(0, 2000, 100, true);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
 
     Serial.println("Calling setSpeedMode(1, 1000, 100, true)");
     result = motor2.setSpeedMode(0, 2000, 100, true);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
 
     Serial.println("Calling setSpeedMode(2, 1000, 100, true)");
     result = motor3.setSpeedMode(1, 2000, 100, true);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
 
     Serial.println("Calling setSpeedMode(3, 1000, 100, true)");
     result = motor4.setSpeedMode(1, 2000, 100, true);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
     
     //同步运动
     Serial.println("Calling syncMove()");
     result = motor0.syncMove();
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
 
     //持续运动12s
     delay(3000);
@@ -85,7 +87,7 @@ void setup() {
     // //立即停止
     result = motor0.stopMotor(false);
     Serial.print("Result: ");
-    Serial.println(result ? "Success" : "Failure");
+    Serial.println(result ? "Success" : busErrorName(result.error));
     delay(3000);
 
 
@@ -93,7 +95,7 @@ void setup() {
     // Serial.println("Calling modifySubdivision(256, true)");
     // result = motor0.modifySubdivision(256, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 }
 
@@ -103,55 +105,55 @@ void loop() {
     // Serial.println("Calling enableMotor(true, false)");
     // result = motor.enableMotor(true, false);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling setSpeedMode(CCW, 1500, 8, false)");
     // result = motor.setSpeedMode(1, 1500, 8, false); // 1 表示 CCW
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling setPositionMode(CW, 1200, 5, 32000, true, false)");
     // result = motor.setPositionMode(0, 1200, 5, 32000, true, false); // 0 表示 CW，绝对模式 true
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling stopMotor(false)");
     // result = motor.stopMotor(false);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling syncMove()");
     // result = motor.syncMove();
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling modifySubdivision(7, true)");
     // result = motor.modifySubdivision(7, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling modifyMotorID(16, true)");
     // result = motor.modifyMotorID(16, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling switchControlMode(1, true) // 0x01=open loop");
     // result = motor.switchControlMode(0x01, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling modifyOpenLoopCurrent(1000, false)");
     // result = motor.modifyOpenLoopCurrent(1000, false);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // // 示例：构造一组虚拟的驱动配置参数数据
@@ -159,25 +161,25 @@ void loop() {
     // Serial.println("Calling modifyDriverConfig(dummyConfig, true)");
     // result = motor.modifyDriverConfig(dummyConfig, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling modifyPIDParameters(62000, 100, 62000, false)");
     // result = motor.modifyPIDParameters(62000, 100, 62000, false);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling storeSpeedModeParameters(CCW, 1500, 10, true, true)");
     // result = motor.storeSpeedModeParameters(1, 1500, 10, true, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling modifyInputSpeedScaling(true, true)");
     // result = motor.modifyInputSpeedScaling(true, true);
     // Serial.print("Result: ");
-    // Serial.println(result ? "Success" : "Failure");
+    // Serial.println(result ? "Success" : busErrorName(result.error));
     // delay(3000);
 
     // Serial.println("Calling readFirmwareVersion()");
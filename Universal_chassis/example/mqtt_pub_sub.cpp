@@ -6,6 +6,7 @@
 
 #include <Arduino.h>
 #include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
 #include "CarController/CarController.h"
 #include "KinematicsModel/KinematicsModel.h"
 #include "freertos/FreeRTOS.h"
@@ -14,13 +15,14 @@
 
 // 初始化 ESP32 硬件串口（示例使用 Serial00）
 HardwareSerial Serial00(0);
+MotorBus motorBus(&Serial00);
 
 // 创建主控板及四个轮的步进电机实例
-StepperMotor motor0(0, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor1(1, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor2(2, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor3(3, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor4(4, &Serial00, ChecksumType::FIXED, 1000);
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
 
 // 创建普通轮运动学模型实例：例子中轮子半径为 0.08m, 轮距 0.6m
 NormalWheelKinematics normalKinematics(0.08f, 0.6f);
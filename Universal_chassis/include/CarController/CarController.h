@@ -8,9 +8,24 @@
 #pragma once
 
 #include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorDiscovery.h"
 #include "KinematicsModel/KinematicsModel.h"
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <initializer_list>
+
+/**
+ * @brief 四轮遥测快照
+ *
+ * 每个车轮由一次读取系统状态参数（0x43）事务得到，包含电压、相电流、编码器、
+ * 目标/实时位置、转速、位置误差与状态标志。
+ */
+struct TelemetrySnapshot {
+    std::array<SystemStatus, 4> wheels{};   // 各轮系统状态（轮序同 wheelSpeeds）
+    std::array<bool, 4> valid{};            // 对应车轮本次读取是否成功
+    uint32_t timestampMs = 0;               // 采集完成时刻（millis）
+};
 
 /**
  * @brief 小车状态结构体
@@ -22,6 +37,8 @@ struct CarState {
     float vy;      // 线速度 Y (m/s)
     float omega;   // 角速度 (rad/s)
     std::array<int16_t, 4> wheelSpeeds;   // 四个轮子的当前速度反馈信息
+    std::array<MotorHealth, 4> wheelHealth; // 四个轮子驱动器的通讯健康状态
+    TelemetrySnapshot telemetry;          // 四轮完整遥测（与 wheelSpeeds 同一次读取）
 };
 
 /**
@@ -29,6 +46,18 @@ struct CarState {
  *
  * 用于一次性设置默认的加速度、细分数等参数
  */
+// 紧急停止统计（自启动起累计）
+struct EStopStats {
+    uint32_t count = 0;             // 紧急停止次数
+    uint32_t lastUs = 0;            // 最近一次延迟：从收到命令到停止帧发送完成（多总线取最晚者）
+    uint32_t maxUs = 0;             // 最大延迟
+    uint32_t avgUs = 0;             // 平均延迟
+    uint32_t overTarget = 0;        // 延迟超过 CarController::ESTOP_TARGET_US 的次数
+    uint32_t unconfirmed = 0;       // 回读转速未能确认全部车轮停止的次数
+    uint8_t lastAttempts = 0;       // 最近一次广播停止的次数
+    uint8_t lastMovingMask = 0;     // 最近一次未确认停止的车轮（位 i 对应轮序 i）
+};
+
 struct CarControllerConfig {
     float defaultAcceleration;  ///< 默认加速度（单位由具体实现决定），例如 10.0
     float defaultSubdivision;   ///< 默认细分数，例如 16（16细分下3200脉冲为一圈）
@@ -57,11 +86,27 @@ public:
      * @param motorLF 左前轮步进电机驱动对象
      * @param motor0 主控板步进电机驱动对象--用于控制所有电机
      * @param kinematicsModel 指向运动学模型对象（多态实现：支持不同轮型）
+     * @note 构造函数不访问总线，电机使能见 enableMotors()
      */
     CarController(StepperMotor* motorRF, StepperMotor* motorRR,
                   StepperMotor* motorLR, StepperMotor* motorLF, StepperMotor* motor0,
                   KinematicsModel* kinematicsModel);
 
+    /**
+     * @brief 多总线构造函数
+     *
+     * 车轮电机可分布在多个串口上（每个串口一个 MotorBus 及总线任务），不同总线上的事务并行执行。
+     * 每条总线需提供一个地址为 0 的广播电机，用于该总线上的同步触发与停止命令。
+     * @param broadcastMotors 各总线的广播电机，最多 MAX_BUSES 个
+     */
+    CarController(StepperMotor* motorRF, StepperMotor* motorRR,
+                  StepperMotor* motorLR, StepperMotor* motorLF,
+                  std::initializer_list<StepperMotor*> broadcastMotors,
+                  KinematicsModel* kinematicsModel);
+
+    // 最多支持的电机总线数（ESP32-S3 共 3 个 UART）
+    static constexpr size_t MAX_BUSES = 3;
+
 
     /**
      * @brief 通过速度模式控制小车运动
@@ -73,10 +118,10 @@ public:
      * @param vy Y方向线速度 (m/s)
      * @param omega 旋转角速度 (rad/s)
      * @param acceleration 加速度 (默认值 10.0)
-     * @return true 成功下发命令至所有电机
-     * @return false 至少一个电机命令下发失败
+     * @return 成功下发命令至所有电机为 true；否则 error 为第一个失败车轮的错误，
+     *         紧急停止后作废为 PREEMPTED
      */
-    bool setSpeed(float vx, float vy, float omega);
+    BusResult setSpeed(float vx, float vy, float omega);
 
     /**
      * @brief 通过位置模式控制小车运动
@@ -88,10 +133,10 @@ public:
      * @param dx X方向位移 (m)
      * @param dy Y方向位移 (m)
      * @param dtheta 旋转角度 (rad)
-     * @return true 成功下发命令至所有电机
-     * @return false 至少一个电机命令下发失败
+     * @return 成功下发命令至所有电机为 true；否则 error 为第一个失败车轮的错误，
+     *         紧急停止后作废为 PREEMPTED
      */
-    bool moveDistance(float dx, float dy, float dtheta);
+    BusResult moveDistance(float dx, float dy, float dtheta);
 
     /**
      * @brief 带完整参数的位置模式控制接口
@@ -102,10 +147,16 @@ public:
      * @param acceleration 加速度
      * @param speed 运动速度 (m/s)
      * @param subdivision 细分数
-     * @return true 成功下发命令至所有电机
-     * @return false 至少一个电机命令下发失败
+     * @return 成功下发命令至所有电机为 true；否则 error 为第一个失败车轮的错误，
+     *         紧急停止后作废为 PREEMPTED
+     */
+    BusResult moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision);
+
+    /**
+     * @brief 同上，generation 为命令发出时的 estopGeneration()：此后发生过紧急停止则不下发，结果为 PREEMPTED
      */
-    bool moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision);
+    BusResult moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision,
+                      uint32_t generation);
 
     /**
      * @brief 带加速度（及细分参数）的接口，用户可以通过此版本自定义
@@ -115,47 +166,265 @@ public:
      * @param omega 旋转角速度 (rad/s)
      * @param acceleration 加速度
      * @param subdivision 细分数
-     * @return true 成功下发命令至所有电机
-     * @return false 至少一个电机命令下发失败
+     * @return 成功下发命令至所有电机为 true；否则 error 为第一个失败车轮的错误，
+     *         紧急停止后作废为 PREEMPTED
      */
-    bool setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision);
+    BusResult setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision);
 
+    /**
+     * @brief 同上，generation 为命令发出时的 estopGeneration()：此后发生过紧急停止则不下发，结果为 PREEMPTED
+     */
+    BusResult setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision, uint32_t generation);
 
     /**
-     * @brief 紧急停止小车运动
+     * @brief 提交速度命令，不等待应答（参数同 setSpeed）
      *
-     * 调用所有步进电机的紧急停止接口，实现小车立即停止。
+     * 供固定周期的控制任务使用：车轮命令（单总线时连同同步触发帧）提交后立即返回，
+     * 之后的周期中以 collectMotion() 收集应答；多总线的同步触发帧在收集到车轮应答后才提交。
+     * 已有运动命令尚未收集时先等待其完成。须与其它运动接口在同一任务中调用。
+     * @return 已提交为 true；紧急停止后作废为 PREEMPTED，总线队列已满为 QUEUE_FULL
+     */
+    BusResult beginSetSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision,
+                            uint32_t generation);
+
+    /**
+     * @brief 提交位置命令，不等待应答（参数同 moveDistance，收集方式同 beginSetSpeed）
+     */
+    BusResult beginMoveDistance(float dx, float dy, float dtheta, float acceleration, float speed,
+                                uint16_t subdivision, uint32_t generation);
+
+    /**
+     * @brief 推进已提交的运动命令，不阻塞
      *
-     * @return true 所有电机停止成功
-     * @return false 至少有一个电机停止失败
+     * 多总线时车轮应答全部完成后在此提交同步触发帧（其间发生过紧急停止则不再触发）。
+     * @param result 全部应答完成时填入结果，同 setSpeed() 的返回值
+     * @return 没有进行中的运动命令或仍有应答未完成返回 false，result 不修改
+     */
+    bool collectMotion(BusResult& result);
+
+    // 是否有已提交而尚未收集的运动命令
+    bool motionPending() const { return motionStage != MotionStage::IDLE; }
+
+
+    /**
+     * @brief 停止小车运动，等同于 emergencyStop(micros())
+     * @return 全部车轮确认停止返回 true
      */
     bool stop();
 
+    /**
+     * @brief 紧急停止（可在任意任务中调用，与控制任务并发执行）
+     *
+     * 各总线以 MotorBus::preempt() 发出广播停止：正在等待应答的事务在当前帧发送完成后被抢占，
+     * 尚未发送的设定值被作废，停止帧不等待应答。随后以 HIGH 优先级回读各车轮实时转速确认停止，
+     * 仍在转动或未应答的车轮再广播一次停止，最多 ESTOP_MAX_ATTEMPTS 次；已熔断的车轮不参与确认。
+     * 不经过熔断器，不修改车轮的熔断器与设定值状态（由调用运动接口的任务维护）。
+     *
+     * 开始时紧急停止代数（estopGeneration()）加 1，起到锁存作用：此前发出、在另一任务中正在下发的运动命令
+     * 在提交前检查代数，不会在停止帧之后再被提交；只有之后发出的新命令才能重新驱动车轮。
+     * @param receivedUs 收到停止命令的时刻（micros()），用于统计端到端延迟
+     * @return 全部车轮回读转速为 0 返回 true
+     */
+    bool emergencyStop(uint32_t receivedUs);
+
+    // 紧急停止统计
+    EStopStats getEStopStats() const;
+
+    // 紧急停止代数：每次 emergencyStop() 开始时加 1
+    uint32_t estopGeneration() const { return estopGen.load(std::memory_order_acquire); }
+
+    // 紧急停止延迟目标（微秒）
+    static constexpr uint32_t ESTOP_TARGET_US = 2000;
+    // 单次紧急停止最多广播停止的次数
+    static constexpr uint8_t ESTOP_MAX_ATTEMPTS = 3;
+
     /**
      * @brief 获取当前小车状态
      *
-     * 在返回状态前内部会自动更新状态反馈信息
+     * 在返回状态前内部会自动更新状态反馈信息：每个车轮一次读取系统状态参数，
+     * 同时填充 wheelSpeeds 与 telemetry。等待全部读取完成，等同于 beginStatePoll() 后阻塞收集；
+     * 已有轮询在进行时等待其完成
      * @return CarState 当前小车的状态结构体
      */
     CarState getCarState();
 
+    /**
+     * @brief 提交一次状态轮询（每个车轮一次读取系统状态参数），不等待总线
+     *
+     * 供固定周期的控制任务使用：提交后在之后的周期中以 collectCarState() 收集结果，
+     * 轮询的总线时间不占用控制周期。须与运动接口在同一任务中调用。
+     * @return 已有轮询尚未收集返回 false（不重复提交）
+     */
+    bool beginStatePoll();
+
+    /**
+     * @brief 收集已完成的状态轮询，不阻塞
+     * @param state 全部读取完成时填入最新状态（同 getCarState()）
+     * @return 没有进行中的轮询或仍有读取未完成返回 false，state 不修改
+     */
+    bool collectCarState(CarState& state);
+
+    // 是否有已提交而尚未收集的状态轮询
+    bool statePollPending() const { return pollInFlight; }
+
+    /**
+     * @brief 启用/关闭免应答控制命令模式
+     *
+     * 驱动器的控制命令应答设置须已为 CommandResponse::NONE（可用 StepperMotor::setCommandResponse 修改）。
+     * 启用后速度/位置设定值发送完成即返回，不再占用总线等待应答；
+     * getCarState() 读取实时转速时验证速度设定值是否送达，丢失则重发。
+     * @return 所有电机切换成功为 true；启用失败时全部保持应答模式，error 为第一个失败电机的错误
+     */
+    BusResult setUnacknowledgedMode(bool enable);
+
+    /**
+     * @brief 使能/关闭全部车轮电机
+     *
+     * 构造函数不访问总线（全局对象构造时串口尚未打开），需在总线启动后调用。
+     * 四个车轮的命令先全部提交再统一等待，已熔断的车轮直接跳过。
+     * @return 全部车轮执行成功为 true，否则 error 为第一个失败车轮的错误（已熔断的车轮为 CIRCUIT_OPEN）
+     */
+    BusResult enableMotors(bool enable);
+
+    /**
+     * @brief 应用启动探测得到的电机表
+     *
+     * 电机表的总线序号须与本类的总线顺序（getBus）一致。
+     *  - 未发现的车轮直接熔断（markAbsent），控制命令不再等待其应答超时；
+     *  - 各车轮及广播电机按探测到的校验方式通讯；
+     *  - 运动学模型的每圈整步数、默认细分数与免应答模式按驱动器实际配置设置。
+     * @return 四个车轮均在线、配置读取成功且电机类型/细分/应答设置/同总线校验方式一致时返回 true；
+     *         不一致的参数保持原值
+     */
+    bool applyMotorTable(const MotorTable& table);
+
+    // 电机表是否包含四个车轮且配置有效（用于判断缓存的电机表能否直接使用）
+    bool coversWheels(const MotorTable& table) const;
+
+    // 电机总线数量
+    size_t getBusCount() const { return busCount; }
+
+    /**
+     * @brief 获取第 index 条电机总线（用于统计与诊断）
+     * @return 超出范围返回 nullptr
+     */
+    MotorBus* getBus(size_t index) const { return index < busCount ? broadcasters[index]->bus() : nullptr; }
+
+    /**
+     * @brief 设置车轮单次调用（含重发）的时间预算，0 表示不限（须与运动接口在同一任务中调用）
+     *
+     * 构造后不限预算，启动阶段的使能等调用按重发次数照常重发。超出预算的重发被放弃，
+     * 由之后的新设定值取代；小于 minCallBudgetUs() 的预算使应答超时后从不重发。
+     * 广播电机的事务（同步触发、停止）不重发，不设预算。
+     */
+    void setCallBudget(uint32_t budgetUs);
+
+    // 车轮单次调用在应答超时后至少还能重发一次的预算，按应答期限最长的运行时事务（读取系统状态）计算
+    uint32_t minCallBudgetUs() const;
+
     /**
      * @brief 设置默认控制参数
      * @param config 配置结构体，包含默认加速度、默认细分数等
      */
     void configure(const CarControllerConfig& config);
 
+    // 当前默认控制参数
+    CarControllerConfig getConfig() const { return defaultConfig; }
+
+    /**
+     * @brief 替换运动学模型的几何参数（须在调用运动接口的同一任务中调用）
+     * @return 模型接受新参数返回 true
+     */
+    bool setGeometry(const ChassisGeometry& geometry) { return kinematics->setGeometry(geometry); }
+
+    // 当前几何参数
+    ChassisGeometry getGeometry() const { return kinematics->geometry(); }
+
 private:
+    // 运动命令的下发阶段
+    enum class MotionStage : uint8_t {
+        IDLE,           // 没有进行中的运动命令
+        WHEEL_ACKS,     // 多总线：车轮命令已提交，收到应答后再提交同步触发帧
+        TRIGGERED       // 同步触发帧已提交（单总线与车轮命令一同提交），等待全部应答
+    };
+
+    /**
+     * @brief 将 motionTxs 中四个带同步标志的车轮命令按总线分组提交，不等待应答
+     *
+     * 单总线时命令与同步触发帧在一次串口写入中发出；多总线时各总线并行写出命令，
+     * 车轮应答后由 triggerMotion() 在各总线上同时提交同步触发帧。
+     * @return 已提交为 true，否则为 PREEMPTED（紧急停止后作废）或 QUEUE_FULL
+     */
+    BusResult sendSyncBurst(uint32_t generation);
+
+    // 多总线：车轮应答完成后提交同步触发帧；其间发生过紧急停止返回 false，运动命令作废
+    bool triggerMotion();
+
+    // 等待进行中的运动命令全部完成（多总线时先提交同步触发帧），结果同 setSpeed()
+    BusResult finishMotion();
+
+    // 进行中的运动命令是否已全部完成（不含尚未提交的同步触发帧）
+    bool motionSettled() const;
+
+    /**
+     * @brief 提交运动事务前调用：持有紧急停止锁，期间紧急停止不会开始
+     * @return generation 之后没有发生过紧急停止返回 true；无论结果都须调用 endMotionSubmit()
+     */
+    bool beginMotionSubmit(uint32_t generation);
+    void endMotionSubmit();
+
+    // 运动命令因紧急停止被丢弃：放弃车轮上待验证的设定值，结果为 PREEMPTED
+    BusResult dropMotion();
+
+    // 重发车轮 i 丢失的速度设定值；设定值下发之后发生过紧急停止则放弃
+    void resendSetpoint(size_t i);
+
+    // 更新已熔断车轮的位掩码，供紧急停止在其它任务中读取
+    void publishWheelHealth();
+
+    // 等待进行中的状态轮询全部完成并解析，更新 currentState
+    void finishStatePoll();
+
+    // 等待四个车轮的命令事务完成，结果为第一个失败车轮的错误
+    BusResult awaitWheelAcks(std::array<BusTransaction, 4>& txs);
+
+    // 查找电机所在总线对应的广播电机序号，未配置返回 -1
+    int busIndexOf(const StepperMotor* motor) const;
+
     StepperMotor* motorRF;   // 右前轮
     StepperMotor* motorRR;   // 右后轮
     StepperMotor* motorLR;   // 左后轮
     StepperMotor* motorLF;   // 左前轮
-    StepperMotor* motor0;   // 主控板步进电机
+    // 各总线的广播电机（地址 0），用于同步触发与停止
+    std::array<StepperMotor*, MAX_BUSES> broadcasters{};
+    size_t busCount = 0;
 
     KinematicsModel* kinematics; // 运动学模型
 
+    // 按轮序（右前、右后、左后、左前）排列的车轮电机，便于批量提交事务
+    std::array<StepperMotor*, 4> wheels;
+
 
     CarState currentState;
+    // 进行中的状态轮询（beginStatePoll 提交，finishStatePoll 收集）
+    std::array<BusTransaction, 4> pollTxs;
+    bool pollInFlight = false;
+    // 进行中的运动命令（sendSyncBurst 提交，finishMotion 收集）
+    std::array<BusTransaction, 4> motionTxs;
+    std::array<BusTransaction, MAX_BUSES> syncTxs;
+    uint8_t triggerBuses = 0;           // 需要同步触发的总线（位 b 对应总线 b）
+    uint32_t pendingGeneration = 0;     // 进行中的运动命令所属的紧急停止代数
+    MotionStage motionStage = MotionStage::IDLE;
+
+    // 紧急停止互斥：串行化并发的紧急停止并保护统计，运动事务在持有该锁时检查代数并提交
+    SemaphoreHandle_t estopMutex = nullptr;
+    std::atomic<uint32_t> estopGen{0};
+    // 已熔断车轮的位掩码（位 i 对应轮序 i），由调用运动接口的任务更新
+    std::atomic<uint8_t> openWheels{0};
+    // 最近一次下发的运动命令所属的紧急停止代数（调用运动接口的任务私有）
+    uint32_t motionGeneration = 0;
+    EStopStats estopStats;
+    uint64_t estopTotalUs = 0;
 
     //初始化CarControllerConfig, 默认加速度为10.0, 默认细分数为16
     CarControllerConfig defaultConfig;
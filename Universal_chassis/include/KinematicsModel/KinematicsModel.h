@@ -11,6 +11,18 @@
 #include <array>
 #include <cmath> // 为了计算周长等
 
+/**
+ * @brief 底盘几何参数
+ *
+ * 各模型只使用其中与自身相关的字段，其余字段忽略。
+ */
+struct ChassisGeometry {
+    float wheelRadius = 0.0f;      // 轮子半径 (m)
+    float wheelBase = 0.0f;        // 前后轮距离 (m)
+    float trackWidth = 0.0f;       // 左右轮距 (m)
+    float reductionRatio = 1.0f;   // 减速比
+};
+
 /**
  * @brief 抽象基类：运动学模型
  *
@@ -46,6 +58,27 @@ public:
     //根据轮子转速计算vx以及theta
     virtual void calculateWheelSpeeds(std::array<int16_t, 4>& speeds,
                              float& vx, float& vy, float& omega) = 0;
+
+    /**
+     * @brief 设置电机每圈整步数（1.8° 电机为 200，0.9° 电机为 400），由启动探测结果确定
+     */
+    void setFullStepsPerRevolution(uint16_t steps) { if (steps) fullStepsPerRev = steps; }
+    uint16_t fullStepsPerRevolution() const { return fullStepsPerRev; }
+
+    /**
+     * @brief 替换几何参数（运行时修改，无需重启）
+     *
+     * 与 calculate* 系列接口须在同一任务中调用（ControlManager 在控制任务中执行），
+     * 因此一次计算使用的参数不会新旧混合。
+     * @return 模型支持在线修改且参数有效返回 true
+     */
+    virtual bool setGeometry(const ChassisGeometry& geometry) { (void)geometry; return false; }
+
+    // 当前几何参数
+    virtual ChassisGeometry geometry() const { return ChassisGeometry{}; }
+
+protected:
+    uint16_t fullStepsPerRev = 200;  // 每圈整步数，每圈脉冲数 = 整步数 * 细分数
 };
 
 /**
@@ -132,6 +165,10 @@ public:
     //根据轮子转速计算vx以及theta
     virtual void calculateWheelSpeeds(std::array<int16_t, 4>& speeds,
                              float& vx, float& vy, float& omega) override;
+
+    // 使用 wheelRadius、trackWidth 与 reductionRatio，须均为正数
+    virtual bool setGeometry(const ChassisGeometry& geometry) override;
+    virtual ChassisGeometry geometry() const override;
 private:   //-------硬件参数都是用运动学模型输入，软件参数如细分数，加速度，速度等都是用CarController输入
     float wheelRadius;       // 轮子半径
     float wheelCircumference;  // 内部计算得出：2 * PI * wheelRadius
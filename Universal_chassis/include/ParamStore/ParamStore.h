@@ -0,0 +1,120 @@
+/*
+ * @Description: 持久化参数存储（NVS）
+ *
+ * 底盘几何参数、默认控制参数与上次启动探测得到的驱动器表保存为一个扁平的 POD 参数块，
+ * 整块作为一个 NVS blob 读写。参数块带魔数、版本号、长度与 CRC32，任一项不符即视为无效并使用默认值；
+ * 参数块只含定宽字段，可直接按字节映射，便于主机工具解析。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "KinematicsModel/KinematicsModel.h"
+#include "CarController/CarController.h"
+#include "StepperMotor/MotorDiscovery.h"
+
+// 缓存的驱动器记录（MotorProfile 的定宽子集）
+struct CachedMotor {
+    uint8_t address;
+    uint8_t bus;
+    uint8_t checksumType;       // ChecksumType
+    uint8_t firmwareVersion;
+    uint8_t hardwareVersion;
+    uint8_t motorType;          // DriverConfig::motorType
+    uint8_t cmdResponse;        // DriverConfig::cmdResponse
+    uint8_t reserved;
+    uint16_t subdivision;       // DriverConfig::subdivision
+    uint16_t reserved2;
+};
+
+// 参数块：所有字段定宽、无指针，整体存取
+struct ParamBlock {
+    static constexpr uint32_t MAGIC = 0x53504355;   // "UCPS"
+    static constexpr uint16_t VERSION = 1;
+
+    // 头部（crc 覆盖头部之后的全部字节）
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t crc;
+
+    // 底盘几何参数
+    float wheelRadius;
+    float wheelBase;
+    float trackWidth;
+    float reductionRatio;
+
+    // 默认控制参数（CarControllerConfig）
+    float defaultAcceleration;
+    float defaultSubdivision;
+    float defaultSpeed;
+
+    // 上次启动探测的驱动器表，motorCount 为 0 表示没有缓存
+    uint8_t motorCount;
+    uint8_t reserved[3];
+    CachedMotor motors[MotorTable::MAX_MOTORS];
+};
+
+static_assert(sizeof(CachedMotor) == 12, "CachedMotor layout changed: bump ParamBlock::VERSION");
+static_assert(std::is_trivially_copyable<ParamBlock>::value && std::is_standard_layout<ParamBlock>::value,
+              "ParamBlock must stay a flat POD");
+
+class ParamStore {
+public:
+    /**
+     * @param nvsNamespace NVS 命名空间（不超过 15 个字符）
+     */
+    explicit ParamStore(const char* nvsNamespace = "chassis");
+
+    /**
+     * @brief 从 NVS 读取参数块
+     * @param geometry 参数块无效时使用的几何参数
+     * @param config 参数块无效时使用的默认控制参数
+     * @return 读到有效参数块返回 true；否则载入默认值（不写入 NVS）并返回 false
+     */
+    bool begin(const ChassisGeometry& geometry, const CarControllerConfig& config);
+
+    // 参数块写入 NVS
+    bool save();
+
+    // 当前参数（副本）
+    ChassisGeometry geometry() const;
+    CarControllerConfig controlConfig() const;
+
+    /**
+     * @brief 按名称修改参数（只修改内存中的参数块，持久化需调用 save()）
+     * @return 名称存在且值有效返回 true
+     */
+    bool set(const char* name, float value);
+
+    // 按名称读取参数，名称不存在返回 false
+    bool get(const char* name, float& value) const;
+
+    // 可按名称访问的参数
+    static size_t paramCount();
+    static const char* paramName(size_t index);
+
+    /**
+     * @brief 读取缓存的驱动器表
+     * @return 有缓存返回 true
+     */
+    bool loadMotorTable(MotorTable& table) const;
+
+    // 以探测结果替换驱动器表缓存（只保留配置读取成功的驱动器）
+    void storeMotorTable(const MotorTable& table);
+
+    // 清除驱动器表缓存，下次启动重新探测
+    void clearMotorTable();
+
+private:
+    static uint32_t crc32(const uint8_t* data, size_t length);
+    static uint32_t blockCrc(const ParamBlock& block);
+
+    const char* nvsNamespace;
+    ParamBlock block;
+    SemaphoreHandle_t mutex = nullptr;
+};
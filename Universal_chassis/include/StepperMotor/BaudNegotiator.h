@@ -0,0 +1,130 @@
+/*
+ * @Description: 串口波特率协商与链路质量监测
+ *
+ * 启动时：
+ *  1. 依次以各候选波特率探测总线上的驱动器，找到有驱动器应答的速率；探测时识别各驱动器的校验方式
+ *     （固定 0x6B / XOR / CRC8），协商可在 MotorDiscovery 之前进行；未应答的驱动器（未接入）不参与协商；
+ *  2. 从最高候选速率向下尝试：逐个修改在线驱动器的波特率（modifyDriverConfig，默认不写入 Flash），
+ *     切换本地串口后做误码率测试，通过即采用；未通过则切回原速率继续尝试下一档。
+ * 运行时：
+ *  按固定窗口统计收发字节数、超时与校验失败，误码率超过阈值时自动降到下一档速率。
+ *
+ * 仅适用于 UART 总线；CAN 总线的位速率由硬件接线决定，不做协商。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+
+// 链路质量（最近一个统计窗口）
+struct LinkQuality {
+    uint32_t baudRate = 0;          // 当前波特率
+    float txBytesPerSec = 0.0f;     // 发送速率
+    float rxBytesPerSec = 0.0f;     // 接收速率
+    uint32_t attempts = 0;          // 窗口内等待应答的发送次数
+    uint32_t timeouts = 0;          // 窗口内超时次数
+    uint32_t checksumErrors = 0;    // 窗口内校验失败次数
+    float errorRate = 0.0f;         // (超时 + 校验失败) / 发送次数
+    uint32_t fallbacks = 0;         // 自启动以来自动降速次数
+};
+
+class BaudNegotiator {
+public:
+    /**
+     * @brief 构造函数
+     * @param bus 电机总线（UART）
+     * @param motors 该总线上需要协商的驱动器（不含广播地址 0）
+     * @param count 驱动器数量，不超过 MAX_MOTORS
+     */
+    BaudNegotiator(MotorBus* bus, StepperMotor* const* motors, size_t count);
+
+    /**
+     * @brief 设置候选波特率（需为 Emm42 支持的速率，按从高到低排列）
+     */
+    void setCandidates(const uint32_t* rates, size_t count);
+
+    /**
+     * @brief 设置误码率测试参数
+     * @param probesPerMotor 每个驱动器的测试读取次数
+     * @param maxErrorRate 协商时允许的最大误码率
+     * @param fallbackErrorRate 运行期触发降速的误码率
+     */
+    void setErrorLimits(uint16_t probesPerMotor, float maxErrorRate, float fallbackErrorRate);
+
+    /**
+     * @brief 启动协商，需在控制任务开始下发命令之前调用
+     *
+     * 探测到的校验方式写回各 StepperMotor（setChecksumType）。
+     * @param persist 选定的波特率是否写入驱动器 Flash
+     * @return 至少一个驱动器应答、找到在线驱动器共同可用的速率返回 true（可能仍为原速率）
+     */
+    bool negotiate(bool persist = false);
+
+    // 参与协商的（启动时应答的）驱动器数
+    size_t onlineCount() const;
+
+    /**
+     * @brief 结束一个统计窗口：更新链路质量，误码率超标时降到下一档速率
+     * @return 本次发生降速返回 true
+     */
+    bool supervise();
+
+    /**
+     * @brief 启动后台监测任务，每 periodMs 调用一次 supervise()
+     */
+    bool startSupervisor(uint32_t periodMs = 1000, UBaseType_t taskPriority = 1);
+
+    // 最近一个窗口的链路质量
+    LinkQuality quality() const;
+
+    // 当前波特率
+    uint32_t currentRate() const { return bus ? bus->bitRate() : 0; }
+
+    static constexpr size_t MAX_MOTORS = 8;
+    static constexpr size_t MAX_CANDIDATES = 9;
+
+private:
+    // 以当前波特率测试在线驱动器，返回误码率；任一驱动器完全无应答返回 1
+    float probe(uint16_t probesPerMotor);
+
+    // 以 rate 探测全部驱动器（必要时逐一尝试各校验方式），记录应答的驱动器，返回应答数
+    size_t detectAt(uint32_t rate);
+
+    // 以 rate 探测在线驱动器是否都能应答
+    bool respondsAt(uint32_t rate);
+
+    // 单个驱动器以当前速率与校验方式读取系统状态，tries 次内有一次成功即在线
+    bool present(StepperMotor* motor, int tries);
+
+    // 将在线驱动器从 from 切换到 to 并切换本地串口；失败时尽量切回 from
+    bool switchRate(uint32_t from, uint32_t to, bool persist);
+
+    // 修改在线驱动器的波特率设置（以当前本地速率通讯）
+    bool setDriverRate(uint32_t rate, bool persist);
+
+    static void supervisorTaskWrapper(void* param);
+
+    MotorBus* bus;
+    StepperMotor* motors[MAX_MOTORS] = {};
+    bool online[MAX_MOTORS] = {};   // 启动时应答的驱动器
+    size_t motorCount = 0;
+
+    uint32_t candidates[MAX_CANDIDATES] = {};
+    size_t candidateCount = 0;
+
+    uint16_t probesPerMotor = 20;
+    float maxErrorRate = 0.01f;
+    float fallbackErrorRate = 0.05f;
+    // 窗口内发送次数少于该值时不做降速判定
+    static constexpr uint32_t MIN_WINDOW_ATTEMPTS = 50;
+
+    uint32_t periodMs = 1000;
+    LinkStats lastStats;
+    uint32_t lastWindowMs = 0;
+    LinkQuality linkQuality;
+    SemaphoreHandle_t qualityMutex = nullptr;
+    TaskHandle_t supervisorHandle = nullptr;
+};
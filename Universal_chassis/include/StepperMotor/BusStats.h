@@ -0,0 +1,199 @@
+/*
+ * @Description: 总线事务统计
+ *
+ * 按 (电机地址, 功能码) 分别统计事务数、重发、超时、校验失败与应答延迟。
+ * 延迟使用对数分桶直方图：每个 2 的幂区间分为 4 个子桶，相对误差不超过 25%，
+ * 覆盖 1 us ~ 4 s，单个直方图固定 84 个计数器，记录为 O(1) 且无堆分配。
+ *
+ * 本文件不依赖 Arduino/FreeRTOS，可在主机上直接编译；线程安全由 MotorBus 负责。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 对数分桶延迟直方图（微秒）
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKETS = 4;
+    static constexpr size_t BUCKETS = 84;   // 0~3 us 各一桶，其后每个 2 的幂区间 4 桶，上限约 4.2 s
+
+    void record(uint32_t us) {
+        ++buckets[bucketOf(us)];
+        if (samples == 0 || us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+        sumUs += us;
+        ++samples;
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+    uint32_t count() const { return samples; }
+    uint32_t min() const { return minUs; }
+    uint32_t max() const { return maxUs; }
+    uint32_t mean() const { return samples ? static_cast<uint32_t>(sumUs / samples) : 0; }
+
+    /**
+     * @brief 百分位延迟（返回所在桶的上界，不超过实测最大值）
+     * @param fraction 百分位（0~1），如 0.99
+     */
+    uint32_t percentile(float fraction) const {
+        if (samples == 0) {
+            return 0;
+        }
+        uint32_t rank = static_cast<uint32_t>(fraction * samples + 0.5f);
+        if (rank == 0) rank = 1;
+        uint32_t seen = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                uint32_t upper = bucketUpper(b);
+                return upper < maxUs ? upper : maxUs;
+            }
+        }
+        return maxUs;
+    }
+
+    // 延迟所在的桶序号
+    static size_t bucketOf(uint32_t us) {
+        if (us < SUB_BUCKETS) {
+            return us;
+        }
+        unsigned msb = 31 - static_cast<unsigned>(__builtin_clz(us));
+        size_t bucket = SUB_BUCKETS * (msb - 1) + ((us >> (msb - 2)) & (SUB_BUCKETS - 1));
+        return bucket < BUCKETS ? bucket : BUCKETS - 1;
+    }
+
+    // 桶内最大延迟
+    static uint32_t bucketUpper(size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return static_cast<uint32_t>(bucket);
+        }
+        unsigned msb = static_cast<unsigned>(bucket / SUB_BUCKETS + 1);
+        uint32_t width = 1u << (msb - 2);
+        uint32_t lower = static_cast<uint32_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (msb - 2);
+        return lower + width - 1;
+    }
+
+private:
+    uint32_t buckets[BUCKETS] = {};
+    uint32_t samples = 0;
+    uint32_t minUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+};
+
+// 单个 (地址, 功能码) 的统计摘要
+struct BusStatsSummary {
+    uint8_t address = 0;
+    uint8_t funcCode = 0;
+    uint32_t count = 0;             // 完成的事务数
+    uint32_t retries = 0;           // 重发次数
+    uint32_t timeouts = 0;          // 以超时结束的事务数
+    uint32_t checksumErrors = 0;    // 以校验失败结束的事务数
+    uint32_t rejected = 0;          // 驱动器拒绝（E2 / 00 EE）的事务数
+    uint32_t minUs = 0;             // 应答延迟（自首次发送起，仅统计收到应答或无需应答的事务）
+    uint32_t avgUs = 0;
+    uint32_t p99Us = 0;
+    uint32_t maxUs = 0;
+};
+
+/**
+ * @brief 按 (地址, 功能码) 分组的事务统计表
+ */
+class BusStats {
+public:
+    // 同时统计的 (地址, 功能码) 组合上限，超出部分只计入 droppedRecords()
+    static constexpr size_t MAX_ENTRIES = 24;
+
+    /**
+     * @brief 记录一个已完成的事务
+     * @param address 电机地址
+     * @param funcCode 功能码
+     * @param attempts 发送次数（含重发）
+     * @param timedOut 以超时结束
+     * @param checksumFailed 以校验失败结束
+     * @param rejected 驱动器拒绝
+     * @param latencyUs 自首次发送到完成的耗时；hasLatency 为 false 时不计入延迟直方图
+     */
+    void record(uint8_t address, uint8_t funcCode, uint8_t attempts,
+                bool timedOut, bool checksumFailed, bool rejected,
+                bool hasLatency, uint32_t latencyUs) {
+        Entry* entry = find(address, funcCode);
+        if (!entry) {
+            ++dropped;
+            return;
+        }
+        ++entry->count;
+        if (attempts > 1) entry->retries += attempts - 1;
+        if (timedOut) ++entry->timeouts;
+        if (checksumFailed) ++entry->checksumErrors;
+        if (rejected) ++entry->rejected;
+        if (hasLatency) entry->latency.record(latencyUs);
+    }
+
+    void reset() {
+        used = 0;
+        dropped = 0;
+    }
+
+    size_t size() const { return used; }
+    uint32_t droppedRecords() const { return dropped; }
+
+    // 第 index 个组合的摘要
+    BusStatsSummary summary(size_t index) const {
+        BusStatsSummary s;
+        if (index >= used) {
+            return s;
+        }
+        const Entry& e = entries[index];
+        s.address = e.address;
+        s.funcCode = e.funcCode;
+        s.count = e.count;
+        s.retries = e.retries;
+        s.timeouts = e.timeouts;
+        s.checksumErrors = e.checksumErrors;
+        s.rejected = e.rejected;
+        s.minUs = e.latency.min();
+        s.avgUs = e.latency.mean();
+        s.p99Us = e.latency.percentile(0.99f);
+        s.maxUs = e.latency.max();
+        return s;
+    }
+
+private:
+    struct Entry {
+        uint8_t address = 0;
+        uint8_t funcCode = 0;
+        uint32_t count = 0;
+        uint32_t retries = 0;
+        uint32_t timeouts = 0;
+        uint32_t checksumErrors = 0;
+        uint32_t rejected = 0;
+        LatencyHistogram latency;
+    };
+
+    // 查找组合，不存在时新建；表满返回 nullptr
+    Entry* find(uint8_t address, uint8_t funcCode) {
+        for (size_t i = 0; i < used; ++i) {
+            if (entries[i].address == address && entries[i].funcCode == funcCode) {
+                return &entries[i];
+            }
+        }
+        if (used >= MAX_ENTRIES) {
+            return nullptr;
+        }
+        Entry& entry = entries[used++];
+        entry = Entry();
+        entry.address = address;
+        entry.funcCode = funcCode;
+        return &entry;
+    }
+
+    Entry entries[MAX_ENTRIES];
+    size_t used = 0;
+    uint32_t dropped = 0;
+};
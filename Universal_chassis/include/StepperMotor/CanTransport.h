@@ -0,0 +1,125 @@
+/*
+ * @Description: CAN 传输层
+ *
+ * 命令帧按 Emm42 CAN 格式分包（Emm42Can.h），一次 writeFrames() 的全部分包连续排入发送队列，
+ * 四个车轮的设定值在一次总线仲裁周期内依次发出；应答按源地址重组后还原为串口格式字节流，
+ * MotorBus 的应答解析与 UART 完全相同。CAN 总线按 ID 仲裁，多个驱动器的应答不会冲突。
+ *
+ * 后端：
+ *  - TwaiTransport：ESP32 TWAI 控制器（目标板）
+ *  - SocketCanTransport：Linux SocketCAN（主机构建，可在 vcan0 上配合仿真驱动器运行）
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "StepperMotor/MotorTransport.h"
+#include "StepperMotor/Emm42Can.h"
+
+class CanTransport : public MotorTransport {
+public:
+    /**
+     * @brief 构造函数
+     * @param bitrate CAN 位速率（bit/s），需与驱动器 canCommRate 一致，默认 500K
+     */
+    explicit CanTransport(uint32_t bitrate = 500000) : canBitrate(bitrate) {}
+
+    bool writeFrames(const Emm42::ByteSpan* frames, size_t count) override;
+    int available() override;
+    int read() override;
+    uint32_t replyWireUs(size_t frameLen) const override;
+
+    uint32_t bitRate() const override { return canBitrate; }
+
+    // 应答重组中丢弃的包数
+    uint32_t droppedPackets() const { return reassembler.dropped(); }
+
+protected:
+    /**
+     * @brief 连续发送一组 CAN 包，返回时全部包已发出
+     */
+    virtual bool sendPackets(const Emm42::Can::Packet* packets, size_t count) = 0;
+
+    /**
+     * @brief 非阻塞接收一个 CAN 包
+     * @return 收到返回 true
+     */
+    virtual bool receivePacket(Emm42::Can::Packet& packet) = 0;
+
+private:
+    // 取出已收到的全部 CAN 包，重组后的应答帧写入接收缓冲
+    void pump();
+
+    uint32_t canBitrate;
+    Emm42::Can::Reassembler reassembler;
+
+    // 重组后的应答字节（环形缓冲，仅总线任务访问）
+    static constexpr size_t RX_BUFFER_SIZE = 256;
+    uint8_t rxBuffer[RX_BUFFER_SIZE];
+    size_t rxHead = 0;
+    size_t rxCount = 0;
+};
+
+#if defined(ESP_PLATFORM)
+
+/**
+ * @brief ESP32 TWAI 控制器后端
+ */
+class TwaiTransport : public CanTransport {
+public:
+    /**
+     * @param txPin TWAI TX 引脚（接 CAN 收发器 TXD）
+     * @param rxPin TWAI RX 引脚（接 CAN 收发器 RXD）
+     * @param bitrate 位速率，支持 125K/250K/500K/800K/1M
+     */
+    TwaiTransport(int txPin, int rxPin, uint32_t bitrate = 500000);
+
+    /**
+     * @brief 安装并启动 TWAI 驱动
+     * @return 成功返回 true；不支持的位速率返回 false
+     */
+    bool begin();
+
+protected:
+    bool sendPackets(const Emm42::Can::Packet* packets, size_t count) override;
+    bool receivePacket(Emm42::Can::Packet& packet) override;
+
+private:
+    int txPin;
+    int rxPin;
+    bool started = false;
+};
+
+#endif
+
+#if defined(__linux__)
+
+/**
+ * @brief Linux SocketCAN 后端
+ *
+ * 位速率由网络接口配置（ip link set can0 type can bitrate 500000），构造参数仅用于计算应答期限。
+ * 使用虚拟接口测试：
+ *   ip link add dev vcan0 type vcan && ip link set up vcan0
+ */
+class SocketCanTransport : public CanTransport {
+public:
+    explicit SocketCanTransport(const char* ifname, uint32_t bitrate = 500000);
+    ~SocketCanTransport() override;
+
+    /**
+     * @brief 打开并绑定 CAN_RAW 套接字（非阻塞）
+     * @return 成功返回 true
+     */
+    bool begin();
+
+protected:
+    bool sendPackets(const Emm42::Can::Packet* packets, size_t count) override;
+    bool receivePacket(Emm42::Can::Packet& packet) override;
+
+private:
+    const char* ifname;
+    int fd = -1;
+};
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * @Description: Emm42_V5.0 CAN 帧格式（分包与重组）
+ *
+ * CAN 通讯使用 29 位扩展帧：
+ *  - ID = 地址 << 8 | 包序号（包序号从 0 开始）
+ *  - 数据 = 功能码 + 指令数据 + 校验字节（地址由 ID 携带，不在数据中）
+ *  - 超过 8 字节的命令按包拆分，每包首字节均为功能码，其后最多 7 字节数据
+ * 应答使用相同格式。例如位置模式命令 01 FD 01 05 DC 00 00 00 7D 00 00 00 6B 拆分为：
+ *   ID 0x0100：FD 01 05 DC 00 00 00 7D
+ *   ID 0x0101：FD 00 00 00 6B
+ *
+ * 本文件不依赖 Arduino/FreeRTOS，可在主机上直接编译。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "StepperMotor/Emm42Frame.h"
+
+namespace Emm42 {
+namespace Can {
+
+// 每包除功能码外可携带的数据字节数
+constexpr size_t PACKET_PAYLOAD = 7;
+
+// 一帧串口格式的数据拆分后的包数（首两字节为地址与功能码，不占用包数据）
+constexpr size_t packetCount(size_t frameLen) {
+    return frameLen <= 2 ? 0 : (frameLen - 2 + PACKET_PAYLOAD - 1) / PACKET_PAYLOAD;
+}
+
+// 单帧最多拆分的包数
+constexpr size_t MAX_PACKETS = packetCount(MAX_FRAME_LEN);
+
+/**
+ * @brief 单个 CAN 扩展帧
+ */
+struct Packet {
+    uint32_t id = 0;        // 29 位扩展 ID
+    uint8_t length = 0;     // 数据长度（0~8）
+    uint8_t data[8] = {};
+
+    uint8_t address() const { return static_cast<uint8_t>((id >> 8) & 0xFF); }
+    uint8_t index() const { return static_cast<uint8_t>(id & 0xFF); }
+};
+
+/**
+ * @brief 一帧串口格式数据拆分后在总线上的位数
+ *
+ * 扩展数据帧固定开销 67 位（含帧间隔），数据每字节 8 位，按最坏情况计入 20% 位填充。
+ * 帧过短或超过 MAX_FRAME_LEN（fragment() 无法拆分，不会上线）时返回 0。
+ */
+constexpr uint32_t frameWireBits(size_t frameLen) {
+    return (packetCount(frameLen) == 0 || frameLen > MAX_FRAME_LEN) ? 0
+        : static_cast<uint32_t>(packetCount(frameLen) * 67 + (frameLen - 1 + packetCount(frameLen) - 1) * 8) * 6 / 5;
+}
+
+/**
+ * @brief 将一帧串口格式的命令（地址 + 功能码 + 数据 + 校验）拆分为 CAN 包
+ * @param frame 完整命令帧
+ * @param out 输出包数组
+ * @param capacity 输出数组容量
+ * @return 生成的包数；帧过短或容量不足返回 0
+ */
+inline size_t fragment(ByteSpan frame, Packet* out, size_t capacity) {
+    const size_t count = packetCount(frame.size);
+    if (count == 0 || count > capacity) {
+        return 0;
+    }
+    const uint8_t addr = frame.data[0];
+    const uint8_t func = frame.data[1];
+    size_t offset = 2;
+    for (size_t i = 0; i < count; ++i) {
+        Packet& packet = out[i];
+        packet.id = (static_cast<uint32_t>(addr) << 8) | static_cast<uint32_t>(i);
+        packet.data[0] = func;
+        size_t n = frame.size - offset;
+        if (n > PACKET_PAYLOAD) {
+            n = PACKET_PAYLOAD;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            packet.data[1 + j] = frame.data[offset + j];
+        }
+        packet.length = static_cast<uint8_t>(1 + n);
+        offset += n;
+    }
+    return count;
+}
+
+/**
+ * @brief 应答重组器
+ *
+ * 按源地址缓存分包，收齐一帧后还原为串口格式（地址 + 功能码 + 数据 + 校验），
+ * 交给 ResponseParser 按字节流解析。不同驱动器的应答分包可能在总线上交错到达，
+ * 按地址分别重组互不干扰。
+ * 应答总长度由功能码确定（responseLength），错误应答（功能码 0x00）固定 4 字节；
+ * 未知功能码的包直接逐包输出。
+ */
+class Reassembler {
+public:
+    /**
+     * @brief 输入一个收到的 CAN 包
+     * @param packet CAN 包
+     * @param out 收齐一帧时写入完整帧
+     * @return 收齐一帧返回 true
+     */
+    bool feed(const Packet& packet, Frame& out) {
+        if (packet.length == 0) {
+            return false;
+        }
+        const uint8_t addr = packet.address();
+        const uint8_t func = packet.data[0];
+        const size_t expectLen = (func == 0x00) ? 4 : responseLength(func);
+
+        if (expectLen == 0) {
+            // 未知功能码：不做重组，原样输出
+            out.clear();
+            out.push(addr);
+            out.append(ByteSpan(packet.data, packet.length));
+            return true;
+        }
+
+        Slot* slot = find(addr);
+        if (packet.index() == 0) {
+            if (!slot) {
+                slot = allocate();
+            }
+            if (!slot) {
+                // 槽位全部占用：丢弃本包，不覆盖其它驱动器尚未收齐的应答
+                ++droppedPackets;
+                return false;
+            }
+            slot->active = true;
+            slot->addr = addr;
+            slot->expectLen = static_cast<uint8_t>(expectLen);
+            slot->nextIndex = 1;
+            slot->frame.clear();
+            slot->frame.push(addr);
+            slot->frame.append(ByteSpan(packet.data, packet.length));
+        } else {
+            // 后续包：序号或功能码不连续时丢弃已缓存的部分，等待下一帧首包
+            if (!slot || packet.index() != slot->nextIndex || func != slot->frame.bytes[1]) {
+                if (slot) {
+                    slot->active = false;
+                }
+                ++droppedPackets;
+                return false;
+            }
+            ++slot->nextIndex;
+            if (!slot->frame.append(ByteSpan(packet.data + 1, packet.length - 1))) {
+                slot->active = false;
+                ++droppedPackets;
+                return false;
+            }
+        }
+
+        if (slot->frame.length >= slot->expectLen) {
+            out = slot->frame;
+            slot->active = false;
+            return true;
+        }
+        return false;
+    }
+
+    // 丢弃全部未完成的重组
+    void reset() {
+        for (auto& slot : slots) {
+            slot.active = false;
+        }
+    }
+
+    // 因序号不连续、溢出或重组槽位占满而丢弃的包数
+    uint32_t dropped() const { return droppedPackets; }
+
+private:
+    struct Slot {
+        bool active = false;
+        uint8_t addr = 0;
+        uint8_t expectLen = 0;
+        uint8_t nextIndex = 0;
+        Frame frame;
+    };
+
+    // 同时重组的源地址数
+    static constexpr size_t MAX_SLOTS = 8;
+
+    Slot* find(uint8_t addr) {
+        for (auto& slot : slots) {
+            if (slot.active && slot.addr == addr) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    // 取一个空闲槽位；全部占用时返回 nullptr
+    Slot* allocate() {
+        for (auto& slot : slots) {
+            if (!slot.active) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    Slot slots[MAX_SLOTS];
+    uint32_t droppedPackets = 0;
+};
+
+} // namespace Can
+} // namespace Emm42
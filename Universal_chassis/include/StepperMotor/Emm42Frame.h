@@ -0,0 +1,475 @@
+/*
+ * @Description: Emm42_V5.0 通讯帧编解码（零堆分配）
+ *
+ * 本文件不依赖 Arduino/FreeRTOS，可在主机上直接编译（用于基准测试与仿真）。
+ * 所有帧均驻留在栈上：
+ *  - 命令帧使用 Emm42::FixedFrame<N>，N 由功能码在编译期确定；
+ *  - 应答帧/变长帧使用容量固定的 Emm42::Frame。
+ * 校验计算直接作用于 Emm42::ByteSpan，不做任何拷贝。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <type_traits>
+
+// 定义校验方式枚举，明确校验类型
+enum class ChecksumType {
+    FIXED,  // 固定校验，默认使用 0x6B
+    XOR,
+    CRC8
+};
+
+namespace Emm42 {
+
+// 单帧最大长度（读取驱动配置参数应答为 33 字节，修改驱动配置参数命令约 34 字节）
+constexpr size_t MAX_FRAME_LEN = 40;
+
+// 固定校验字节
+constexpr uint8_t FIXED_CHECKSUM = 0x6B;
+
+// 应答状态字节
+constexpr uint8_t REPLY_OK = 0x02;          // 命令执行成功
+constexpr uint8_t REPLY_CONDITION = 0xE2;   // 条件不满足
+constexpr uint8_t REPLY_ERROR = 0xEE;       // 错误命令（功能码位置为 0x00）
+
+/**
+ * @brief 只读字节视图
+ *
+ * 轻量级的 (指针, 长度) 二元组，用于在不拷贝的前提下传递缓冲区片段。
+ */
+struct ByteSpan {
+    const uint8_t* data;
+    size_t size;
+
+    constexpr ByteSpan() : data(nullptr), size(0) {}
+    constexpr ByteSpan(const uint8_t* d, size_t n) : data(d), size(n) {}
+
+    // 去掉末尾 n 个字节（用于排除校验字节）
+    constexpr ByteSpan dropBack(size_t n) const { return ByteSpan(data, n > size ? 0 : size - n); }
+};
+
+/**
+ * @brief 获取指定功能码命令帧的总长度（含地址与校验字节）
+ * @param funcCode 功能码
+ * @return 命令帧字节数；0 表示变长命令或未知功能码
+ */
+constexpr uint8_t requestLength(uint8_t funcCode) {
+    switch (funcCode) {
+        // 控制动作命令
+        case 0xF3: return 6;    // 电机使能：地址 F3 AB 使能 同步 校验
+        case 0xF6: return 8;    // 速度模式：地址 F6 方向 速度(2) 加速度 同步 校验
+        case 0xFD: return 13;   // 位置模式：地址 FD 方向 速度(2) 加速度 脉冲(4) 相对/绝对 同步 校验
+        case 0xFE: return 5;    // 立即停止：地址 FE 98 同步 校验
+        case 0xFF: return 4;    // 多机同步：地址 FF 66 校验
+        // 读取命令：地址 + 功能码 + 校验
+        case 0x1F: case 0x20: case 0x21: case 0x24: case 0x27:
+        case 0x31: case 0x32: case 0x33: case 0x34: case 0x35:
+        case 0x36: case 0x37: case 0x3A:
+            return 3;
+        case 0x42: return 4;    // 读取驱动配置：地址 42 6C 校验
+        case 0x43: return 4;    // 读取系统状态：地址 43 7A 校验
+        // 修改命令
+        case 0x84: return 6;    // 修改细分：地址 84 8A 存储 细分 校验
+        case 0xAE: return 6;    // 修改ID：地址 AE 4B 存储 ID 校验
+        case 0x46: return 6;    // 切换开/闭环：地址 46 69 存储 模式 校验
+        case 0x44: return 7;    // 修改开环电流：地址 44 33 存储 电流(2) 校验
+        case 0x4A: return 17;   // 修改PID：地址 4A C3 存储 Kp(4) Ki(4) Kd(4) 校验
+        case 0xF7: return 10;   // 存储速度模式参数：地址 F7 1C 存储 方向 速度(2) 加速度 En 校验
+        case 0x4F: return 6;    // 修改速度缩放：地址 4F 71 存储 使能 校验
+        case 0x48: return 0;    // 修改驱动配置：长度随参数数据变化
+        default:   return 0;
+    }
+}
+
+/**
+ * @brief 获取指定功能码应答帧的总长度（含地址与校验字节）
+ * @param funcCode 功能码
+ * @return 应答帧字节数；0 表示未知功能码
+ */
+constexpr uint8_t responseLength(uint8_t funcCode) {
+    switch (funcCode) {
+        // 控制/修改命令统一应答：地址 + 功能码 + 状态 + 校验
+        case 0xF3: case 0xF6: case 0xFD: case 0xFE: case 0xFF:
+        case 0x84: case 0xAE: case 0x46: case 0x44: case 0x48:
+        case 0x4A: case 0xF7: case 0x4F:
+            return 4;
+        case 0x1F: return 5;    // 固件版本 + 硬件版本
+        case 0x20: return 7;    // 相电阻(2) + 相电感(2)
+        case 0x21: return 15;   // Kp(4) + Ki(4) + Kd(4)
+        case 0x24: return 5;    // 总线电压(2)
+        case 0x27: return 5;    // 相电流(2)
+        case 0x31: return 5;    // 编码器值(2)
+        case 0x32: case 0x33: case 0x34: case 0x36: case 0x37:
+            return 8;           // 符号 + 4字节数值
+        case 0x35: return 6;    // 符号 + 转速(2)
+        case 0x3A: return 4;    // 状态字节
+        case 0x42: return 33;   // 驱动配置参数
+        case 0x43: return 31;   // 系统状态参数
+        default:   return 0;
+    }
+}
+
+/**
+ * @brief 该功能码的应答是否为统一确认应答（地址 + 功能码 + 状态 + 校验）
+ */
+constexpr bool isAckFunction(uint8_t funcCode) {
+    return responseLength(funcCode) == 4 && funcCode != 0x3A;
+}
+
+/**
+ * @brief 获取指定功能码的应答期限（微秒）
+ *
+ * 自命令帧发送完成起计时，不含应答帧本身的传输时间（由总线按波特率另行计算）。
+ * 控制命令的确认应答 3 ms，读取命令 5 ms；修改参数命令可能写入 Flash，放宽到 20 ms。
+ */
+constexpr uint32_t replyDeadlineUs(uint8_t funcCode) {
+    switch (funcCode) {
+        case 0xF3: case 0xF6: case 0xFD: case 0xFE: case 0xFF:
+            return 3000;
+        case 0x84: case 0xAE: case 0x46: case 0x44: case 0x48:
+        case 0x4A: case 0xF7: case 0x4F:
+            return 20000;
+        default:
+            return 5000;
+    }
+}
+
+namespace detail {
+
+// 编译期生成 CRC-8 查找表（多项式 0x07，初始值 0）
+constexpr std::array<uint8_t, 256> makeCrc8Table() {
+    std::array<uint8_t, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        uint8_t crc = static_cast<uint8_t>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> CRC8_TABLE = makeCrc8Table();
+
+} // namespace detail
+
+// CRC-8 校验（查表实现）
+inline uint8_t crc8(ByteSpan span) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < span.size; ++i) {
+        crc = detail::CRC8_TABLE[crc ^ span.data[i]];
+    }
+    return crc;
+}
+
+// XOR 校验
+inline uint8_t xorChecksum(ByteSpan span) {
+    uint8_t sum = 0;
+    for (size_t i = 0; i < span.size; ++i) {
+        sum ^= span.data[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief 计算校验字节
+ * @param type 校验方式
+ * @param span 参与校验的数据（不含校验字节本身）
+ * @return 校验字节
+ */
+inline uint8_t checksum(ChecksumType type, ByteSpan span) {
+    switch (type) {
+        case ChecksumType::XOR:  return xorChecksum(span);
+        case ChecksumType::CRC8: return crc8(span);
+        case ChecksumType::FIXED:
+        default:                 return FIXED_CHECKSUM;
+    }
+}
+
+/**
+ * @brief 校验一帧完整数据（最后一个字节为校验字节）
+ */
+inline bool verifyChecksum(ChecksumType type, ByteSpan frame) {
+    if (frame.size < 2) {
+        return false;
+    }
+    return checksum(type, frame.dropBack(1)) == frame.data[frame.size - 1];
+}
+
+// 多字节字段包装，用于在编译期确定帧长度
+struct U16 { uint16_t value; };
+struct U32 { uint32_t value; };
+
+namespace detail {
+
+template <typename T> struct FieldWidth : std::integral_constant<size_t, 1> {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Emm42 字段必须为整数类型");
+};
+template <> struct FieldWidth<U16> : std::integral_constant<size_t, 2> {};
+template <> struct FieldWidth<U32> : std::integral_constant<size_t, 4> {};
+
+template <typename... Fields> struct PayloadWidth;
+template <> struct PayloadWidth<> : std::integral_constant<size_t, 0> {};
+template <typename T, typename... Rest>
+struct PayloadWidth<T, Rest...>
+    : std::integral_constant<size_t, FieldWidth<typename std::decay<T>::type>::value + PayloadWidth<Rest...>::value> {};
+
+// 按大端顺序写入字段
+template <typename T>
+inline void put(uint8_t*& p, T value) { *p++ = static_cast<uint8_t>(value); }
+inline void put(uint8_t*& p, U16 field) {
+    *p++ = static_cast<uint8_t>((field.value >> 8) & 0xFF);
+    *p++ = static_cast<uint8_t>(field.value & 0xFF);
+}
+inline void put(uint8_t*& p, U32 field) {
+    *p++ = static_cast<uint8_t>((field.value >> 24) & 0xFF);
+    *p++ = static_cast<uint8_t>((field.value >> 16) & 0xFF);
+    *p++ = static_cast<uint8_t>((field.value >> 8) & 0xFF);
+    *p++ = static_cast<uint8_t>(field.value & 0xFF);
+}
+
+inline void putAll(uint8_t*&) {}
+template <typename T, typename... Rest>
+inline void putAll(uint8_t*& p, T first, Rest... rest) {
+    put(p, first);
+    putAll(p, rest...);
+}
+
+} // namespace detail
+
+/**
+ * @brief 定长命令帧
+ *
+ * 帧长度 N 在编译期由功能码确定，整帧驻留在栈上。
+ */
+template <size_t N>
+struct FixedFrame {
+    static_assert(N >= 3 && N <= MAX_FRAME_LEN, "Emm42 帧长度越界");
+    std::array<uint8_t, N> bytes;
+
+    static constexpr size_t size() { return N; }
+    const uint8_t* data() const { return bytes.data(); }
+    ByteSpan span() const { return ByteSpan(bytes.data(), N); }
+};
+
+/**
+ * @brief 编码命令帧
+ *
+ * 帧格式：地址 + 功能码 + 指令数据 + 校验字节。
+ * 指令数据字段的总宽度必须与 requestLength(FuncCode) 一致，否则编译失败。
+ * 示例：Emm42::encode<0xF6>(addr, ChecksumType::FIXED, dir, Emm42::U16{rpm}, acc, sync)
+ *
+ * @tparam FuncCode 功能码
+ * @param addr 电机地址
+ * @param type 校验方式
+ * @param payload 指令数据字段（uint8_t / U16 / U32）
+ * @return 编码完成的定长帧
+ */
+template <uint8_t FuncCode, typename... Fields>
+inline FixedFrame<requestLength(FuncCode)> encode(uint8_t addr, ChecksumType type, Fields... payload) {
+    constexpr size_t length = requestLength(FuncCode);
+    static_assert(length != 0, "变长命令请使用 Emm42::Frame");
+    static_assert(detail::PayloadWidth<Fields...>::value + 3 == length, "指令数据长度与功能码不匹配");
+
+    FixedFrame<length> frame;
+    uint8_t* p = frame.bytes.data();
+    *p++ = addr;
+    *p++ = FuncCode;
+    detail::putAll(p, payload...);
+    *p = checksum(type, ByteSpan(frame.bytes.data(), length - 1));
+    return frame;
+}
+
+/**
+ * @brief 容量固定的可变长度帧
+ *
+ * 用于接收应答以及长度在运行期确定的命令（如修改驱动配置参数）。
+ */
+struct Frame {
+    uint8_t bytes[MAX_FRAME_LEN];
+    uint8_t length = 0;
+
+    void clear() { length = 0; }
+    bool full() const { return length >= MAX_FRAME_LEN; }
+    bool push(uint8_t b) {
+        if (full()) return false;
+        bytes[length++] = b;
+        return true;
+    }
+    bool append(ByteSpan span) {
+        if (span.size > MAX_FRAME_LEN - length) return false;
+        for (size_t i = 0; i < span.size; ++i) bytes[length++] = span.data[i];
+        return true;
+    }
+    // 追加校验字节，完成一帧
+    bool seal(ChecksumType type) { return push(checksum(type, span())); }
+
+    size_t size() const { return length; }
+    const uint8_t* data() const { return bytes; }
+    ByteSpan span() const { return ByteSpan(bytes, length); }
+    uint8_t operator[](size_t i) const { return bytes[i]; }
+};
+
+//============================== 应答字段解析 ==============================
+
+// 大端读取 16 位无符号数
+inline uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+}
+
+// 大端读取 32 位无符号数
+inline uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// 读取 "符号(1字节) + 16位数值"，符号 0x01 表示负数
+inline int16_t readSigned16(const uint8_t* p) {
+    uint16_t raw = readU16(p + 1);
+    return (p[0] == 0x01) ? static_cast<int16_t>(-static_cast<int16_t>(raw)) : static_cast<int16_t>(raw);
+}
+
+// 读取 "符号(1字节) + 32位数值"，符号 0x01 表示负数
+inline int32_t readSigned32(const uint8_t* p) {
+    uint32_t raw = readU32(p + 1);
+    return (p[0] == 0x01) ? -static_cast<int32_t>(raw) : static_cast<int32_t>(raw);
+}
+
+//============================== 流式应答解析 ==============================
+
+/**
+ * @brief 逐字节应答解析状态机
+ *
+ * 根据请求的功能码预知应答长度，收到最后一个字节且校验通过即完成，无需固定延时。
+ * 遇到不匹配的地址/功能码或校验失败时，从已缓存字节中的下一个可能帧头重新同步，
+ * 而不是丢弃整个接收缓冲区。
+ *
+ * 支持的应答：
+ *  - 正常应答：地址 + 功能码 + 数据 + 校验，长度由 responseLength() 给出
+ *  - 错误命令应答：地址 + 0x00 + 0xEE + 校验
+ */
+class ResponseParser {
+public:
+    enum class Status : uint8_t {
+        PENDING,    // 尚未收到完整应答
+        COMPLETE    // 收到完整且校验通过的应答，可通过 frame() 获取
+    };
+
+    /**
+     * @brief 开始等待一帧新的应答
+     * @param expectAddr 期望的应答地址；0（广播）表示接受任意非零地址
+     * @param funcCode 请求的功能码
+     * @param type 校验方式
+     */
+    void begin(uint8_t expectAddr, uint8_t funcCode, ChecksumType type) {
+        this->expectAddr = expectAddr;
+        this->funcCode = funcCode;
+        this->type = type;
+        expectLen = 0;
+        discardedBytes = 0;
+        checksumFailures = 0;
+        status = Status::PENDING;
+        frameBuf.clear();
+    }
+
+    /**
+     * @brief 输入一个接收到的字节
+     * @return 当前解析状态
+     */
+    Status feed(uint8_t byte) {
+        if (status == Status::COMPLETE) {
+            return status;
+        }
+
+        if (frameBuf.length == 0) {
+            // 等待地址字节
+            if (acceptAddr(byte)) {
+                frameBuf.push(byte);
+            } else {
+                ++discardedBytes;
+            }
+            return status;
+        }
+
+        if (frameBuf.length == 1) {
+            // 等待功能码字节
+            if (byte == funcCode) {
+                expectLen = responseLength(funcCode);
+            } else if (byte == 0x00) {
+                expectLen = 4;          // 错误命令应答
+            } else {
+                // 非法功能码：丢弃已缓存的地址字节，以当前字节作为新的帧头候选
+                ++discardedBytes;
+                frameBuf.clear();
+                return feed(byte);
+            }
+            if (expectLen == 0) {
+                expectLen = MAX_FRAME_LEN;  // 未知功能码：最长等待一帧
+            }
+            frameBuf.push(byte);
+            return status;
+        }
+
+        frameBuf.push(byte);
+        if (frameBuf.length < expectLen) {
+            return status;
+        }
+
+        if (verifyChecksum(type, frameBuf.span())) {
+            status = Status::COMPLETE;
+            return status;
+        }
+
+        // 校验失败：从第二个字节开始重放，寻找下一个可能的帧头
+        ++checksumFailures;
+        resync();
+        return status;
+    }
+
+    // 是否为错误命令应答（地址 + 0x00 + 0xEE + 校验）
+    bool isErrorReply() const {
+        return status == Status::COMPLETE && frameBuf.length >= 3 && frameBuf.bytes[1] == 0x00;
+    }
+
+    Status state() const { return status; }
+    const Frame& frame() const { return frameBuf; }
+    // 期望的应答总长度（0 表示尚未确定）
+    uint8_t expectedLength() const { return expectLen; }
+    // 本次事务中被跳过的垃圾字节数
+    uint16_t discarded() const { return discardedBytes; }
+    // 本次事务中校验失败的候选帧数
+    uint16_t checksumErrors() const { return checksumFailures; }
+
+private:
+    bool acceptAddr(uint8_t byte) const {
+        return expectAddr == 0 ? byte != 0 : byte == expectAddr;
+    }
+
+    void resync() {
+        uint8_t pending[MAX_FRAME_LEN];
+        uint8_t count = frameBuf.length - 1;
+        for (uint8_t i = 0; i < count; ++i) {
+            pending[i] = frameBuf.bytes[i + 1];
+        }
+        ++discardedBytes;
+        frameBuf.clear();
+        expectLen = 0;
+        for (uint8_t i = 0; i < count && status == Status::PENDING; ++i) {
+            feed(pending[i]);
+        }
+    }
+
+    Frame frameBuf;
+    uint8_t expectAddr = 0;
+    uint8_t funcCode = 0;
+    uint8_t expectLen = 0;
+    ChecksumType type = ChecksumType::FIXED;
+    Status status = Status::PENDING;
+    uint16_t discardedBytes = 0;
+    uint16_t checksumFailures = 0;
+};
+
+} // namespace Emm42
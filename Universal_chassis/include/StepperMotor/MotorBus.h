@@ -0,0 +1,475 @@
+/*
+ * @Description: 电机总线调度器
+ *
+ * 多个 StepperMotor 共享同一条串口总线，由 MotorBus 独占串口并串行化所有事务：
+ *  - 调用者提交 BusTransaction（可带优先级与完成回调），由总线任务按优先级执行；
+ *  - 上一帧应答接收完成后立即发送下一帧，事务之间不插入任何等待；
+ *  - 突发（burst）提交：一组事务的命令帧拼接后一次串口写出，应答随后按地址/功能码分拣；
+ *  - 每个事务有按功能码确定的应答期限；失败后按指数退避重试，退避期间总线继续执行其它事务；
+ *  - 紧急事务（preempt）不排队：在当前帧发送完成后立即抢占正在等待应答的事务并发出；
+ *  - 可选的周期预算：每个控制周期为设定值、状态读取、诊断三类流量各保留固定的总线时间，超出预算的事务顺延到下一周期；
+ *  - StepperMotor 的阻塞式接口是 "提交 + 等待完成" 的封装。
+ * 物理链路由 MotorTransport 提供（UART 或 CAN），总线调度与应答解析与链路无关。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include "HardwareSerial.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "StepperMotor/Emm42Frame.h"
+#include "StepperMotor/MotorTransport.h"
+#include "StepperMotor/UartTransport.h"
+#include "StepperMotor/BusStats.h"
+
+// 事务优先级：数值越小越先执行
+enum class BusPriority : uint8_t {
+    HIGH = 0,    // 停止等紧急控制命令
+    NORMAL,      // 运动设定值与状态读取
+    LOW,         // 诊断类读取
+    COUNT
+};
+
+// 总线流量类别：启用周期预算时按类别分配总线时间，同优先级中按此顺序执行
+enum class BusClass : uint8_t {
+    SETPOINT = 0,   // 运动设定值：使能、速度、位置、停止、同步触发
+    TELEMETRY,      // 状态读取：转速、位置、编码器、状态标志
+    DIAGNOSTIC,     // 诊断读取与参数修改：电压、电流、PID、配置等
+    COUNT
+};
+
+// 按功能码确定流量类别
+inline BusClass busClassOf(uint8_t funcCode) {
+    switch (funcCode) {
+        case 0xF3: case 0xF6: case 0xFD: case 0xFE: case 0xFF:
+            return BusClass::SETPOINT;
+        case 0x31: case 0x32: case 0x33: case 0x34: case 0x35:
+        case 0x36: case 0x37: case 0x3A: case 0x43:
+            return BusClass::TELEMETRY;
+        default:
+            return BusClass::DIAGNOSTIC;
+    }
+}
+
+// 流量类别名称，用于日志与报告
+const char* busClassName(BusClass cls);
+
+// 事务执行结果
+enum class BusError : uint8_t {
+    NONE = 0,           // 成功
+    PENDING,            // 尚未完成
+    TIMEOUT,            // 期限内未收到任何完整应答
+    CHECKSUM,           // 期限内只收到校验失败的候选帧
+    REJECTED,           // 驱动器应答 E2：条件不满足（如未使能、堵转保护）
+    INVALID_COMMAND,    // 驱动器应答 00 EE：命令格式错误
+    WRITE_FAILED,       // 串口写入失败
+    QUEUE_FULL,         // 总线队列已满，事务未被接受
+    NO_PORT,            // 未绑定传输层
+    CIRCUIT_OPEN,       // 电机已熔断，事务未发送
+    PREEMPTED,          // 被紧急事务抢占：放弃等待应答，或尚未发送的设定值被作废
+    BAD_REPLY           // 收到校验正确的应答，但地址、功能码、长度或内容不符
+};
+
+// 错误码名称，用于日志
+const char* busErrorName(BusError error);
+
+/**
+ * @brief 阻塞接口的结果：成功为 true，失败时 error 给出原因
+ *
+ * 结果随返回值传递，不依赖调用对象上的状态，可在多个任务中使用同一电机/控制器。
+ */
+struct BusResult {
+    BusError error = BusError::NONE;
+
+    constexpr BusResult(BusError e = BusError::NONE) : error(e) {}
+
+    constexpr bool ok() const { return error == BusError::NONE; }
+    constexpr explicit operator bool() const { return ok(); }
+
+    // 合并另一事务的结果：保留第一个错误
+    void merge(BusError other) {
+        if (error == BusError::NONE) {
+            error = other;
+        }
+    }
+};
+
+// 该错误是否可通过重发解决（应答丢失或损坏）
+inline bool isRetryable(BusError error) {
+    return error == BusError::TIMEOUT || error == BusError::CHECKSUM || error == BusError::WRITE_FAILED;
+}
+
+struct BusTransaction;
+
+// 单个流量类别的周期预算使用情况
+struct BusSlotUsage {
+    uint32_t plannedUs = 0;         // 每周期预算（0 表示不限）
+    uint32_t avgUsedUs = 0;         // 每周期平均实际占用
+    uint32_t maxUsedUs = 0;         // 单周期最大实际占用
+    uint32_t transactions = 0;      // 已执行的队列项数（突发计为一项，重发另计）
+    uint32_t overrunCycles = 0;     // 实际占用超过预算的周期数（超出部分从下一周期预算中扣除）
+    uint32_t deferrals = 0;         // 有事务因预算耗尽顺延到下一周期的周期数
+};
+
+// 周期预算报告：计划与实际的时隙占用对比
+struct BusScheduleReport {
+    uint32_t periodUs = 0;          // 控制周期，0 表示未启用周期预算
+    uint32_t cycles = 0;            // 统计窗口内经过的周期数
+    BusSlotUsage slots[static_cast<size_t>(BusClass::COUNT)];
+};
+
+// 事务统计报告（自上次清零起）
+struct BusStatsReport {
+    uint32_t windowMs = 0;                      // 统计时长
+    float utilisation = 0.0f;                   // 总线占用率（%）：收发及等待应答时间 / 统计时长
+    uint32_t droppedRecords = 0;                // 统计表已满而未计入的事务数
+    BusScheduleReport schedule;                 // 周期预算使用情况
+    size_t entryCount = 0;
+    BusStatsSummary entries[BusStats::MAX_ENTRIES];
+};
+
+// 链路统计（自总线创建起累计，供速率协商与监测使用）
+struct LinkStats {
+    uint32_t txBytes = 0;           // 已发送字节数
+    uint32_t rxBytes = 0;           // 已接收字节数
+    uint32_t attempts = 0;          // 等待应答的发送次数（含重发）
+    uint32_t timeouts = 0;          // 其中超时的次数
+    uint32_t checksumErrors = 0;    // 其中只收到校验失败候选帧的次数
+};
+
+// 事务完成回调（在总线任务上下文中执行，应尽量简短）
+typedef void (*BusCallback)(BusTransaction& tx, void* context);
+
+/**
+ * @brief 单次总线事务：一帧命令 + 可选的一帧应答
+ *
+ * 事务对象由调用者持有（通常位于栈上），提交后在完成前不得销毁或修改。
+ * 事务本身即 "future"：通过 MotorBus::wait() 等待完成，或查询 isDone()。
+ */
+struct BusTransaction {
+    Emm42::Frame request;                       // 完整命令帧
+    Emm42::Frame response;                      // 应答帧（完成后有效）
+    ChecksumType checksumType = ChecksumType::FIXED;
+    bool expectReply = true;                    // 是否等待应答
+    uint32_t deadlineUs = 5000;                 // 单次尝试的应答期限（自发送完成起，不含应答传输时间）
+    uint8_t maxRetries = 0;                     // 可重试错误的最大重发次数
+    uint32_t budgetUs = 0;                      // 含重试在内的总时间预算（自首次发送起），0 表示不限
+    BusPriority priority = BusPriority::NORMAL;
+    BusCallback onComplete = nullptr;           // 完成回调（可选）
+    void* context = nullptr;                    // 回调上下文
+
+    // 以下字段由总线维护
+    std::atomic<bool> done{false};
+    BusError error = BusError::PENDING;
+    SemaphoreHandle_t waiter = nullptr;         // 提交者任务的完成信号，完成时释放
+    uint32_t latencyUs = 0;                     // 从首次发送到完成的耗时
+    uint8_t attempts = 0;                       // 已发送次数
+    uint32_t firstSendUs = 0;                   // 首次发送时刻
+    uint32_t retryAtUs = 0;                     // 退避结束时刻（等待重试时有效）
+    BusTransaction* burstNext = nullptr;        // 同一突发中的下一事务（仅总线内部使用）
+    uint32_t linkRate = 0;                      // 非 0 表示链路速率切换事务，不发送命令帧（仅总线内部使用）
+
+    /**
+     * @brief 设置命令帧并复位事务状态，便于重复使用同一事务对象
+     */
+    void prepare(Emm42::ByteSpan frame, ChecksumType type, uint32_t deadline, uint8_t retries = 0) {
+        request.clear();
+        request.append(frame);
+        response.clear();
+        checksumType = type;
+        deadlineUs = deadline;
+        maxRetries = retries;
+        budgetUs = 0;
+        expectReply = true;
+        done.store(false);
+        error = BusError::PENDING;
+        latencyUs = 0;
+        attempts = 0;
+        linkRate = 0;
+    }
+
+    /**
+     * @brief 不经总线直接以错误结束事务（用于未提交即被拒绝的事务）
+     */
+    void fail(BusError reason) {
+        error = reason;
+        done.store(true);
+    }
+
+    uint8_t address() const { return request.length > 0 ? request.bytes[0] : 0; }
+    uint8_t funcCode() const { return request.length > 1 ? request.bytes[1] : 0; }
+    bool isDone() const { return done.load(); }
+    bool ok() const { return isDone() && error == BusError::NONE; }
+
+    // 流量类别：LOW 优先级的事务一律按诊断流量计
+    BusClass trafficClass() const {
+        return priority == BusPriority::LOW ? BusClass::DIAGNOSTIC : busClassOf(funcCode());
+    }
+};
+
+class MotorBus {
+public:
+    /**
+     * @brief 构造函数（UART 总线）
+     * @param port 总线使用的硬件串口（需由调用者先行 begin）
+     */
+    explicit MotorBus(HardwareSerial* port);
+
+    /**
+     * @brief 构造函数（任意传输层，如 TwaiTransport）
+     * @param transport 传输层（需由调用者先行 begin，生命周期不短于总线）
+     */
+    explicit MotorBus(MotorTransport* transport);
+
+    /**
+     * @brief 启动总线任务
+     *
+     * 启动前提交的事务在调用者上下文中同步执行（互斥保护）；
+     * 启动后所有事务由总线任务独占串口执行。
+     * @param taskPriority 总线任务优先级，应高于控制任务
+     * @return 启动成功返回 true
+     */
+    bool begin(UBaseType_t taskPriority = 6);
+
+    /**
+     * @brief 异步提交事务
+     * @param tx 事务对象，完成前必须保持有效
+     * @return 被接受返回 true；队列已满时事务立即以 QUEUE_FULL 完成并返回 false
+     */
+    bool submit(BusTransaction& tx);
+
+    /**
+     * @brief 按顺序批量提交事务，总线任务会背靠背地连续执行
+     * @return 全部被接受返回 true
+     */
+    bool submitAll(BusTransaction* const* txs, size_t count);
+
+    /**
+     * @brief 以突发方式提交一组事务
+     *
+     * 所有命令帧按顺序拼接后在一次串口写入中连续发出，之后统一接收应答；
+     * 各应答按地址与功能码分拣到对应事务，与到达顺序无关。
+     * 整组事务作为一个队列项调度，优先级取第一个事务的优先级。
+     * @param txs 事务数组，数量不超过 MAX_BURST
+     * @return 被接受返回 true；否则全部事务以 QUEUE_FULL 完成并返回 false
+     */
+    bool submitBurst(BusTransaction* const* txs, size_t count);
+
+    /**
+     * @brief 紧急发送事务（用于急停）
+     *
+     * 事务不进入队列：总线任务在当前帧发送完成后立即放弃正在等待的应答（被抢占的事务以 PREEMPTED 结束），
+     * 作废队列与退避列表中尚未发送的设定值类事务（停止后不应再被执行），随后发出本事务的命令帧，不等待应答。
+     * 帧发送完成时刻为 tx.firstSendUs + tx.latencyUs。
+     * @param tx 事务对象，完成前必须保持有效；expectReply 与重试次数被强制清零
+     * @return 被接受返回 true；上一个紧急事务尚未发出时以 QUEUE_FULL 结束并返回 false
+     */
+    bool preempt(BusTransaction& tx);
+
+    /**
+     * @brief 等待事务完成（future 语义）
+     * @return 事务结果
+     */
+    BusError wait(BusTransaction& tx);
+
+    /**
+     * @brief 等待一组事务全部完成
+     * @return 全部成功返回 true
+     */
+    bool waitAll(BusTransaction* const* txs, size_t count);
+
+    /**
+     * @brief 提交并等待事务完成（阻塞式）
+     * @return 事务结果
+     */
+    BusError execute(BusTransaction& tx);
+
+    /**
+     * @brief 切换链路速率（UART 波特率）
+     *
+     * 以 HIGH 优先级排队，在两次事务之间执行，不会打断正在收发的帧。
+     * 驱动器侧的速率需由调用者先行修改（StepperMotor::modifyDriverConfig）。
+     * @return 切换成功返回 true
+     */
+    bool changeBitRate(uint32_t rate);
+
+    // 当前链路速率（bit/s）
+    uint32_t bitRate() const { return transport ? transport->bitRate() : 0; }
+
+    /**
+     * @brief 事务完成首次尝试后至少还能重发一次所需的时间预算（BusTransaction::budgetUs）
+     *
+     * 两个应答窗口（应答期限 + 应答帧传输时间）加首次退避及超时判定的节拍余量；更小的预算在应答超时后总是放弃重发。
+     * @param funcCode 事务的功能码
+     * @param deadlineUs 事务的应答期限
+     */
+    uint32_t retryBudgetUs(uint8_t funcCode, uint32_t deadlineUs) const;
+
+    // 链路统计快照
+    LinkStats linkStats() const;
+
+    /**
+     * @brief 设置周期预算（时隙化控制周期）
+     *
+     * 每 periodUs 为一个周期，周期内各类流量最多占用对应预算的总线时间（收发及等待应答）；
+     * 某类预算耗尽后该类事务留在队列中，下一周期开始时再执行。最后一个事务可能超出预算，
+     * 超出部分从该类下一周期的预算中扣除；未用完的预算不结转。HIGH 优先级事务（停止、速率切换）
+     * 不受预算限制，但占用时间计入其类别。新设置在下一周期开始时生效。
+     * @param periodUs 周期长度，0 表示关闭周期预算（默认），事务按优先级与类别顺序连续执行
+     * @param setpointUs 设定值预算，0 表示不限
+     * @param telemetryUs 状态读取预算，0 表示不限
+     * @param diagnosticUs 诊断预算，0 表示不限
+     */
+    void setCycleBudget(uint32_t periodUs, uint32_t setpointUs, uint32_t telemetryUs, uint32_t diagnosticUs);
+
+    /**
+     * @brief 获取按 (地址, 功能码) 分组的事务统计及周期预算使用情况
+     * @param report 输出报告
+     * @param reset 读取后清零，开始新的统计窗口
+     */
+    void busStats(BusStatsReport& report, bool reset = false);
+
+    // 总线任务是否已启动
+    bool isRunning() const { return workerHandle != nullptr; }
+
+    // UART 总线的硬件串口；其它传输层返回 nullptr
+    HardwareSerial* serial() const { return uart.serial(); }
+
+    MotorTransport* link() const { return transport; }
+
+    // 单次突发最多包含的事务数
+    static constexpr size_t MAX_BURST = 8;
+
+private:
+    static constexpr UBaseType_t QUEUE_DEPTH = 16;
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(BusClass::COUNT);
+    // 队列：HIGH 优先级一个，其余按流量类别各一个
+    static constexpr size_t LANE_COUNT = 1 + CLASS_COUNT;
+    // 等待应答时的忙等窗口（微秒），超过后改为 vTaskDelay 让出 CPU
+    static constexpr uint32_t REPLY_SPIN_US = 2000;
+    // 重试退避：首次 500us，每次翻倍，上限 8ms
+    static constexpr uint32_t BACKOFF_BASE_US = 500;
+    static constexpr uint32_t BACKOFF_MAX_US = 8000;
+    // 同时处于退避状态的事务上限
+    static constexpr size_t MAX_DEFERRED = 16;
+
+    // 创建优先级队列与同步执行互斥
+    void createQueues();
+
+    static void workerTaskWrapper(void* param);
+    void workerLoop();
+
+    // 事务所在队列：HIGH 优先级为 0，其余为 1 + 流量类别
+    static size_t laneOf(const BusTransaction& tx);
+
+    // 取出下一个待执行事务：按队列顺序，同一队列中到期的重试优先于新事务；跳过预算已耗尽的类别
+    BusTransaction* nextTransaction();
+
+    // 距最近一个重试到期或预算恢复的时间（微秒），没有可等待的事务返回 false
+    bool nextRetryDelay(uint32_t& delayUs) const;
+
+    // 推进周期：跨过周期边界时结算上一周期并恢复各类预算
+    void advanceCycle(uint32_t nowUs);
+
+    // 该类别在当前周期是否还有预算
+    bool hasBudget(size_t cls) const;
+
+    // 该类别是否有事务因预算耗尽而等待（队列或退避列表中）
+    bool hasWaiting(size_t cls) const;
+
+    // 发出紧急事务：作废尚未发送的设定值，再立即执行
+    void sendUrgent(BusTransaction& tx);
+
+    // 作废 HIGH 与设定值队列、退避列表中的设定值类事务（其它事务保持原有顺序）
+    void dropSetpoints();
+
+    // 以错误结束事务及其所在突发的后续事务
+    void failChain(BusTransaction& head, BusError error);
+
+    // 是否在总线任务上下文中
+    bool inWorker() const { return workerHandle && xTaskGetCurrentTaskHandle() == workerHandle; }
+
+    // 等待应答时让出 CPU 一个节拍；总线任务中可被紧急事务提前唤醒
+    void yieldTick();
+
+    // 在当前上下文中执行一次完整事务（总线任务中失败的事务转入退避，不在此等待）
+    void process(BusTransaction& tx);
+
+    // 执行一次发送与接收，返回本次尝试的结果
+    BusError attempt(BusTransaction& tx);
+
+    // 本次尝试失败后：预算允许则安排重试并返回 true，否则返回 false
+    bool scheduleRetry(BusTransaction& tx, BusError error);
+
+    // 应答帧在链路上的传输时间
+    uint32_t replyWireUs(const BusTransaction& tx) const;
+    uint32_t replyWireUs(uint8_t funcCode) const;
+
+    // 应答期限：功能码期限 + 应答帧传输时间
+    uint32_t replyWindowUs(const BusTransaction& tx) const;
+
+    // 将完整应答归类为成功 / E2 拒绝 / 命令错误
+    static BusError classify(const Emm42::ResponseParser& parser, uint8_t funcCode);
+
+    // 在当前上下文中执行一次突发：一次写出全部命令帧，再分拣应答
+    void processBurst(BusTransaction& head);
+
+    // 执行队列项：单个事务或以 head 开头的突发
+    void dispatch(BusTransaction& tx);
+
+    // 累计一次等待应答的尝试结果
+    void recordAttempt(BusError error);
+
+    // 将已完成的事务计入事务统计
+    void recordStats(const BusTransaction& tx, BusError error);
+
+    // 标记完成、执行回调并唤醒等待者
+    void complete(BusTransaction& tx, BusError error);
+
+    UartTransport uart;                      // 以串口构造时使用的 UART 传输层
+    MotorTransport* transport;
+    QueueHandle_t queues[LANE_COUNT] = {};
+    SemaphoreHandle_t portMutex = nullptr;   // 总线任务启动前的同步执行互斥
+    TaskHandle_t workerHandle = nullptr;
+    BusTransaction* deferred[MAX_DEFERRED] = {};   // 处于退避状态的事务（仅总线任务访问）
+    std::atomic<BusTransaction*> urgent{nullptr};  // 待发送的紧急事务
+
+    // 链路统计（总线任务写入，其它任务读取）
+    std::atomic<uint32_t> txBytes{0};
+    std::atomic<uint32_t> rxBytes{0};
+    std::atomic<uint32_t> replyAttempts{0};
+    std::atomic<uint32_t> replyTimeouts{0};
+    std::atomic<uint32_t> replyChecksumErrors{0};
+
+    // 事务统计（statsMutex 保护）
+    BusStats stats;
+    SemaphoreHandle_t statsMutex = nullptr;
+    uint32_t statsSinceMs = 0;
+    std::atomic<uint32_t> busyUs{0};            // 自统计开始起总线被占用的时间
+
+    // 周期预算配置（statsMutex 保护，总线任务在周期边界处读取）
+    uint32_t budgetPeriodUs = 0;
+    uint32_t budgetUs[CLASS_COUNT] = {};
+    std::atomic<bool> budgetChanged{false};
+
+    // 当前周期状态（仅执行事务的上下文访问）
+    uint32_t cyclePeriodUs = 0;                 // 当前生效的周期长度
+    uint32_t cycleBudgetUs[CLASS_COUNT] = {};   // 当前生效的各类预算
+    uint32_t cycleStartUs = 0;
+    int32_t creditUs[CLASS_COUNT] = {};         // 本周期剩余预算，负数为透支
+    uint32_t cycleUsedUs[CLASS_COUNT] = {};     // 本周期实际占用
+    uint32_t cycleTransactions[CLASS_COUNT] = {};
+    bool cycleDeferred[CLASS_COUNT] = {};       // 本周期是否有事务因预算耗尽而顺延
+
+    // 周期预算统计（statsMutex 保护）
+    uint32_t scheduleCycles = 0;
+    uint64_t slotUsedUs[CLASS_COUNT] = {};
+    uint32_t slotMaxUs[CLASS_COUNT] = {};
+    uint32_t slotTransactions[CLASS_COUNT] = {};
+    uint32_t slotOverruns[CLASS_COUNT] = {};
+    uint32_t slotDeferrals[CLASS_COUNT] = {};
+};
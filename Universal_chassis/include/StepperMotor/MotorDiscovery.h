@@ -0,0 +1,99 @@
+/*
+ * @Description: 启动时电机总线自动探测与驱动器参数采集
+ *
+ * 对每条总线上的地址范围逐一读取固件版本（0x1F，应答仅 5 字节），找到在线的驱动器后读取驱动配置参数
+ * （0x42：电机类型、细分、控制命令应答设置等），生成电机表供 CarController 与运动学模型使用。
+ *  - 每个阶段先在全部总线上提交事务再统一等待，各总线的总线任务并行执行；
+ *  - 探测事务使用较短的应答期限且不重发，不在线的地址只占用一个期限；
+ *  - 以 0x6B 固定校验未应答的地址再以 XOR、CRC8 校验各试一次，识别校验方式配置不同的驱动器；
+ *  - 收到校验失败的应答通常表示同一地址上有多个驱动器（应答冲突），记入 conflicts。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+
+// 单个驱动器的探测结果
+struct MotorProfile {
+    uint8_t address = 0;                            // 驱动器地址
+    uint8_t bus = 0;                                // 所在总线序号（构造 MotorDiscovery 时的顺序）
+    ChecksumType checksumType = ChecksumType::FIXED; // 驱动器应答所用的校验方式
+    uint8_t firmwareVersion = 0;
+    uint8_t hardwareVersion = 0;
+    bool configValid = false;                       // 驱动配置参数读取成功
+    DriverConfig config{};                          // 驱动配置参数（configValid 为 true 时有效）
+
+    // 电机每圈整步数：0.9° 电机（motorType 50）为 400，其余为 200
+    uint16_t fullStepsPerRev() const { return configValid && config.motorType == 50 ? 400 : 200; }
+};
+
+// 电机表：一次探测发现的全部驱动器
+struct MotorTable {
+    static constexpr size_t MAX_MOTORS = 16;
+
+    MotorProfile motors[MAX_MOTORS];
+    size_t count = 0;
+    uint32_t conflicts = 0;         // 应答校验失败的地址数（疑似地址冲突）
+    uint32_t elapsedUs = 0;         // 探测总耗时
+
+    /**
+     * @brief 查找指定总线上的驱动器
+     * @return 未找到返回 nullptr
+     */
+    const MotorProfile* find(uint8_t address, uint8_t bus) const {
+        for (size_t i = 0; i < count; ++i) {
+            if (motors[i].address == address && motors[i].bus == bus) {
+                return &motors[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+class MotorDiscovery {
+public:
+    /**
+     * @brief 构造函数
+     * @param buses 需要探测的电机总线（总线任务须已启动）
+     * @param count 总线数量，不超过 MAX_BUSES
+     */
+    MotorDiscovery(MotorBus* const* buses, size_t count);
+
+    /**
+     * @brief 设置探测的地址范围（含两端，地址 0 为广播地址不参与探测）
+     */
+    void setAddressRange(uint8_t first, uint8_t last);
+
+    /**
+     * @brief 设置探测事务的应答期限（自发送完成起）
+     */
+    void setProbeDeadline(uint32_t deadlineUs) { probeDeadlineUs = deadlineUs; }
+
+    /**
+     * @brief 执行探测，需在控制任务开始下发命令之前调用
+     * @param table 输出电机表
+     * @return 至少发现一个驱动器且没有地址冲突返回 true
+     */
+    bool run(MotorTable& table);
+
+    static constexpr size_t MAX_BUSES = 3;
+
+private:
+    // 在全部总线上对待探测地址以 type 校验读取固件版本，应答的地址加入电机表
+    void probe(MotorTable& table, ChecksumType type, bool countConflicts);
+
+    // 读取电机表中全部驱动器的配置参数
+    void readConfigs(MotorTable& table);
+
+    // 该总线上的地址是否已在电机表中
+    static bool known(const MotorTable& table, uint8_t address, uint8_t bus);
+
+    MotorBus* buses[MAX_BUSES] = {};
+    size_t busCount = 0;
+    uint8_t firstAddr = 1;
+    uint8_t lastAddr = 8;
+    uint32_t probeDeadlineUs = 1500;
+};
@@ -0,0 +1,54 @@
+/*
+ * @Description: 电机总线传输层接口
+ *
+ * MotorBus 与传输层之间只交换串口格式的 Emm42 帧（地址 + 功能码 + 数据 + 校验），
+ * 物理链路的差异由传输层屏蔽：
+ *  - UartTransport：帧按字节流直接写出（UartTransport.h）
+ *  - CanTransport：按 Emm42 CAN 格式分包发送，应答按地址重组后还原为字节流（CanTransport.h）
+ *
+ * 本文件不依赖 Arduino/FreeRTOS，可在主机上直接编译。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "StepperMotor/Emm42Frame.h"
+
+class MotorTransport {
+public:
+    virtual ~MotorTransport() = default;
+
+    // 单次 writeFrames() 最多包含的帧数（与 MotorBus::MAX_BURST 一致）
+    static constexpr size_t MAX_WRITE_FRAMES = 8;
+
+    /**
+     * @brief 发送一组命令帧，返回时全部帧已发送完成
+     *
+     * 多帧应尽可能连续发出：UART 拼接为一次写入，CAN 连续排入发送队列。
+     * @param frames 串口格式的命令帧，数量不超过 MAX_WRITE_FRAMES
+     * @return 全部发送成功返回 true
+     */
+    virtual bool writeFrames(const Emm42::ByteSpan* frames, size_t count) = 0;
+
+    // 可读取的应答字节数（串口格式）
+    virtual int available() = 0;
+
+    // 读取一个应答字节，无数据返回 -1
+    virtual int read() = 0;
+
+    /**
+     * @brief 一帧应答在链路上的传输时间（微秒），用于计算应答期限
+     * @param frameLen 串口格式的应答帧长度（含地址与校验字节）
+     */
+    virtual uint32_t replyWireUs(size_t frameLen) const = 0;
+
+    /**
+     * @brief 运行期切换链路速率（UART 波特率），并丢弃接收缓冲中的残留数据
+     * @return 链路不支持切换时返回 false
+     */
+    virtual bool setBitRate(uint32_t rate) { (void)rate; return false; }
+
+    // 当前链路速率（bit/s），未知返回 0
+    virtual uint32_t bitRate() const { return 0; }
+};
@@ -2,7 +2,8 @@
 
 #include <cstdint>
 #include <vector>
-#include "HardwareSerial.h"   // ESP32平台的串口对象头文件
+#include "StepperMotor/Emm42Frame.h"
+#include "StepperMotor/MotorBus.h"
 
 /**
  * @brief 步进电机控制类
@@ -14,32 +15,34 @@
  * 项目基于 ESP32 PIO 框架开发，适用于嵌入式环境。
  */
 
-// 定义校验方式枚举，明确校验类型
-enum class ChecksumType {
-    FIXED,  // 固定校验，默认使用 0x6B
-    XOR, 
-    CRC8
+// 控制命令应答设置（DriverConfig::cmdResponse）
+enum class CommandResponse : uint8_t {
+    NONE = 0,       // 控制命令不应答
+    RECEIVE = 1,    // 收到命令即应答
+    REACHED = 2,    // 位置到达时应答
+    BOTH = 3,       // 收到与到达均应答
+    OTHER = 4       // 其它
 };
 
 // 驱动配置参数结构体封装
-// 注意：返回的命令包含 21 个配置参数，其中包括通讯校验方式（固定为 0x6B）
+// 应答共 33 字节：地址 + 0x42 + 字节数(0x21) + 参数个数(0x15) + 21 个参数（28 字节）+ 校验
 struct DriverConfig {
     uint8_t motorType;                     // 电机类型: 25表示1.8°电机, 50表示0.9°电机
     uint8_t pulseControlMode;              // 脉冲端口控制模式，如 PUL_FOC
     uint8_t commPortMode;                  // 通讯端口复用模式，如 UART_FUN
     uint8_t enPinEffectiveLevel;           // En引脚的有效电平
     uint8_t dirPinEffectiveDirection;      // Dir引脚的有效方向
-    uint16_t subdivision;                  // 细分值，0x00 表示256，其它表示对应数值
+    uint16_t subdivision;                  // 细分值（1-256，协议中 0x00 表示256）
     bool subdivisionInterpolation;         // 细分插补功能是否使能
     bool autoSleep;                        // 自动熄屏功能状态
     uint16_t openLoopCurrent;              // 开环模式工作电流 (mA)
     uint16_t closedLoopMaxCurrent;         // 闭环模式堵转时的最大电流 (mA)
     uint16_t maxOutputVoltage;             // 闭环模式最大输出电压 (mV)
-    uint32_t serialBaudRate;               // 串口波特率
-    uint32_t canCommRate;                  // CAN通讯速率
+    uint32_t serialBaudRate;               // 串口波特率 (bps)
+    uint32_t canCommRate;                  // CAN通讯速率 (bps)
     uint8_t id;                            // 电机ID地址
-    uint8_t commChecksum;                  // 通讯校验方式（固定为0x6B）
-    uint8_t cmdResponse;                   // 控制命令应答设置（只回复确认收到命令）
+    uint8_t commChecksum;                  // 通讯校验方式：0-0x6B, 1-XOR, 2-CRC8, 3-Modbus
+    CommandResponse cmdResponse;           // 控制命令应答设置
     bool stallProtectionEnabled;           // 堵转保护功能是否启用
     uint16_t stallThresholdSpeed;          // 堵转保护转速阈值 (RPM)
     uint16_t stallThresholdCurrent;        // 堵转保护电流阈值 (mA)
@@ -47,8 +50,26 @@ struct DriverConfig {
     float positionArrivalWindow;           // 位置到达窗口 (角度)
 };
 
+// 电机通讯健康状态（熔断器）
+enum class MotorHealth : uint8_t {
+    HEALTHY = 0,    // 正常：按配置重发
+    DEGRADED,       // 最近有通讯失败：不再重发，避免占用总线
+    OPEN            // 连续失败达到阈值：停止访问，仅按低频探测恢复
+};
+
+// 健康状态名称，用于日志与遥测
+const char* motorHealthName(MotorHealth health);
+
+// 免应答模式下速度设定值的送达验证结果
+enum class SetpointCheck : uint8_t {
+    NONE = 0,       // 没有待验证的设定值
+    CONFIRMED,      // 实测转速已达到或正朝设定值变化，确认送达
+    PENDING,        // 仍在宽限时间内，暂无法判断
+    LOST            // 超过宽限时间转速仍未变化，判定设定值丢失
+};
+
 // 系统状态参数结构体封装
-// 根据协议，返回的数据包含 9 个参数，其中将状态标志拆分为就绪状态和电机状态
+// 应答共 31 字节：地址 + 0x43 + 字节数(0x1F) + 参数个数(0x09) + 9 个参数 + 校验，其中状态标志拆分为就绪状态和电机状态
 struct SystemStatus {
     uint16_t busVoltage;                 // 总线电压 (mV)
     uint16_t phaseCurrent;               // 总线相电流 (mA)
@@ -66,19 +87,91 @@ public:
     /**
      * @brief 构造函数
      * @param motorAddr 电机地址，范围 1-255（0 表示广播地址）
-     * @param serial ESP32硬件串口对象，用于后续串口通讯
+     * @param bus 电机所在的总线调度器，同一串口上的所有电机共享一个 MotorBus
      * @param checksumType 校验方式，默认使用固定校验（FIXED，校验字节为 0x6B）
-     * @param timeout_ms 超时等待回复的时间（毫秒），默认100ms
+     * @param timeout_ms 单次尝试的应答期限（毫秒）；默认 0 表示按功能码取期限（确认应答 3ms，读取 5ms）
+     */
+    StepperMotor(uint8_t motorAddr, MotorBus* bus, ChecksumType checksumType = ChecksumType::FIXED, uint32_t timeout_ms = 0);
+
+    // 电机地址
+    uint8_t address() const { return motorAddr; }
+
+    // 电机所在总线
+    MotorBus* bus() const { return motorBus; }
+
+    /**
+     * @brief 设置应答丢失或损坏时的最大重发次数（默认 2）
+     *
+     * 重发由总线任务按指数退避安排，退避期间总线继续执行其它电机的事务。
+     * 相对位置运动与同步触发命令不重发。
+     */
+    void setRetryLimit(uint8_t retries) { retryLimit = retries; }
+
+    /**
+     * @brief 设置单次调用（含重发）的总时间预算（微秒），0 表示不限
+     *
+     * 预算不足以完成下一次尝试时不再重发，直接返回最近一次的错误。
      */
-    StepperMotor(uint8_t motorAddr, HardwareSerial* serial, ChecksumType checksumType = ChecksumType::FIXED, uint32_t timeout_ms = 100);
+    void setCallBudget(uint32_t budgetUs) { callBudgetUs = budgetUs; }
+
+    // 功能码为 funcCode 的调用在应答超时后至少还能重发一次所需的预算（见 MotorBus::retryBudgetUs）
+    uint32_t retryBudgetUs(uint8_t funcCode) const;
+
+    /**
+     * @brief 设置广播电机（地址 0）所在总线上是否有地址 1 的驱动器代为应答（默认有）
+     *
+     * 没有应答者时广播控制命令（使能、停止、同步触发等）发送完成即结束，不再等待应答期限；
+     * 地址 0 的读取命令在该总线上无法使用。
+     */
+    void setBroadcastReplies(bool replies) { broadcastReplies = replies; }
+    bool hasBroadcastReplies() const { return broadcastReplies; }
+
+/*********************************************************熔断器*********************************************************/
+    // 当前通讯健康状态
+    MotorHealth health() const { return healthState; }
+
+    /**
+     * @brief 配置熔断器
+     * @param tripThreshold 连续通讯失败多少次后熔断（OPEN），默认 3
+     * @param probeIntervalMs 熔断后探测间隔（毫秒），默认 500
+     */
+    void configureBreaker(uint8_t tripThreshold, uint32_t probeIntervalMs);
+
+    /**
+     * @brief 将电机标记为不在线：熔断器直接进入 OPEN，此后仅按探测间隔尝试恢复
+     *
+     * 用于启动探测未发现该驱动器时，避免首个控制命令等待应答超时。
+     */
+    void markAbsent();
+
+    /**
+     * @brief 判断事务是否允许上总线
+     *
+     * OPEN 状态下除到期的探测事务外，事务直接以 BusError::CIRCUIT_OPEN 结束且不占用总线；
+     * DEGRADED 状态及探测事务不重发。广播地址（0）不受熔断器限制。
+     * @return 允许发送返回 true
+     */
+    bool admit(BusTransaction& tx);
+
+    /**
+     * @brief 经熔断器检查后异步提交事务
+     * @return 已提交返回 true；被熔断器拒绝或队列已满返回 false（事务已结束）
+     */
+    bool submit(BusTransaction& tx);
+
+    /**
+     * @brief 等待本电机的事务完成，并据结果更新健康状态
+     * @return 事务结果
+     */
+    BusError await(BusTransaction& tx);
 
     /**
      * @brief 电机使能控制
      * @param enable true 表示使能电机，false 表示关闭电机
      * @param sync 多机同步标志，true 表示等待同步启动
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool enableMotor(bool enable, bool sync = false);
+    BusResult enableMotor(bool enable, bool sync = false);
 
     /**
      * @brief 速度模式控制
@@ -86,9 +179,9 @@ public:
      * @param speedRpm 转速（RPM，每分钟转数）
      * @param accelerateLevel 加速度档位（0 表示不使用曲线加减速，其它值代表档位级别）
      * @param sync 多机同步标志
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool setSpeedMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync = false);
+    BusResult setSpeedMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync = false);
 
     /**
      * @brief 位置模式控制
@@ -98,24 +191,211 @@ public:
      * @param pulse 脉冲数，表示电机转动的脉冲数量
      * @param absolute 模式标志：true 表示绝对位置模式，false 表示相对位置模式
      * @param sync 多机同步标志
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool setPositionMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, uint32_t pulse, bool absolute, bool sync = false);
+    BusResult setPositionMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, uint32_t pulse, bool absolute, bool sync = false);
 
     /**
      * @brief 立即停止命令
      * @param sync 多机同步标志
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool stopMotor(bool sync = false);
+    BusResult stopMotor(bool sync = false);
 
     /**
      * @brief 多机同步运动命令
      * 该命令用于触发所有处于同步状态的电机同时运动。
      * 命令格式：地址 + 0xFF + 0x66 + 校验字节
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
+     */
+    BusResult syncMove();
+
+/*********************************************************异步事务接口*********************************************************/
+    /**
+     * @brief 构造电机使能控制命令事务（不提交），参数同 enableMotor
+     */
+    void prepareEnable(BusTransaction& tx, bool enable, bool sync = false) const;
+
+    /**
+     * @brief 构造速度模式命令事务（不提交），参数同 setSpeedMode
+     *
+     * 用于上层将多个电机的命令批量提交到 MotorBus，由总线任务背靠背执行。
+     */
+    void prepareSpeedMode(BusTransaction& tx, uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync = false);
+
+    /**
+     * @brief 构造位置模式命令事务（不提交），参数同 setPositionMode
+     */
+    void preparePositionMode(BusTransaction& tx, uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel,
+                             uint32_t pulse, bool absolute, bool sync = false);
+
+    /**
+     * @brief 构造立即停止命令事务（不提交，优先级为 HIGH），并放弃待验证的速度设定值
+     */
+    void prepareStop(BusTransaction& tx, bool sync = false);
+
+    /**
+     * @brief 只构造立即停止命令事务，不修改本对象的状态，可在其它任务中调用（紧急停止）
      */
-    bool syncMove();
+    void prepareStopCommand(BusTransaction& tx, bool sync = false) const;
+
+    /**
+     * @brief 构造多机同步运动命令事务（不提交）
+     */
+    void prepareSyncMove(BusTransaction& tx) const;
+
+    /**
+     * @brief 构造读取实时转速事务（不提交）
+     */
+    void prepareReadRealTimeSpeed(BusTransaction& tx) const;
+
+    /**
+     * @brief 构造读取实时位置事务（不提交）
+     */
+    void prepareReadRealTimePosition(BusTransaction& tx) const;
+
+    /**
+     * @brief 同步启动突发：一次串口写入下发一组带同步标志的命令，并紧跟本电机的同步触发命令
+     *
+     * txs 中的命令应以 sync = true 构造，电机收到后缓存命令而不动作；
+     * 本电机（通常为广播地址 0）的 0xFF 0x66 同步命令追加在同一次写入末尾，
+     * 所有电机在同一时刻收到触发帧并同时启动。应答在写入完成后统一收集，
+     * 调用者通过 bus()->wait() 等待 txs 与 syncTx 完成。
+     * @param txs 已构造的命令事务，数量不超过 MotorBus::MAX_BURST - 1，且须与本电机同一总线
+     * @param syncTx 用于同步触发命令的事务对象
+     * @return 被总线接受返回 true
+     */
+    bool submitSyncBurst(BusTransaction* const* txs, size_t count, BusTransaction& syncTx);
+
+    /**
+     * @brief 检查已完成的控制命令事务是否收到成功应答
+     * @return 收到 "地址 + 功能码 + 0x02 + 校验" 返回 true；免应答事务发送成功即返回 true
+     */
+    bool checkAck(const BusTransaction& tx) const;
+
+    /**
+     * @brief 已完成的控制命令事务的结果
+     * @return 成功应答返回 NONE；否则为总线错误，应答不符为 BAD_REPLY
+     */
+    BusError ackError(const BusTransaction& tx) const;
+
+    /**
+     * @brief 已完成事务校验或解析失败的原因
+     * @return 事务本身失败时为其总线错误，否则为 BAD_REPLY（应答地址、功能码、长度或内容不符）
+     */
+    BusError failureOf(const BusTransaction& tx) const;
+
+    /**
+     * @brief 解析已完成的读取实时转速事务
+     * @param speed 输出实时转速，单位 RPM
+     * @return 应答合法返回 true
+     */
+    bool parseRealTimeSpeed(const BusTransaction& tx, int16_t& speed) const;
+
+    /**
+     * @brief 构造读取系统状态参数事务（不提交）
+     *
+     * 一帧应答同时包含电压、相电流、编码器、目标/实时位置、转速、位置误差与状态标志，
+     * 用于以一次事务获取单个车轮的全部遥测数据。
+     */
+    void prepareReadSystemStatus(BusTransaction& tx) const;
+
+    /**
+     * @brief 解析已完成的读取系统状态参数事务
+     * @param status 输出系统状态参数
+     * @return 应答合法返回 true
+     */
+    bool parseSystemStatus(const BusTransaction& tx, SystemStatus& status) const;
+
+    /**
+     * @brief 构造读取固件版本事务（不提交）
+     */
+    void prepareReadFirmwareVersion(BusTransaction& tx) const;
+
+    /**
+     * @brief 解析已完成的读取固件版本事务
+     */
+    bool parseFirmwareVersion(const BusTransaction& tx, uint8_t& firmware, uint8_t& hardware) const;
+
+    /**
+     * @brief 构造读取驱动配置参数事务（不提交）
+     */
+    void prepareReadDriverConfig(BusTransaction& tx) const;
+
+    /**
+     * @brief 解析已完成的读取驱动配置参数事务
+     */
+    bool parseDriverConfig(const BusTransaction& tx, DriverConfig& config) const;
+
+    /**
+     * @brief 解析已完成的读取实时位置事务
+     * @param position 输出实时位置（一圈 65536）
+     * @return 应答合法返回 true
+     */
+    bool parseRealTimePosition(const BusTransaction& tx, int32_t& position) const;
+
+/*********************************************************免应答模式*********************************************************/
+    /**
+     * @brief 启用/关闭免应答（fire-and-forget）控制命令模式
+     *
+     * 启用前先读取驱动配置，仅当驱动器的控制命令应答设置为 CommandResponse::NONE 时才启用；
+     * 启用后控制命令（使能、速度、位置、停止、同步）发送完成即结束，不再等待应答，
+     * 速度设定值的送达由下一次遥测读取通过 verifySpeedSetpoint() 验证。
+     * 读取与修改参数命令不受影响，仍等待应答。
+     * @param enable true 启用，false 关闭
+     * @return 模式切换成功为 true；驱动器仍会应答控制命令时启用失败（REJECTED），读取配置失败时为其错误
+     */
+    BusResult enableUnacknowledgedMode(bool enable);
+
+    /**
+     * @brief 修改驱动器的控制命令应答设置（读取-修改-写回驱动配置）
+     *
+     * 修改成功后本对象的免应答模式随之切换（NONE 为免应答）。
+     * @param mode 应答设置
+     * @param store true 表示存储修改
+     * @return 成功为 true，失败时 error 给出原因
+     */
+    BusResult setCommandResponse(CommandResponse mode, bool store);
+
+    // 是否处于免应答模式
+    bool isUnacknowledged() const { return unacknowledged; }
+
+    /**
+     * @brief 按已知的驱动器应答设置切换本地模式（不与驱动器通讯，用于启动时应用探测结果）
+     */
+    void assumeCommandResponse(CommandResponse mode);
+
+    // 通讯校验方式
+    ChecksumType getChecksumType() const { return checksumType; }
+    void setChecksumType(ChecksumType type) { checksumType = type; }
+
+    /**
+     * @brief 用实测转速验证最近一次免应答速度设定值是否送达
+     *
+     * 实测转速达到设定值，或相对下发时的转速明显朝设定值变化，即视为送达；
+     * 超过按加速度档位估算的宽限时间仍无变化则判定丢失，调用者可用 resendSpeedSetpoint() 重发。
+     * 按方向换算为带符号的设定值后与带符号的实测转速比较，转向相反时不算达到。
+     * @param measuredRpm 本次遥测读取的实时转速（带符号，方向 1 为负）
+     */
+    SetpointCheck verifySpeedSetpoint(int16_t measuredRpm);
+
+    /**
+     * @brief 重新下发最近一次未确认的速度设定值（不带同步标志，立即生效）
+     * @return 发送成功（或没有待重发的设定值）为 true，失败时 error 给出原因
+     */
+    BusResult resendSpeedSetpoint();
+
+    /**
+     * @brief 构造重发最近一次未确认速度设定值的事务（不提交），供调用者自行决定是否提交
+     * @return 没有待验证的设定值返回 false
+     */
+    bool prepareResendSpeedSetpoint(BusTransaction& tx);
+
+    // 放弃待验证的速度设定值（如紧急停止后，旧的设定值不应再被重发）
+    void discardSpeedSetpoint() { pendingSpeed.active = false; }
+
+    // 免应答模式下判定丢失的设定值累计次数
+    uint32_t lostSetpointCount() const { return lostSetpoints; }
 
 /*********************************************************读取电机参数*********************************************************/
     /**
@@ -124,9 +404,9 @@ public:
      * 返回格式：地址 + 0x1F + 固件版本号 + 硬件版本号 + 校验字节
      * @param firmware 输出固件版本号
      * @param hardware 输出硬件版本号
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readFirmwareVersion(uint8_t &firmware, uint8_t &hardware);
+    BusResult readFirmwareVersion(uint8_t &firmware, uint8_t &hardware);
 
     /**
      * @brief 读取相电阻和相电感
@@ -134,9 +414,9 @@ public:
      * 返回格式：地址 + 0x20 + 相电阻（2字节）+ 相电感（2字节）+ 校验字节
      * @param resistance 输出相电阻，单位 mΩ
      * @param inductance 输出相电感，单位 uH
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readPhaseResistanceInductance(uint16_t &resistance, uint16_t &inductance);
+    BusResult readPhaseResistanceInductance(uint16_t &resistance, uint16_t &inductance);
 
     /**
      * @brief 读取位置环 PID 参数
@@ -145,147 +425,150 @@ public:
      * @param Kp 输出比例参数
      * @param Ki 输出积分参数
      * @param Kd 输出微分参数
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readPIDParameters(uint32_t &Kp, uint32_t &Ki, uint32_t &Kd);
+    BusResult readPIDParameters(uint32_t &Kp, uint32_t &Ki, uint32_t &Kd);
 
     /**
      * @brief 读取总线电压
      * 命令格式：地址 + 0x24 + 校验字节
      * 返回格式：地址 + 0x24 + 总线电压（2字节）+ 校验字节
      * @param voltage 输出总线电压，单位 mV
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readBusVoltage(uint16_t &voltage);
+    BusResult readBusVoltage(uint16_t &voltage);
 
     /**
      * @brief 读取相电流
      * 命令格式：地址 + 0x27 + 校验字节
      * 返回格式：地址 + 0x27 + 总线相电流（2字节）+ 校验字节
      * @param current 输出相电流，单位 mA
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readPhaseCurrent(uint16_t &current);
+    BusResult readPhaseCurrent(uint16_t &current);
 
     /**
      * @brief 读取经过线性化校准后的编码器值
      * 命令格式：地址 + 0x31 + 校验字节
      * 返回格式：地址 + 0x31 + 编码器值（2字节）+ 校验字节
      * @param encoder 输出经校准后的编码器值
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readCalibratedEncoder(uint16_t &encoder);
+    BusResult readCalibratedEncoder(uint16_t &encoder);
 
     /**
      * @brief 读取输入脉冲数
      * 命令格式：地址 + 0x32 + 校验字节
      * 返回格式：地址 + 0x32 + 符号（1字节）+ 输入脉冲数（4字节）+ 校验字节
      * @param pulse 输出脉冲数（负数代表负值）
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readInputPulse(int32_t &pulse);
+    BusResult readInputPulse(int32_t &pulse);
 
     /**
      * @brief 读取电机目标位置
      * 命令格式：地址 + 0x33 + 校验字节
      * 返回格式：地址 + 0x33 + 符号（1字节）+ 目标位置（4字节）+ 校验字节
      * @param position 输出电机目标位置（单位为内码值）
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readTargetPosition(int32_t &position);
+    BusResult readTargetPosition(int32_t &position);
 
     /**
      * @brief 读取实时设定目标位置（开环模式实时位置）
+     * 命令格式：地址 + 0x34 + 校验字节
+     * 返回格式：地址 + 0x34 + 符号（1字节）+ 实时目标位置（4字节）+ 校验字节
      * @param position 传出电机实时目标位置
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readRealTimeTargetPosition(int32_t &position);
+    BusResult readRealTimeTargetPosition(int32_t &position);
 
     /**
      * @brief 读取电机实时转速
      * 命令格式：地址 + 0x35 + 校验字节
      * 返回格式：地址 + 0x35 + 符号（1字节）+ 转速（2字节）+ 校验字节
      * @param speed 输出实时转速，单位 RPM
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readRealTimeSpeed(int16_t &speed);
+    BusResult readRealTimeSpeed(int16_t &speed);
 
     /**
      * @brief 读取电机实时位置
      * 命令格式：地址 + 0x36 + 校验字节
      * 返回格式：地址 + 0x36 + 符号（1字节）+ 实时位置（4字节）+ 校验字节
      * @param position 输出实时位置（单位为内码值）
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readRealTimePosition(int32_t &position);
+    BusResult readRealTimePosition(int32_t &position);
 
     /**
      * @brief 读取电机位置误差
      * 命令格式：地址 + 0x37 + 校验字节
      * 返回格式：地址 + 0x37 + 符号（1字节）+ 位置误差（4字节）+ 校验字节
      * @param error 输出位置误差值（单位为内码值）
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readPositionError(int32_t &error);
+    BusResult readPositionError(int32_t &error);
 
     /**
      * @brief 读取电机状态标志位
      * 命令格式：地址 + 0x3A + 校验字节
      * 返回格式：地址 + 0x3A + 状态字节 + 校验字节
      * @param status 输出状态标志字节
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readMotorStatus(uint8_t &status);
+    BusResult readMotorStatus(uint8_t &status);
 
     /**
      * @brief 读取驱动配置参数
      * 命令格式：地址 + 0x42 + 0x6C + 校验字节
      * 返回格式：33字节数据，详细参数参见协议说明
      * @param config 输出驱动配置参数结构体
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readDriverConfig(DriverConfig &config);
+    BusResult readDriverConfig(DriverConfig &config);
 
     /**
      * @brief 读取系统状态参数
      * 命令格式：地址 + 0x43 + 0x7A + 校验字节
-     * 返回格式：31字节数据，详细参数参见协议说明
+     * 返回格式：地址 + 0x43 + 0x1F + 0x09 + 电压(2) + 相电流(2) + 编码器(2) + 目标位置(符号+4)
+     *           + 实时转速(符号+2) + 实时位置(符号+4) + 位置误差(符号+4) + 就绪标志 + 电机标志 + 校验字节
      * @param status 输出系统状态参数结构体
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool readSystemStatus(SystemStatus &status);
+    BusResult readSystemStatus(SystemStatus &status);
 /***************************************************** 修改电机参数 *****************************************************/
     /**
      * @brief 修改任意细分设置
      * @param subdivision 细分值，0x00 表示 256 细分，其它值表示对应细分数
      * @param store true 表示将修改存储到芯片中，false 表示仅临时修改
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifySubdivision(uint8_t subdivision, bool store);
+    BusResult modifySubdivision(uint8_t subdivision, bool store);
 
     /**
      * @brief 修改电机 ID 地址
      * @param newID 新的电机地址，范围 1-255
      * @param store true 表示将修改存储到芯片中
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifyMotorID(uint8_t newID, bool store);
+    BusResult modifyMotorID(uint8_t newID, bool store);
 
     /**
      * @brief 切换开环/闭环模式
      * @param mode 0 表示开环模式，1 表示闭环模式
      * @param store true 表示存储修改
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool switchControlMode(uint8_t mode, bool store);
+    BusResult switchControlMode(uint8_t mode, bool store);
 
     /**
      * @brief 修改开环模式工作电流
      * @param current 开环工作电流，单位 Ma
      * @param store true 表示存储修改，false 表示不保存
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifyOpenLoopCurrent(uint16_t current, bool store);
+    BusResult modifyOpenLoopCurrent(uint16_t current, bool store);
 
     /**
      * @brief 修改驱动配置参数
@@ -293,9 +576,17 @@ public:
      * 传入的参数数据需按照协议格式排列，具体格式请参照通讯协议说明。
      * @param configData 驱动配置参数数据
      * @param store true 表示存储修改
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
+     */
+    BusResult modifyDriverConfig(const std::vector<uint8_t>& configData, bool store);
+
+    /**
+     * @brief 修改驱动配置参数（按 readDriverConfig 得到的结构体写回）
+     * @param config 驱动配置参数
+     * @param store true 表示存储修改
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifyDriverConfig(const std::vector<uint8_t>& configData, bool store);
+    BusResult modifyDriverConfig(const DriverConfig& config, bool store);
 
     /**
      * @brief 修改位置环 PID 参数
@@ -303,9 +594,9 @@ public:
      * @param Ki 新的积分系数
      * @param Kd 新的微分系数
      * @param store true 表示存储配置，false 表示临时修改
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifyPIDParameters(uint32_t Kp, uint32_t Ki, uint32_t Kd, bool store);
+    BusResult modifyPIDParameters(uint32_t Kp, uint32_t Ki, uint32_t Kd, bool store);
 
     /**
      * @brief 存储一组速度模式参数
@@ -316,9 +607,9 @@ public:
      * @param accelerateLevel 加速度档位
      * @param enableEn 是否使能 En 引脚控制启停
      * @param store true 表示存储参数，false 表示不保存
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool storeSpeedModeParameters(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool enableEn, bool store);
+    BusResult storeSpeedModeParameters(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool enableEn, bool store);
 
     /**
      * @brief 修改通讯控制的输入速度缩小倍数
@@ -326,15 +617,91 @@ public:
      * 修改后，发送的速度值将缩小10倍，便于精细控制。
      * @param enable true 表示使能缩小10倍，false 表示禁用
      * @param store true 表示存储配置
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool modifyInputSpeedScaling(bool enable, bool store);
+    BusResult modifyInputSpeedScaling(bool enable, bool store);
 
 private:
     uint8_t motorAddr;          // 电机地址 ID
-    HardwareSerial* port;       // ESP32 硬件串口对象
-    uint32_t timeout_ms;        // 命令回复超时等待时间（毫秒）
+    MotorBus* motorBus;         // 总线调度器（独占串口）
+    uint32_t timeout_ms;        // 统一应答期限（毫秒），0 表示按功能码
+    uint8_t retryLimit = 2;     // 最大重发次数
+    uint32_t callBudgetUs = 0;  // 单次调用总时间预算（微秒）
+
+    // 熔断器状态
+    MotorHealth healthState = MotorHealth::HEALTHY;
+    uint8_t consecutiveFailures = 0;
+    uint8_t breakerTripThreshold = 3;
+    uint32_t breakerProbeIntervalMs = 500;
+    uint32_t lastProbeMs = 0;
+
+    // 根据事务结果更新健康状态
+    void recordOutcome(const BusTransaction& tx);
     ChecksumType checksumType;  // 校验方式类型
+    bool unacknowledged = false; // 免应答模式：控制命令不等待应答
+    bool broadcastReplies = true; // 广播命令由本总线上地址 1 的驱动器应答
+
+    // 免应答模式下最近一次待验证的速度设定值
+    struct PendingSpeedSetpoint {
+        bool active = false;
+        uint8_t direction = 0;
+        uint16_t speedRpm = 0;
+        uint8_t accelerateLevel = 0;
+        int16_t startRpm = 0;       // 下发时最近一次实测转速
+        uint32_t issuedMs = 0;      // 下发时刻
+        uint32_t graceMs = 0;       // 判定丢失前的宽限时间
+    } pendingSpeed;
+    int16_t lastMeasuredRpm = 0;    // 最近一次实测转速
+    uint32_t lostSetpoints = 0;
+
+    // 控制命令事务：免应答模式下不等待应答
+    void prepareControl(BusTransaction& tx, Emm42::ByteSpan request) const;
+
+    // 单次尝试的应答期限（微秒）
+    uint32_t deadlineFor(uint8_t funcCode) const;
+
+    // 阻塞执行事务并返回结果
+    BusError run(BusTransaction& tx);
+
+    // 记录免应答速度设定值，供 verifySpeedSetpoint() 验证
+    void recordSpeedSetpoint(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel);
+
+    /**
+     * @brief 内部函数：以本电机的校验方式与超时初始化事务
+     */
+    void prepare(BusTransaction& tx, Emm42::ByteSpan request) const;
+
+    /**
+     * @brief 内部函数：检查读取类事务应答的地址、功能码与长度
+     */
+    bool checkReply(const BusTransaction& tx) const;
+
+    /**
+     * @brief 内部函数：通过总线发送命令帧并接收应答帧（阻塞至事务完成）
+     *
+     * 命令与应答均使用栈上缓冲区，校验直接在应答缓冲区上计算，不产生堆分配。
+     * @param request 待发送的完整命令帧
+     * @param response 接收的应答帧
+     * @return 收到应答且校验通过为 true，否则为总线错误
+     */
+    BusResult transfer(Emm42::ByteSpan request, Emm42::Frame& response);
+
+    /**
+     * @brief 内部函数：发送读取命令并检查应答的地址、功能码与长度
+     * @param request 待发送的完整命令帧
+     * @param response 接收的应答帧
+     * @return 应答合法为 true；应答不符为 BAD_REPLY
+     */
+    BusResult query(Emm42::ByteSpan request, Emm42::Frame& response);
+
+    /**
+     * @brief 内部函数：发送控制/修改命令并检查是否回复 "地址 + 功能码 + 0x02 + 校验"
+     * @param request 待发送的完整命令帧
+     * @return 命令执行成功为 true，失败时 error 给出原因
+     */
+    BusResult command(Emm42::ByteSpan request);
+
+    // 以下为旧版基于 std::vector 的接口，保留为新编解码器之上的薄封装
 
     /**
      * @brief 内部函数：计算校验字节
@@ -351,9 +718,9 @@ private:
      * 将构造好的命令数据经串口发送到电机控制器，并等待接收返回的数据。
      * @param command 待发送的命令数据
      * @param response 接收的回复数据
-     * @return 成功返回 true，失败返回 false
+     * @return 成功为 true，失败时 error 给出原因
      */
-    bool sendCommand(const std::vector<uint8_t>& command, std::vector<uint8_t>& response);
+    BusResult sendCommand(const std::vector<uint8_t>& command, std::vector<uint8_t>& response);
 
     /**
      * @brief 内部函数：将 16 位整数转换为字节序列并添加到缓冲区
@@ -379,4 +746,4 @@ private:
      * @return 构造好的命令帧
      */
     std::vector<uint8_t> buildFrame(uint8_t funcCode, const std::vector<uint8_t>& payload = {});
-};
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+/*
+ * @Description: UART 传输层
+ *
+ * Emm42 帧按字节流直接在串口上收发；多帧拼接后在一次串口写入中发出。
+ */
+
+#pragma once
+
+#include "HardwareSerial.h"
+#include "StepperMotor/MotorTransport.h"
+
+class UartTransport : public MotorTransport {
+public:
+    /**
+     * @brief 构造函数
+     * @param port 硬件串口（需由调用者先行 begin）
+     */
+    explicit UartTransport(HardwareSerial* port) : port(port) {}
+
+    bool writeFrames(const Emm42::ByteSpan* frames, size_t count) override;
+    int available() override { return port ? port->available() : 0; }
+    int read() override { return port ? port->read() : -1; }
+    uint32_t replyWireUs(size_t frameLen) const override;
+    bool setBitRate(uint32_t rate) override;
+    uint32_t bitRate() const override { return port ? port->baudRate() : 0; }
+
+    HardwareSerial* serial() const { return port; }
+
+private:
+    HardwareSerial* port;
+};
@@ -20,6 +20,32 @@
 // JSON 缓冲区大小
 #define JSON_BUFFER_SIZE 256
 
+// 电机总线数：1 为全部电机共用 Serial00；2 为左右两侧车轮各用一个串口，两条总线的事务并行执行
+#ifndef MOTOR_BUS_COUNT
+#define MOTOR_BUS_COUNT 1
+#endif
+
+// 电机总线链路：0 为 UART；1 为 CAN（TWAI，四个车轮共用一条 CAN 总线，忽略 MOTOR_BUS_COUNT）
+#ifndef MOTOR_BUS_CAN
+#define MOTOR_BUS_CAN 0
+#endif
+
+// CAN 位速率（需与驱动器 canCommRate 一致）
+#define MOTOR_CAN_BITRATE 500000
+
+// 电机总线初始波特率（Emm42 出厂默认 115200），启动后由 BaudNegotiator 协商到最高可用速率
+#define MOTOR_BUS_BAUD 115200
+
+// 电机总线周期预算（微秒）：每个控制周期内设定值 / 状态读取 / 诊断三类流量各自可占用的总线时间，
+// 按 115200 bps 下四个车轮估算（设定值突发约 5 ms，四次状态读取约 11 ms）；周期为 0 时不启用
+#define MOTOR_BUS_CYCLE_US 20000
+#define MOTOR_BUS_SETPOINT_BUDGET_US 6000
+#define MOTOR_BUS_TELEMETRY_BUDGET_US 12000
+#define MOTOR_BUS_DIAGNOSTIC_BUDGET_US 2000
+
+// 控制循环频率（Hz）：每个周期执行待执行命令、按需读取状态并积分里程计；按 FreeRTOS 节拍（1 ms）取整，上限 1000
+#define CONTROL_LOOP_HZ 500
+
 // 串口接收缓冲区大小
 #define SERIAL_RX_BUFFER_SIZE 512
 
@@ -32,6 +58,11 @@
 #define WIFI_TAG "WIFI"
 #define USB_TAG "USB"
 
+// MicroROS 开关：主机全固件仿真（[env:native_firmware]）没有 micro-ROS 库，以 0 编译
+#ifndef MICROROS_ENABLED
+#define MICROROS_ENABLED 1
+#endif
+
 // MicroROS配置
 #define MICROROS_AGENT_IP "192.168.8.189"
 #define MICROROS_AGENT_PORT 8888
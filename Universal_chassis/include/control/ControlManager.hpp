@@ -1,11 +1,13 @@
 #pragma once
 
 #include "CarController/CarController.h"
+#include "StepperMotor/BusStats.h"
+#include "ParamStore/ParamStore.h"
 #include "utils/Logger.hpp"
+#include "utils/SeqLock.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
-#include "freertos/semphr.h"
+#include <atomic>
 #include <cmath>
 
 // 定义命令类型
@@ -14,7 +16,9 @@ enum class CommandType {
     MOVE,         // 移动距离
     STOP,         // 停止
     GET_STATUS,   // 获取状态   
-    RESET_ODOMETER // 重置里程计
+    RESET_ODOMETER, // 重置里程计
+    APPLY_PARAMS,  // 应用参数存储中的几何参数与默认控制参数
+    COUNT
 };
 
 // 定义里程计
@@ -27,6 +31,22 @@ typedef struct {
     float omega; // 里程计角速度
 } Odometer;
 
+// 控制循环统计（自启动或上次清零起）
+struct LoopStats {
+    uint32_t rateHz = 0;        // 循环频率（按 FreeRTOS 节拍取整后）
+    uint32_t periodUs = 0;      // 周期
+    uint32_t cycles = 0;        // 运行的周期数
+    uint32_t overruns = 0;      // 工作耗时越过下一周期起点的次数
+    uint32_t skipped = 0;       // 超时后被跳过（不补跑）的周期数
+    uint32_t commands = 0;      // 执行的命令数
+    uint32_t jitterAvgUs = 0;   // 周期抖动：相邻周期起点间隔与周期之差的绝对值（不含超时后的周期）
+    uint32_t jitterP99Us = 0;
+    uint32_t jitterMaxUs = 0;
+    uint32_t workAvgUs = 0;     // 单周期工作耗时：执行命令、状态读取、里程计积分
+    uint32_t workP99Us = 0;
+    uint32_t workMaxUs = 0;
+};
+
 // 命令结构体
 struct ControlCommand {
     CommandType type;
@@ -35,18 +55,28 @@ struct ControlCommand {
     float param3;  // omega 或 dtheta
     float param4;  // acceleration
     float param5;  // speed (仅用于MOVE命令)
-    uint16_t param6; // subdivision (仅用于MOVE命令)
+    uint16_t param6; // subdivision (仅用于MOVE命令)；STOP 命令中非 0 表示已由紧急停止路径发出
     uint32_t timestamp; // 命令时间戳，用于判断新旧
 };
 
+// 带发布序号与时间戳的状态 / 里程计快照
+using CarStateSnapshot = Snapshot<CarState>;
+using OdometerSnapshot = Snapshot<Odometer>;
+
 // 控制管理器类 - 单例模式
 class ControlManager {
 public:
     // 获取单例实例
     static ControlManager& getInstance();
 
-    // 初始化控制管理器
-    void init(CarController* controller);
+    // 初始化控制管理器；startTask 为 false 时只准备命令信箱（可接收命令），由 start() 启动控制任务
+    void init(CarController* controller, bool startTask = true);
+
+    // 启动控制任务：此前收到的命令在此时开始执行（电机总线就绪后调用）
+    void start();
+
+    // 控制任务是否已启动
+    bool isStarted() const { return controlTaskHandle != nullptr; }
 
     // 设置速度命令
     void setSpeed(float vx, float vy, float omega, float acceleration = 10.0f, uint16_t subdivision = 256);
@@ -55,21 +85,70 @@ public:
     void moveDistance(float dx, float dy, float dtheta, float acceleration = 10.0f, 
                      float speed = 1.0f, uint16_t subdivision = 256);
 
-    // 停止命令
-    void stop();
+    /**
+     * @brief 停止命令：作废此前未执行的速度/移动命令；控制任务已启动时在调用者上下文中直接紧急停止
+     *        （CarController::emergencyStop，抢占正在进行的总线事务）
+     * @param receivedUs 收到命令的时刻（micros()），0 表示以调用时刻为准
+     */
+    void stop(uint32_t receivedUs = 0);
+
+    // 紧急停止统计（延迟、确认失败次数等）
+    EStopStats getEStopStats() const;
+
+    // 设置控制循环频率（Hz），按 FreeRTOS 节拍取整，上限为节拍频率（1000 Hz），下一周期生效
+    void setLoopRate(uint32_t hz);
+
+    // 当前控制循环频率（取整后）
+    uint32_t getLoopRate() const;
+
+    // 控制循环统计（控制任务约每 100 ms 发布一次）；reset 为 true 时读取后由控制任务清零
+    LoopStats getLoopStats(bool reset = false);
     
-    // 重置里程计命令
+    // 重置里程计命令（由控制任务执行）
     void resetOdometer();
 
-    // 获取当前小车状态
-    CarState getCarState();
+    // 获取当前小车状态（最近一次发布的快照，不阻塞）
+    CarState getCarState() const;
+
+    // 获取当前小车状态及其发布序号、时刻；序号不变即没有新数据
+    CarStateSnapshot getCarStateSnapshot() const;
     
-    // 获取当前里程计数据
-    Odometer getOdometer();
+    // 获取最近一次缓存的四轮遥测（电压、电流、位置、状态标志等）
+    TelemetrySnapshot getTelemetry() const;
+
+    // 获取当前里程计数据（最近一次发布的快照，不阻塞）
+    Odometer getOdometer() const;
+
+    // 获取当前里程计数据及其发布序号、时刻
+    OdometerSnapshot getOdometerSnapshot() const;
+
+    // 电机总线数量
+    size_t getBusCount() const;
+
+    // 获取第 index 条电机总线的事务统计，reset 为 true 时读取后清零
+    bool getBusStats(size_t index, BusStatsReport& report, bool reset = false);
     
-    // 设置状态更新间隔
+    // 设置状态更新间隔（运动时的最短轮询间隔）
     void setStateUpdateInterval(uint32_t interval_ms);
 
+    // 设置静止时的状态轮询间隔
+    void setIdlePollInterval(uint32_t interval_ms) { idlePollInterval = interval_ms; }
+
+    // 当前状态轮询间隔（毫秒），随运动状态变化
+    uint32_t getPollInterval() const { return pollInterval; }
+
+    // 绑定参数存储（set_param / get_param 使用）
+    void setParamStore(ParamStore* store) { paramStore = store; }
+
+    // 修改参数：写入参数存储，由控制任务在两次运动计算之间应用；persist 为 true 时同时写入 NVS
+    bool setParam(const char* name, float value, bool persist = true);
+
+    // 读取参数存储中的参数
+    bool getParam(const char* name, float& value) const;
+
+    // 里程计积分一步：以 state 的车体速度更新 odom，dt 为积分步长（秒）
+    static void integrateOdometer(Odometer& odom, const CarState& state, float dt);
+
 private:
     // 私有构造函数，防止外部创建实例
     ControlManager() = default;
@@ -81,37 +160,100 @@ private:
     // 静态任务包装函数
     static void controlTaskWrapper(void* param);    // 统一控制任务
     
-    // 替换命令队列中的同类型命令
-    void replaceCommand(const ControlCommand& newCmd);
+    // 写入命令信箱（覆盖同类型未执行的命令）并唤醒控制任务；与其它写入者冲突时重试，不丢弃命令
+    void postCommand(const ControlCommand& cmd);
+
+    // 取出最早写入的未执行命令（仅控制任务），没有返回 false
+    bool takeCommand(ControlCommand& cmd);
+
+    // 作废控制任务启动前写入、已超过 STALE_MOTION_MS 的速度/移动命令（仅控制任务启动时调用）
+    void discardStaleMotion();
     
-    // 统一控制任务 - 处理命令、更新状态和里程计
+    // 统一控制任务 - 固定周期处理命令、更新状态和里程计
     void controlTask();
+
+    // 执行全部待执行的命令，返回执行的命令数
+    uint32_t drainCommands();
+
+    // 收集已完成的运动命令，失败时记录警告，不等待总线
+    void collectMotion();
+
+    // 记录一个周期的统计，按发布间隔发布
+    void recordCycle(uint32_t jitterUs, bool jitterValid, uint32_t workUs, TickType_t periodTicks);
     
-    // 执行控制命令
-    void executeCommand(const ControlCommand& cmd);
+    // 执行控制命令；generation 为取出命令前的紧急停止代数，此后发生的紧急停止使本条运动命令作废
+    void executeCommand(const ControlCommand& cmd, uint32_t generation);
     
-    // 更新状态
+    // 推进状态轮询：收集已完成的轮询并发布，到达轮询间隔时提交下一次，不等待总线
     void updateState();
     
     // 更新里程计
     void updateOdometer();
 
+    // 按运动状态计算下一次状态轮询的间隔
+    uint32_t nextPollInterval(uint32_t nowMs);
+
+    // 静止时的默认轮询间隔（约 4 Hz）
+    static constexpr uint32_t IDLE_POLL_INTERVAL_MS = 250;
+    // 新命令或运动结束后保持最高轮询速率的时长
+    static constexpr uint32_t ACTIVE_HOLD_MS = 1000;
+    // 轮询间隔不小于单次轮询耗时的倍数：为控制命令保留一半的总线时间
+    static constexpr uint32_t POLL_DUTY_FACTOR = 2;
+    // 信箱写入冲突时让出处理器重试的次数，之后每次等待一个节拍
+    static constexpr uint32_t POST_SPIN_ATTEMPTS = 4;
+    // 启动前写入的运动命令超过该时长即作废，不在协商、探测与使能之后才执行
+    static constexpr uint32_t STALE_MOTION_MS = 100;
+    // 默认控制循环频率
+    static constexpr uint32_t DEFAULT_LOOP_HZ = 500;
+    // 循环统计的发布间隔
+    static constexpr uint32_t LOOP_STATS_PUBLISH_MS = 100;
+
     CarController* carController = nullptr;
+    ParamStore* paramStore = nullptr;
     TaskHandle_t controlTaskHandle = nullptr;
     
-    // FreeRTOS 队列和互斥锁
-    QueueHandle_t commandQueue = nullptr;   // 命令队列
-    SemaphoreHandle_t stateMutex = nullptr; // 状态互斥锁
-    SemaphoreHandle_t odometerMutex = nullptr; // 里程计互斥锁
-    
-    // 状态缓存
-    CarState cachedState;
+    // 命令信箱：每种命令只保留最新一条，生产者 O(1) 覆盖；stamp 为全局写入序号，控制任务按其先后执行
+    struct MailboxEntry {
+        ControlCommand cmd;
+        uint32_t stamp;
+    };
+    static constexpr size_t MAILBOX_COUNT = static_cast<size_t>(CommandType::COUNT);
+    SeqLock<MailboxEntry> mailboxes[MAILBOX_COUNT];
+    std::atomic<uint32_t> commandStamp{0};
+    uint32_t executedStamp[MAILBOX_COUNT] = {};   // 各信箱已执行（或作废）的序号（仅控制任务）
+    bool initialized = false;
+
+    // 状态与里程计发布：只由控制任务写入，其他任务读取最近一次发布的快照，双方都不阻塞
+    DoubleBuffer<CarState> stateBuffer;
+    DoubleBuffer<Odometer> odometerBuffer;
+
+    // 状态缓存（仅控制任务）
+    CarState cachedState{};
     uint32_t lastStateUpdateTime;
-    uint32_t stateUpdateInterval; // 状态更新间隔（毫秒）
-    
-    // 里程计数据
-    Odometer odometer;
-    uint32_t lastOdometerUpdateTime;
+    uint32_t stateUpdateInterval; // 状态更新间隔（毫秒），运动时的最短轮询间隔
+
+    // 自适应轮询（仅控制任务读写）
+    uint32_t idlePollInterval = IDLE_POLL_INTERVAL_MS;
+    uint32_t pollInterval = IDLE_POLL_INTERVAL_MS;  // 当前轮询间隔
+    uint32_t pollDurationUs = 0;        // 最近一次状态轮询耗时（提交到收集）
+    uint32_t pollStartUs = 0;           // 进行中的状态轮询的提交时刻
+    TickType_t lastPollTick = 0;        // 最近一次提交状态轮询的节拍
+    bool pollRequested = false;         // GET_STATUS：不等轮询间隔立即提交下一次轮询
+    uint32_t lastActivityMs = 0;        // 最近一次新命令或检测到运动的时刻
+    bool motionCommanded = false;       // 最近的速度命令不为零
+    
+    // 里程计数据（仅控制任务）
+    Odometer odometer{};
+    uint32_t lastOdometerUpdateUs = 0;
+
+    // 固定周期控制循环
+    std::atomic<uint32_t> loopRateHz{DEFAULT_LOOP_HZ};
+    std::atomic<bool> loopStatsResetRequested{false};
+    DoubleBuffer<LoopStats> loopStatsBuffer;
+    LoopStats loopStats{};              // 计数部分（仅控制任务）
+    LatencyHistogram jitterHistogram;   // 周期抖动（仅控制任务）
+    LatencyHistogram workHistogram;     // 单周期工作耗时（仅控制任务）
+    uint32_t cyclesSincePublish = 0;
 };
 
 //==============================================================================
@@ -125,25 +267,29 @@ inline ControlManager& ControlManager::getInstance() {
 }
 
 // 初始化控制管理器
-inline void ControlManager::init(CarController* controller) {
+inline void ControlManager::init(CarController* controller, bool startTask) {
     carController = controller;
     
-    // 创建命令队列
-    commandQueue = xQueueCreate(10, sizeof(ControlCommand));
-    
-    // 创建互斥锁
-    stateMutex = xSemaphoreCreateMutex();
-    odometerMutex = xSemaphoreCreateMutex();
-    
-    // 设置默认状态更新间隔
-    stateUpdateInterval = 50;
+    // 设置运动时的最短状态更新间隔（实际间隔还受单次轮询耗时限制，静止时降到 idlePollInterval）
+    stateUpdateInterval = 20;
     lastStateUpdateTime = 0;
     
     // 初始化里程计
-    resetOdometer();
-    lastOdometerUpdateTime = millis();
-    
-    // 启动统一控制任务
+    odometer = Odometer{};
+    lastOdometerUpdateUs = micros();
+    initialized = true;
+
+    if (startTask) {
+        start();
+    }
+}
+
+// 启动统一控制任务
+inline void ControlManager::start() {
+    if (controlTaskHandle || !initialized) {
+        return;
+    }
+    lastOdometerUpdateUs = micros();
     xTaskCreate(
         controlTaskWrapper,
         "controlTask",
@@ -172,13 +318,8 @@ inline void ControlManager::setSpeed(float vx, float vy, float omega, float acce
     cmd.param6 = subdivision;
     cmd.timestamp = millis();
     
-    // 替换队列中的同类型命令
-    replaceCommand(cmd);
-    
-    // 如果是停止命令，立即执行
-    if (vx == 0.0f && vy == 0.0f && omega == 0.0f) {
-        stop();
-    }
+    // 覆盖信箱中未执行的速度命令；零速度也是普通设定值（按加速度减速），紧急停止只由 stop() 发出
+    postCommand(cmd);
 }
 
 // 移动距离命令
@@ -193,75 +334,110 @@ inline void ControlManager::moveDistance(float dx, float dy, float dtheta, float
     cmd.param6 = subdivision;
     cmd.timestamp = millis();
     
-    // 替换队列中的同类型命令
-    replaceCommand(cmd);
+    // 覆盖信箱中未执行的移动命令
+    postCommand(cmd);
 }
 
 // 停止命令
-inline void ControlManager::stop() {
+inline void ControlManager::stop(uint32_t receivedUs) {
+    if (receivedUs == 0) {
+        receivedUs = micros();
+    }
+    // 控制任务已启动时在此直接紧急停止，信箱中的停止命令只用于更新运动状态；
+    // 启动前总线尚在协商/探测，停止命令留在信箱中，启动后首先执行
+    const bool direct = carController && controlTaskHandle;
+
     ControlCommand cmd;
     cmd.type = CommandType::STOP;
+    cmd.param6 = direct ? 1 : 0;
     cmd.timestamp = millis();
     
-    // 添加到队列，高优先级
-    if (commandQueue) {
-        // 清空队列，确保停止命令立即执行
-        xQueueReset(commandQueue);
-        xQueueSendToFront(commandQueue, &cmd, 0);
-    }
+    // 写入停止信箱：此前写入而尚未执行的速度/移动命令由控制任务作废
+    postCommand(cmd);
     
-    // 如果控制器可用，直接调用停止
-    if (carController) {
-        carController->stop();
+    if (direct && !carController->emergencyStop(receivedUs)) {
+        Logger::warn("ControlManager", "Emergency stop not confirmed by all wheels");
     }
 }
 
+// 紧急停止统计
+inline EStopStats ControlManager::getEStopStats() const {
+    return carController ? carController->getEStopStats() : EStopStats{};
+}
+
+// 设置控制循环频率
+inline void ControlManager::setLoopRate(uint32_t hz) {
+    if (hz == 0) {
+        hz = 1;
+    } else if (hz > configTICK_RATE_HZ) {
+        hz = configTICK_RATE_HZ;
+    }
+    // 取整为节拍周期的整数倍
+    loopRateHz.store(configTICK_RATE_HZ / (configTICK_RATE_HZ / hz), std::memory_order_relaxed);
+}
+
+// 当前控制循环频率
+inline uint32_t ControlManager::getLoopRate() const {
+    return loopRateHz.load(std::memory_order_relaxed);
+}
+
+// 控制循环统计
+inline LoopStats ControlManager::getLoopStats(bool reset) {
+    LoopStats stats = loopStatsBuffer.read().value;
+    if (reset) {
+        loopStatsResetRequested.store(true, std::memory_order_relaxed);
+    }
+    return stats;
+}
+
 // 重置里程计命令
 inline void ControlManager::resetOdometer() {
     ControlCommand cmd;
     cmd.type = CommandType::RESET_ODOMETER;
     cmd.timestamp = millis();
     
-    // 加入队列
-    replaceCommand(cmd);
-    
-    // 也可以直接重置
-    if (xSemaphoreTake(odometerMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        odometer.x = 0.0f;
-        odometer.y = 0.0f;
-        odometer.theta = 0.0f;
-        odometer.vx = 0.0f;
-        odometer.vy = 0.0f;
-        odometer.omega = 0.0f;
-        xSemaphoreGive(odometerMutex);
-        Logger::debug("ControlManager", "Odometer reset");
-    }
+    // 写入信箱，由控制任务清零并发布（里程计只由控制任务写入）
+    postCommand(cmd);
 }
 
 // 获取当前小车状态
-inline CarState ControlManager::getCarState() {
-    CarState state;
-    
-    // 从缓存获取状态
-    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        state = cachedState;
-        xSemaphoreGive(stateMutex);
+inline CarState ControlManager::getCarState() const {
+    return stateBuffer.read().value;
+}
+
+// 获取当前小车状态快照
+inline CarStateSnapshot ControlManager::getCarStateSnapshot() const {
+    return stateBuffer.read();
+}
+
+// 获取最近一次缓存的四轮遥测
+inline TelemetrySnapshot ControlManager::getTelemetry() const {
+    return stateBuffer.read().value.telemetry;
+}
+
+// 电机总线数量
+inline size_t ControlManager::getBusCount() const {
+    return carController ? carController->getBusCount() : 0;
+}
+
+// 获取电机总线事务统计（统计由总线自行加锁，不占用控制任务）
+inline bool ControlManager::getBusStats(size_t index, BusStatsReport& report, bool reset) {
+    MotorBus* bus = carController ? carController->getBus(index) : nullptr;
+    if (!bus) {
+        return false;
     }
-    
-    return state;
+    bus->busStats(report, reset);
+    return true;
 }
 
 // 获取当前里程计数据
-inline Odometer ControlManager::getOdometer() {
-    Odometer odom;
-    
-    // 获取互斥锁
-    if (xSemaphoreTake(odometerMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        odom = odometer;    //直接从缓存获取。
-        xSemaphoreGive(odometerMutex);
-    }
-    
-    return odom;
+inline Odometer ControlManager::getOdometer() const {
+    return odometerBuffer.read().value;
+}
+
+// 获取当前里程计快照
+inline OdometerSnapshot ControlManager::getOdometerSnapshot() const {
+    return odometerBuffer.read();
 }
 
 // 设置状态更新间隔
@@ -269,183 +445,384 @@ inline void ControlManager::setStateUpdateInterval(uint32_t interval_ms) {
     stateUpdateInterval = interval_ms;
 }
 
-// 替换命令队列中的同类型命令
-inline void ControlManager::replaceCommand(const ControlCommand& newCmd) {
-    if (!commandQueue) return;
-    
-    // 创建临时队列
-    QueueHandle_t tempQueue = xQueueCreate(10, sizeof(ControlCommand));
-    if (!tempQueue) {
-        // 队列创建失败，直接添加新命令
-        xQueueSend(commandQueue, &newCmd, 0);
-        return;
+// 修改参数并排队应用
+inline bool ControlManager::setParam(const char* name, float value, bool persist) {
+    if (!paramStore || !paramStore->set(name, value)) {
+        return false;
+    }
+    if (persist && !paramStore->save()) {
+        Logger::warn("ControlManager", "Failed to save parameters");
     }
-    
-    bool replaced = false;
     ControlCommand cmd;
-    
-    // 遍历原队列
-    while (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
-        // 如果找到同类型的命令，替换它
-        if (cmd.type == newCmd.type && !replaced) {
-            xQueueSend(tempQueue, &newCmd, 0);
-            replaced = true;
+    cmd.type = CommandType::APPLY_PARAMS;
+    cmd.timestamp = millis();
+    postCommand(cmd);
+    return true;
+}
+
+// 读取参数
+inline bool ControlManager::getParam(const char* name, float& value) const {
+    return paramStore && paramStore->get(name, value);
+}
+
+// 写入命令信箱并唤醒控制任务
+inline void ControlManager::postCommand(const ControlCommand& cmd) {
+    MailboxEntry entry;
+    entry.cmd = cmd;
+    // 另一任务正在写入同一信箱时重试，命令不会丢失。冲突的写入者只占用信箱几次存储的时间：
+    // 另一核心上的写入者很快完成；被本任务抢占的同核心低优先级写入者需要本任务让出处理器才能完成。
+    // 每次重试重新取序号，命令的先后以写入完成的顺序为准
+    for (uint32_t attempt = 0;; ++attempt) {
+        // 序号从 1 开始，0 表示信箱为空
+        entry.stamp = commandStamp.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (mailboxes[static_cast<size_t>(cmd.type)].write(entry)) {
+            break;
+        }
+        if (attempt < POST_SPIN_ATTEMPTS) {
+            taskYIELD();
         } else {
-            // 否则保留原命令
-            xQueueSend(tempQueue, &cmd, 0);
+            vTaskDelay(1);
         }
     }
-    
-    // 如果没有替换任何命令，添加新命令
-    if (!replaced) {
-        xQueueSend(tempQueue, &newCmd, 0);
+    if (controlTaskHandle) {
+        xTaskNotifyGive(controlTaskHandle);
     }
-    
-    // 将临时队列中的命令复制回原队列
-    while (xQueueReceive(tempQueue, &cmd, 0) == pdTRUE) {
-        xQueueSend(commandQueue, &cmd, 0);
+}
+
+// 取出最早写入的未执行命令
+// 停止命令之前写入的速度/移动命令不再执行（停止命令本身由 stop() 直接发出，这里只需保证其后不再恢复旧的运动）
+inline bool ControlManager::takeCommand(ControlCommand& cmd) {
+    MailboxEntry pending[MAILBOX_COUNT];
+    bool ready[MAILBOX_COUNT] = {};
+    for (size_t i = 0; i < MAILBOX_COUNT; ++i) {
+        // 写入进行中的信箱留到下一轮读取
+        ready[i] = mailboxes[i].read(pending[i]) && pending[i].stamp != executedStamp[i];
     }
-    
-    // 删除临时队列
-    vQueueDelete(tempQueue);
+
+    const size_t stopIndex = static_cast<size_t>(CommandType::STOP);
+    const uint32_t stopStamp = ready[stopIndex] ? pending[stopIndex].stamp : executedStamp[stopIndex];
+    for (CommandType motion : {CommandType::SPEED, CommandType::MOVE}) {
+        const size_t i = static_cast<size_t>(motion);
+        // 回绕安全的比较
+        if (ready[i] && stopStamp != 0 && static_cast<int32_t>(pending[i].stamp - stopStamp) < 0) {
+            executedStamp[i] = pending[i].stamp;
+            ready[i] = false;
+        }
+    }
+
+    size_t next = MAILBOX_COUNT;
+    for (size_t i = 0; i < MAILBOX_COUNT; ++i) {
+        if (ready[i] && (next == MAILBOX_COUNT ||
+                         static_cast<int32_t>(pending[i].stamp - pending[next].stamp) < 0)) {
+            next = i;
+        }
+    }
+    if (next == MAILBOX_COUNT) {
+        return false;
+    }
+    // 上一条运动命令尚未收集完应答时，最早的运动命令（及其后写入的命令）留在信箱中，新的设定值仍可覆盖它
+    if ((next == static_cast<size_t>(CommandType::SPEED) || next == static_cast<size_t>(CommandType::MOVE)) &&
+        carController && carController->motionPending()) {
+        return false;
+    }
+    executedStamp[next] = pending[next].stamp;
+    cmd = pending[next].cmd;
+    return true;
 }
 
-// 统一控制任务 - 处理命令、更新状态和里程计
+// 作废启动前积压的运动命令：启动要经过波特率协商、电机探测与使能，期间收到的速度/移动命令可能已是数秒前的意图。
+// 停止、状态与参数命令不受影响，照常执行
+inline void ControlManager::discardStaleMotion() {
+    const uint32_t nowMs = millis();
+    for (CommandType motion : {CommandType::SPEED, CommandType::MOVE}) {
+        const size_t i = static_cast<size_t>(motion);
+        MailboxEntry entry;
+        if (!mailboxes[i].read(entry) || entry.stamp == executedStamp[i]) {
+            continue;   // 没有待执行命令，或正在写入（即刚写入的新命令）
+        }
+        const uint32_t ageMs = nowMs - entry.cmd.timestamp;
+        if (ageMs > STALE_MOTION_MS) {
+            executedStamp[i] = entry.stamp;
+            Logger::warn("ControlManager", "Discarded %s command queued %lu ms before start",
+                         motion == CommandType::SPEED ? "speed" : "move", static_cast<unsigned long>(ageMs));
+        }
+    }
+}
+
+// 统一控制任务 - 固定周期处理命令、更新状态和里程计
+// 每个周期：收集已完成的运动命令、执行全部待执行命令 → 收集已完成的状态轮询、到达轮询间隔时提交下一次 → 里程计积分 → 等待下一周期起点
 inline void ControlManager::controlTask() {
-    TickType_t lastOdometerTime = xTaskGetTickCount();
-    TickType_t lastStateTime = xTaskGetTickCount();
-    TickType_t currentTime;
+    lastPollTick = xTaskGetTickCount();
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t lastStartUs = micros();
+    // 本周期 / 上一周期的起点是否因超时推迟；首个周期没有上一起点
+    bool lateStart = true;
+    bool prevLateStart = true;
+    lastActivityMs = millis();
+    discardStaleMotion();
+    // 启动阶段（协商、探测、使能）不限调用预算；此后车轮单次调用至少容纳一次重发，与循环周期无关：
+    // 运动命令与状态轮询都不在周期内等待应答，重发只占用总线时间
+    if (carController) {
+        carController->setCallBudget(carController->minCallBudgetUs());
+    }
     
     for (;;) {
-        currentTime = xTaskGetTickCount();
+        const uint32_t hz = loopRateHz.load(std::memory_order_relaxed);
+        const TickType_t periodTicks = configTICK_RATE_HZ / hz;
+        const uint32_t periodUs = periodTicks * (1000000 / configTICK_RATE_HZ);
+        const uint32_t startUs = micros();
+        const uint32_t intervalUs = startUs - lastStartUs;
+        const uint32_t jitterUs = intervalUs > periodUs ? intervalUs - periodUs : periodUs - intervalUs;
+        lastStartUs = startUs;
         
-        // 1. 优先处理命令队列中的命令
-        ControlCommand cmd;
-        if (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
-            // 有命令，执行命令
-            executeCommand(cmd);
-        } else {
-            // 2. 没有命令，检查是否需要更新状态
-            if ((currentTime - lastStateTime) >= pdMS_TO_TICKS(stateUpdateInterval)) {
-                updateState();
-                lastStateTime = currentTime;
-            }
-            
-            // 3. 检查是否需要更新里程计 (100Hz)
-            if ((currentTime - lastOdometerTime) >= pdMS_TO_TICKS(10)) {
-                updateOdometer();
-                lastOdometerTime = currentTime;
+        // 1. 收集已完成的运动命令，执行全部待执行的命令：运动命令提交后即返回，应答在之后的周期中收集
+        drainCommands();
+
+        // 2. 按运动状态决定的间隔轮询状态：读取事务异步提交，在之后的周期中收集，周期内不等待总线
+        updateState();
+
+        // 3. 里程计积分
+        updateOdometer();
+
+        // 两端都按时开始的间隔才计入抖动（超时推迟的起点另计入 overruns）
+        recordCycle(jitterUs, !lateStart && !prevLateStart, micros() - startUs, periodTicks);
+
+        // 4. 等待下一周期起点（节拍网格上的绝对时刻，与 vTaskDelayUntil 相同，不随工作耗时漂移）。
+        //    等待期间写入的命令由任务通知唤醒、立即执行，不必等到下一周期起点。
+        //    越过起点时控制任务仍在工作则记为超时：不补跑错过的周期，对齐到最近一个已过的起点立即开始下一周期
+        TickType_t nextWake = lastWake + periodTicks;
+        bool idle = false;     // 到达起点时控制任务处于等待中
+        for (;;) {
+            const TickType_t current = xTaskGetTickCount();
+            const int32_t remaining = static_cast<int32_t>(nextWake - current);
+            if (remaining <= 0) {
+                prevLateStart = lateStart;
+                lateStart = !idle;
+                if (lateStart) {
+                    const TickType_t missed = (current - nextWake) / periodTicks;
+                    ++loopStats.overruns;
+                    loopStats.skipped += missed;
+                    nextWake += missed * periodTicks;
+                }
+                break;
             }
-            
-            // 短暂休眠，避免占用过多CPU
-            vTaskDelay(1);
+            idle = ulTaskNotifyTake(pdTRUE, static_cast<TickType_t>(remaining)) == 0 || drainCommands() == 0;
         }
+        lastWake = nextWake;
     }
 }
 
+// 执行全部待执行的命令：每种类型至多一条，执行期间新写入的命令留到下一次
+inline uint32_t ControlManager::drainCommands() {
+    collectMotion();
+    ControlCommand cmd;
+    uint32_t commands = 0;
+    while (commands < MAILBOX_COUNT) {
+        // 先读代数再取命令：取出后才发生的紧急停止一定使代数不同，命令的同步帧在提交前被丢弃
+        const uint32_t generation = carController ? carController->estopGeneration() : 0;
+        if (!takeCommand(cmd)) {
+            break;
+        }
+        executeCommand(cmd, generation);
+        ++commands;
+    }
+    if (commands > 0) {
+        // 新命令后暂时以最高速率轮询，尽快得到执行结果
+        lastActivityMs = millis();
+        loopStats.commands += commands;
+    }
+    return commands;
+}
+
+// 记录周期统计
+inline void ControlManager::recordCycle(uint32_t jitterUs, bool jitterValid, uint32_t workUs,
+                                        TickType_t periodTicks) {
+    if (loopStatsResetRequested.exchange(false, std::memory_order_relaxed)) {
+        loopStats = LoopStats{};
+        jitterHistogram.reset();
+        workHistogram.reset();
+    }
+    ++loopStats.cycles;
+    if (jitterValid) {
+        jitterHistogram.record(jitterUs);
+    }
+    workHistogram.record(workUs);
+
+    // 百分位计算遍历直方图，按发布间隔汇总一次
+    const uint32_t rateHz = configTICK_RATE_HZ / periodTicks;
+    if (++cyclesSincePublish < rateHz * LOOP_STATS_PUBLISH_MS / 1000) {
+        return;
+    }
+    cyclesSincePublish = 0;
+    loopStats.rateHz = rateHz;
+    loopStats.periodUs = periodTicks * (1000000 / configTICK_RATE_HZ);
+    loopStats.jitterAvgUs = jitterHistogram.mean();
+    loopStats.jitterP99Us = jitterHistogram.percentile(0.99f);
+    loopStats.jitterMaxUs = jitterHistogram.max();
+    loopStats.workAvgUs = workHistogram.mean();
+    loopStats.workP99Us = workHistogram.percentile(0.99f);
+    loopStats.workMaxUs = workHistogram.max();
+    loopStatsBuffer.publish(loopStats, micros());
+}
+
+// 按运动状态计算状态轮询间隔
+// 速度命令不为零或任一车轮实测转速不为零即视为运动；运动结束或收到新命令后 ACTIVE_HOLD_MS 内保持最高速率，
+// 最高速率受限于单次轮询耗时（POLL_DUTY_FACTOR 倍），静止时降到 idlePollInterval
+inline uint32_t ControlManager::nextPollInterval(uint32_t nowMs) {
+    bool moving = motionCommanded;
+    for (auto speed : cachedState.wheelSpeeds) {
+        if (speed != 0) {
+            moving = true;
+            break;
+        }
+    }
+    if (moving) {
+        lastActivityMs = nowMs;
+    }
+    if (nowMs - lastActivityMs >= ACTIVE_HOLD_MS) {
+        return idlePollInterval > stateUpdateInterval ? idlePollInterval : stateUpdateInterval;
+    }
+    uint32_t sustainable = (pollDurationUs * POLL_DUTY_FACTOR + 999) / 1000;
+    return sustainable > stateUpdateInterval ? sustainable : stateUpdateInterval;
+}
+
 // 执行控制命令
-inline void ControlManager::executeCommand(const ControlCommand& cmd) {
+inline void ControlManager::executeCommand(const ControlCommand& cmd, uint32_t generation) {
     if (!carController) return;
     
     switch (cmd.type) {
         case CommandType::SPEED:
+            motionCommanded = cmd.param1 != 0.0f || cmd.param2 != 0.0f || cmd.param3 != 0.0f;
             Logger::debug("ControlManager", "Executing speed command: vx=%.2f, vy=%.2f, omega=%.2f", 
                          cmd.param1, cmd.param2, cmd.param3);
-            carController->setSpeed(cmd.param1, cmd.param2, cmd.param3, cmd.param4, cmd.param6);
+        {
+            BusResult result = carController->beginSetSpeed(cmd.param1, cmd.param2, cmd.param3, cmd.param4,
+                                                            cmd.param6, generation);
+            if (!result)
+                Logger::warn("ControlManager", "Speed command failed: %s", busErrorName(result.error));
             break;
+        }
         
         case CommandType::MOVE:
             Logger::debug("ControlManager", "Executing move command: dx=%.2f, dy=%.2f, dtheta=%.2f", 
                          cmd.param1, cmd.param2, cmd.param3);
-            carController->moveDistance(cmd.param1, cmd.param2, cmd.param3, 
-                                      cmd.param4, cmd.param5, cmd.param6);
+        {
+            BusResult result = carController->beginMoveDistance(cmd.param1, cmd.param2, cmd.param3,
+                                                                cmd.param4, cmd.param5, cmd.param6, generation);
+            if (!result)
+                Logger::warn("ControlManager", "Move command failed: %s", busErrorName(result.error));
             break;
+        }
         
         case CommandType::STOP:
             Logger::debug("ControlManager", "Executing stop command");
-            carController->stop();
+            motionCommanded = false;
+            // 已由 stop() 直接紧急停止时不再重复发送
+            if (cmd.param6 == 0 && !carController->stop())
+                Logger::warn("ControlManager", "Emergency stop not confirmed by all wheels");
             break;
         
         case CommandType::GET_STATUS:
-            // 强制更新状态
+            // 强制更新状态：不等轮询间隔，立即提交下一次轮询
+            pollRequested = true;
             updateState();
             break;
             
         case CommandType::RESET_ODOMETER:
             // 重置里程计
-            if (xSemaphoreTake(odometerMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-                odometer.x = 0.0f;
-                odometer.y = 0.0f;
-                odometer.theta = 0.0f;
-                odometer.vx = 0.0f;
-                odometer.vy = 0.0f;
-                odometer.omega = 0.0f;
-                xSemaphoreGive(odometerMutex);
-                Logger::debug("ControlManager", "Odometer reset");
+            odometer = Odometer{};
+            odometerBuffer.publish(odometer, micros());
+            Logger::debug("ControlManager", "Odometer reset");
+            break;
+
+        case CommandType::APPLY_PARAMS:
+            // 运动学模型只在控制任务中使用，在此替换几何参数即不会与运动计算交错
+            if (paramStore) {
+                if (!carController->setGeometry(paramStore->geometry()))
+                    Logger::warn("ControlManager", "Geometry rejected by kinematics model");
+                carController->configure(paramStore->controlConfig());
             }
             break;
+
+        case CommandType::COUNT:
+            break;
+    }
+}
+
+// 收集已完成的运动命令（多总线时车轮应答后在此提交同步触发帧）
+inline void ControlManager::collectMotion() {
+    BusResult result;
+    if (carController && carController->collectMotion(result) && !result) {
+        Logger::warn("ControlManager", "Motion command failed: %s", busErrorName(result.error));
     }
 }
 
-// 更新状态
+// 推进状态轮询
 inline void ControlManager::updateState() {
     if (!carController) return;
-    
-    CarState newState = carController->getCarState();
-    
-    // 更新缓存
-    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        cachedState = newState;
+
+    if (carController->statePollPending()) {
+        // 读取尚未全部完成时留到下一周期收集
+        if (!carController->collectCarState(cachedState)) return;
+        // 更新缓存并发布
+        pollDurationUs = micros() - pollStartUs;
         lastStateUpdateTime = millis();
-        xSemaphoreGive(stateMutex);
+        stateBuffer.publish(cachedState, micros());
     }
+
+    pollInterval = nextPollInterval(millis());
+    const TickType_t now = xTaskGetTickCount();
+    if (!pollRequested && (now - lastPollTick) < pdMS_TO_TICKS(pollInterval)) return;
+    carController->beginStatePoll();
+    pollStartUs = micros();
+    lastPollTick = now;
+    pollRequested = false;
+}
+
+// 里程计积分一步（中点角度），角度保持在 -π 到 π
+inline void ControlManager::integrateOdometer(Odometer& odom, const CarState& state, float dt) {
+    // 更新速度
+    odom.vx = state.vx;
+    odom.vy = state.vy;
+    odom.omega = state.omega;
+    
+    // 更新位置和角度（积分）
+    float dtheta = odom.omega * dt;
+    odom.theta += dtheta;
+    
+    // 保持角度在-π到π范围内
+    while (odom.theta > M_PI) odom.theta -= 2.0f * M_PI;
+    while (odom.theta < -M_PI) odom.theta += 2.0f * M_PI;
+    
+    // 计算位移增量（考虑当前方向）
+    float cos_theta = cosf(odom.theta - dtheta/2.0f); // 使用中点角度计算
+    float sin_theta = sinf(odom.theta - dtheta/2.0f);
+    
+    // 计算全局坐标系中的位移
+    float dx = odom.vx * cos_theta * dt;
+    float dy = odom.vx * sin_theta * dt;
+    
+    // 更新位置
+    odom.x += dx;
+    odom.y += dy;
 }
 
 // 更新里程计
 inline void ControlManager::updateOdometer() {
-    // 获取当前状态
-    CarState state = getCarState();
-    
-    // 获取当前时间
-    uint32_t currentTime = millis();
-    float dt = (currentTime - lastOdometerUpdateTime) / 1000.0f; // 转换为秒
+    // 获取当前时间（微秒，高频循环下毫秒精度不足）
+    uint32_t currentTime = micros();
+    float dt = (currentTime - lastOdometerUpdateUs) / 1000000.0f; // 转换为秒
     
-    // 防止时间差过大或为负（可能由于溢出）
+    // 防止时间差过大或为零
     if (dt > 0.5f || dt <= 0.0f) {
-        dt = 0.01f; // 默认10ms
+        dt = 1.0f / loopRateHz.load(std::memory_order_relaxed); // 默认一个控制周期
     }
     
-    // 获取互斥锁
-    if (xSemaphoreTake(odometerMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // 更新速度
-        odometer.vx = state.vx;
-        odometer.vy = state.vy;
-        odometer.omega = state.omega;
-        
-        // 更新位置和角度（积分）
-        float dtheta = odometer.omega * dt;
-        odometer.theta += dtheta;
-        
-        // 保持角度在-π到π范围内
-        while (odometer.theta > M_PI) odometer.theta -= 2.0f * M_PI;
-        while (odometer.theta < -M_PI) odometer.theta += 2.0f * M_PI;
-        
-        // 计算位移增量（考虑当前方向）
-        float cos_theta = cosf(odometer.theta - dtheta/2.0f); // 使用中点角度计算
-        float sin_theta = sinf(odometer.theta - dtheta/2.0f);
-        
-        // 计算全局坐标系中的位移
-        float dx = odometer.vx * cos_theta * dt;
-        float dy = odometer.vx * sin_theta * dt;
-        
-        // 更新位置
-        odometer.x += dx;
-        odometer.y += dy;
-        
-        xSemaphoreGive(odometerMutex);  // 释放互斥锁
-    }
+    // 以最近一次缓存的状态积分并发布
+    integrateOdometer(odometer, cachedState, dt);
+    odometerBuffer.publish(odometer, micros());
     
     // 更新时间戳
-    lastOdometerUpdateTime = currentTime;
+    lastOdometerUpdateUs = currentTime;
 } 
 
@@ -0,0 +1,14 @@
+#pragma once
+
+// 电机总线串口引脚（按实际接线修改）
+// 单总线时全部电机接在 Serial00 的默认 RX/TX 上；
+// 双总线时右侧两轮（电机 1、2）接 UART1，左侧两轮（电机 3、4）接 UART2。
+// 广播命令由地址 1 的驱动器应答，左侧总线没有应答者，其广播控制命令不等待应答（CarController 按车轮地址自动设置）。
+#define MOTOR_UART_RIGHT_RX 18
+#define MOTOR_UART_RIGHT_TX 17
+#define MOTOR_UART_LEFT_RX  16
+#define MOTOR_UART_LEFT_TX  15
+
+// CAN 收发器引脚（MOTOR_BUS_CAN == 1 时使用）
+#define MOTOR_CAN_TX 5
+#define MOTOR_CAN_RX 4
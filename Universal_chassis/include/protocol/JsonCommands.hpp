@@ -0,0 +1,86 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include "CarController/CarController.h"
+
+/**
+ * @brief USB / MQTT 共用的 JSON 命令字段读取与状态序列化（协议见 ControlProtocol.md）
+ *
+ * UsbControl 与 MqttControl 的 processCommand / publishStatus 使用同一份实现，
+ * bench/hot_paths_bench.cpp 直接测量这些函数。
+ */
+namespace JsonCommands {
+
+// speed 命令参数（缺省值与 ControlProtocol.md 一致）
+struct SpeedArgs {
+    float vx;
+    float vy;
+    float omega;
+    float acceleration;
+    uint16_t subdivision;
+};
+
+// move 命令参数
+struct MoveArgs {
+    float dx;
+    float dy;
+    float dtheta;
+    float speed;
+    float acceleration;
+    uint16_t subdivision;
+};
+
+/**
+ * @brief 读取 speed 命令字段，缺少的字段取缺省值
+ */
+inline SpeedArgs readSpeedArgs(JsonVariantConst doc) {
+    SpeedArgs args;
+    args.vx = doc["vx"] | 0.0f;
+    args.vy = doc["vy"] | 0.0f;
+    args.omega = doc["omega"] | 0.0f;
+    args.acceleration = doc["acceleration"] | 10.0f;
+    args.subdivision = doc["subdivision"] | 256;
+    return args;
+}
+
+/**
+ * @brief 读取 move 命令字段，缺少的字段取缺省值
+ */
+inline MoveArgs readMoveArgs(JsonVariantConst doc) {
+    MoveArgs args;
+    args.dx = doc["dx"] | 0.0f;
+    args.dy = doc["dy"] | 0.0f;
+    args.dtheta = doc["dtheta"] | 0.0f;
+    args.speed = doc["speed"] | 1.0f;
+    args.acceleration = doc["acceleration"] | 10.0f;
+    args.subdivision = doc["subdivision"] | 256;
+    return args;
+}
+
+/**
+ * @brief 将小车状态写入 JSON 文档（vx、vy、omega、wheelSpeeds、wheelHealth）
+ */
+inline void writeStatus(JsonDocument& doc, const CarState& state) {
+    doc["vx"] = state.vx;
+    doc["vy"] = state.vy;
+    doc["omega"] = state.omega;
+    JsonArray speeds = doc["wheelSpeeds"].to<JsonArray>();
+    for (auto speed : state.wheelSpeeds) {
+        speeds.add(speed);
+    }
+    JsonArray health = doc["wheelHealth"].to<JsonArray>();
+    for (auto wheel : state.wheelHealth) {
+        health.add(motorHealthName(wheel));
+    }
+}
+
+/**
+ * @brief 同上，另写入状态快照的发布序号与时刻（seq、stampUs）；seq 不变表示状态没有更新
+ */
+inline void writeStatus(JsonDocument& doc, const CarState& state, uint32_t sequence, uint32_t timestampUs) {
+    writeStatus(doc, state);
+    doc["seq"] = sequence;
+    doc["stampUs"] = timestampUs;
+}
+
+} // namespace JsonCommands
@@ -3,7 +3,9 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
+#include <memory>
 #include "control/ControlManager.hpp"
+#include "protocol/JsonCommands.hpp"
 #include "utils/Logger.hpp"
 #include "config.h"
 
@@ -28,6 +30,18 @@ public:
     // 发布当前小车状态到 MQTT
     void publishStatus();
 
+    // 发布电机总线事务统计到 MQTT，reset 为 true 时发布后清零
+    void publishBusStats(bool reset);
+
+    // 发布参数到 MQTT，name 为 nullptr 时发布全部参数
+    void publishParams(const char* name);
+
+    // 发布紧急停止统计到 MQTT
+    void publishEStopStats();
+
+    // 发布控制循环统计到 MQTT，reset 为 true 时读取后清零
+    void publishLoopStats(bool reset);
+
     // 设置状态发布间隔
     void setStatusInterval(uint32_t interval_ms) {
         statusInterval = interval_ms;
@@ -189,17 +203,10 @@ void MqttControl::publishStatus()
     }
     
     // 获取当前小车状态 - 从控制管理器获取
-    CarState state = controlManager->getCarState();
+    CarStateSnapshot snapshot = controlManager->getCarStateSnapshot();
 
     JsonDocument doc;
-    doc["vx"] = state.vx;
-    doc["vy"] = state.vy;
-    doc["omega"] = state.omega;
-    JsonArray speeds = doc["wheelSpeeds"].to<JsonArray>();
-    for (auto speed : state.wheelSpeeds)
-    {
-        speeds.add(speed);
-    }
+    JsonCommands::writeStatus(doc, snapshot.value, snapshot.sequence, snapshot.timestampUs);
 
     char buffer[JSON_BUFFER_SIZE];
     size_t n = serializeJson(doc, buffer);
@@ -207,6 +214,141 @@ void MqttControl::publishStatus()
     Logger::debug(MQTT_TAG, "Published status: %s", buffer);
 }
 
+void MqttControl::publishBusStats(bool reset)
+{
+    if (!mqttClient.connected()) {
+        return;
+    }
+
+    JsonDocument doc;
+    JsonArray buses = doc["busStats"].to<JsonArray>();
+    // 报告约 1 KB，放在堆上避免占用任务栈
+    std::unique_ptr<BusStatsReport> report(new BusStatsReport());
+    for (size_t b = 0; b < controlManager->getBusCount(); ++b)
+    {
+        if (!controlManager->getBusStats(b, *report, reset)) {
+            continue;
+        }
+        JsonObject bus = buses.add<JsonObject>();
+        bus["bus"] = b;
+        bus["windowMs"] = report->windowMs;
+        bus["utilisation"] = report->utilisation;
+        bus["dropped"] = report->droppedRecords;
+        if (report->schedule.periodUs != 0) {
+            JsonObject schedule = bus["schedule"].to<JsonObject>();
+            schedule["periodUs"] = report->schedule.periodUs;
+            schedule["cycles"] = report->schedule.cycles;
+            for (size_t c = 0; c < static_cast<size_t>(BusClass::COUNT); ++c)
+            {
+                const BusSlotUsage& u = report->schedule.slots[c];
+                JsonArray row = schedule[busClassName(static_cast<BusClass>(c))].to<JsonArray>();
+                row.add(u.plannedUs);
+                row.add(u.avgUsedUs);
+                row.add(u.maxUsedUs);
+                row.add(u.transactions);
+                row.add(u.overrunCycles);
+                row.add(u.deferrals);
+            }
+        }
+        JsonArray entries = bus["entries"].to<JsonArray>();
+        for (size_t i = 0; i < report->entryCount; ++i)
+        {
+            const BusStatsSummary& s = report->entries[i];
+            JsonArray row = entries.add<JsonArray>();
+            row.add(s.address);
+            row.add(s.funcCode);
+            row.add(s.count);
+            row.add(s.retries);
+            row.add(s.timeouts);
+            row.add(s.checksumErrors);
+            row.add(s.rejected);
+            row.add(s.minUs);
+            row.add(s.avgUs);
+            row.add(s.p99Us);
+            row.add(s.maxUs);
+        }
+    }
+
+    // 统计数据可能超过 PubSubClient 的发送缓冲区，使用流式发布
+    mqttClient.beginPublish(MQTT_TOPIC_STATUS, measureJson(doc), false);
+    serializeJson(doc, mqttClient);
+    mqttClient.endPublish();
+}
+
+void MqttControl::publishEStopStats()
+{
+    if (!mqttClient.connected()) {
+        return;
+    }
+
+    EStopStats stats = controlManager->getEStopStats();
+    JsonDocument doc;
+    JsonObject estop = doc["estop"].to<JsonObject>();
+    estop["count"] = stats.count;
+    estop["lastUs"] = stats.lastUs;
+    estop["maxUs"] = stats.maxUs;
+    estop["avgUs"] = stats.avgUs;
+    estop["targetUs"] = CarController::ESTOP_TARGET_US;
+    estop["overTarget"] = stats.overTarget;
+    estop["unconfirmed"] = stats.unconfirmed;
+    estop["lastAttempts"] = stats.lastAttempts;
+    estop["lastMoving"] = stats.lastMovingMask;
+
+    mqttClient.beginPublish(MQTT_TOPIC_STATUS, measureJson(doc), false);
+    serializeJson(doc, mqttClient);
+    mqttClient.endPublish();
+}
+
+void MqttControl::publishLoopStats(bool reset)
+{
+    if (!mqttClient.connected()) {
+        return;
+    }
+
+    LoopStats stats = controlManager->getLoopStats(reset);
+    JsonDocument doc;
+    JsonObject loop = doc["loop"].to<JsonObject>();
+    loop["rateHz"] = stats.rateHz;
+    loop["periodUs"] = stats.periodUs;
+    loop["cycles"] = stats.cycles;
+    loop["overruns"] = stats.overruns;
+    loop["skipped"] = stats.skipped;
+    loop["commands"] = stats.commands;
+    loop["jitterAvgUs"] = stats.jitterAvgUs;
+    loop["jitterP99Us"] = stats.jitterP99Us;
+    loop["jitterMaxUs"] = stats.jitterMaxUs;
+    loop["workAvgUs"] = stats.workAvgUs;
+    loop["workP99Us"] = stats.workP99Us;
+    loop["workMaxUs"] = stats.workMaxUs;
+
+    mqttClient.beginPublish(MQTT_TOPIC_STATUS, measureJson(doc), false);
+    serializeJson(doc, mqttClient);
+    mqttClient.endPublish();
+}
+
+void MqttControl::publishParams(const char* name)
+{
+    if (!mqttClient.connected()) {
+        return;
+    }
+
+    JsonDocument doc;
+    JsonObject params = doc["params"].to<JsonObject>();
+    float value;
+    for (size_t i = 0; i < ParamStore::paramCount(); ++i)
+    {
+        const char* param = ParamStore::paramName(i);
+        if ((!name || strcmp(name, param) == 0) && controlManager->getParam(param, value)) {
+            params[param] = value;
+        }
+    }
+
+    // 全部参数约 200 字节，接近 JSON_BUFFER_SIZE，使用流式发布
+    mqttClient.beginPublish(MQTT_TOPIC_STATUS, measureJson(doc), false);
+    serializeJson(doc, mqttClient);
+    mqttClient.endPublish();
+}
+
 void MqttControl::mqttCallback(char *topic, byte *payload, unsigned int length)
 {
     Logger::info(MQTT_TAG, "Message arrived [%s]", topic);
@@ -227,6 +369,8 @@ void MqttControl::mqttCallback(char *topic, byte *payload, unsigned int length)
 void MqttControl::processCommand(const String& commandStr)
 {
     if (commandStr.length() == 0) return;
+    // 命令接收时刻，用于统计紧急停止延迟
+    const uint32_t receivedUs = micros();
     
     // 解析 JSON 数据
     JsonDocument doc;
@@ -247,36 +391,61 @@ void MqttControl::processCommand(const String& commandStr)
     // 根据命令调用 ControlManager 接口
     if (strcmp(command, "speed") == 0)
     {
-        float vx = doc["vx"] | 0.0;
-        float vy = doc["vy"] | 0.0;
-        float omega = doc["omega"] | 0.0;
-        float acceleration = doc["acceleration"] | 10.0;
-        uint16_t subdivision = doc["subdivision"] | 256;
+        JsonCommands::SpeedArgs a = JsonCommands::readSpeedArgs(doc);
         Logger::info(MQTT_TAG, "Executing speed command: vx=%.2f, vy=%.2f, omega=%.2f, subdivision=%d", 
-                    vx, vy, omega, subdivision);
-        controlManager->setSpeed(vx, vy, omega, acceleration, subdivision);
+                    a.vx, a.vy, a.omega, a.subdivision);
+        controlManager->setSpeed(a.vx, a.vy, a.omega, a.acceleration, a.subdivision);
     }
     else if (strcmp(command, "move") == 0)
     {
-        float dx = doc["dx"] | 0.0;
-        float dy = doc["dy"] | 0.0;
-        float dtheta = doc["dtheta"] | 0.0;
-        float speed = doc["speed"] | 1.0;
-        float acceleration = doc["acceleration"] | 10.0;
-        uint16_t subdivision = doc["subdivision"] | 256;
-        Logger::info(MQTT_TAG, "Executing move command: dx=%.2f, dy=%.2f, dtheta=%.2f, speed=%.2f", dx, dy, dtheta, speed);
-        controlManager->moveDistance(dx, dy, dtheta, acceleration, speed, subdivision);
+        JsonCommands::MoveArgs a = JsonCommands::readMoveArgs(doc);
+        Logger::info(MQTT_TAG, "Executing move command: dx=%.2f, dy=%.2f, dtheta=%.2f, speed=%.2f", a.dx, a.dy, a.dtheta, a.speed);
+        controlManager->moveDistance(a.dx, a.dy, a.dtheta, a.acceleration, a.speed, a.subdivision);
     }
     else if (strcmp(command, "stop") == 0)
     {
+        // 先停止再输出日志，日志不计入停止延迟
+        controlManager->stop(receivedUs);
         Logger::info(MQTT_TAG, "Executing stop command");
-        controlManager->stop();
     }
     else if (strcmp(command, "get_status") == 0)
     {
         Logger::info(MQTT_TAG, "Status request received");
         publishStatus();
     }
+    else if (strcmp(command, "get_bus_stats") == 0)
+    {
+        bool reset = doc["reset"] | false;
+        Logger::info(MQTT_TAG, "Bus stats request received, reset=%d", reset);
+        publishBusStats(reset);
+    }
+    else if (strcmp(command, "get_estop_stats") == 0)
+    {
+        Logger::info(MQTT_TAG, "E-stop stats request received");
+        publishEStopStats();
+    }
+    else if (strcmp(command, "get_loop_stats") == 0)
+    {
+        bool reset = doc["reset"] | false;
+        Logger::info(MQTT_TAG, "Loop stats request received, reset=%d", reset);
+        publishLoopStats(reset);
+    }
+    else if (strcmp(command, "set_param") == 0)
+    {
+        const char* name = doc["name"];
+        float value = doc["value"] | -1.0f;
+        bool save = doc["save"] | true;
+        Logger::info(MQTT_TAG, "Set param: %s=%.4f, save=%d", name ? name : "", value, save);
+        if (controlManager->setParam(name, value, save)) {
+            publishParams(name);
+        } else {
+            Logger::warn(MQTT_TAG, "Invalid parameter");
+        }
+    }
+    else if (strcmp(command, "get_param") == 0)
+    {
+        publishParams(doc["name"]);
+    }
     else if (strcmp(command, "set_interval") == 0)
     {
         // 处理设置状态发布间隔命令
@@ -2,11 +2,14 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <memory>
 #include "control/ControlManager.hpp"
+#include "protocol/JsonCommands.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "utils/Logger.hpp"
+#include "utils/BootProfiler.hpp"
 #include "config.h"
 
 /**
@@ -40,6 +43,34 @@ public:
      */
     void publishStatus();
 
+    /**
+     * @brief 发布电机总线事务统计到 USB（Serial）
+     * @param reset 发布后清零统计
+     */
+    void publishBusStats(bool reset);
+
+    /**
+     * @brief 发布启动阶段耗时（BootProfiler 里程碑）到 USB（Serial）
+     */
+    void publishBootProfile();
+
+    /**
+     * @brief 发布紧急停止统计到 USB（Serial）
+     */
+    void publishEStopStats();
+
+    /**
+     * @brief 发布控制循环统计到 USB（Serial）
+     * @param reset 读取后清零
+     */
+    void publishLoopStats(bool reset);
+
+    /**
+     * @brief 发布参数到 USB（Serial）
+     * @param name 参数名，为 nullptr 时发布全部参数
+     */
+    void publishParams(const char* name);
+
     /**
      * @brief 设置自动发送状态的时间间隔
      * @param interval_ms 间隔毫秒数（设置为0表示关闭自动发送）
@@ -146,6 +177,8 @@ bool UsbControl::connectToWiFi(const char* ssid, const char* password, int timeo
 
 void UsbControl::processCommand(const String& commandStr) {
     if (commandStr.length() == 0) return;
+    // 命令接收时刻，用于统计紧急停止延迟
+    const uint32_t receivedUs = micros();
     
     Logger::debug(USB_TAG, "Processing command: %s", commandStr.c_str());
     
@@ -166,33 +199,57 @@ void UsbControl::processCommand(const String& commandStr) {
     
     // 处理各种命令
     if (strcmp(command, "speed") == 0) {
-        float vx = doc["vx"] | 0.0;
-        float vy = doc["vy"] | 0.0;
-        float omega = doc["omega"] | 0.0;
-        float acceleration = doc["acceleration"] | 10.0;
-        uint16_t subdivision = doc["subdivision"] | 256;
+        JsonCommands::SpeedArgs a = JsonCommands::readSpeedArgs(doc);
         Logger::debug(USB_TAG, "Speed command: vx=%.2f, vy=%.2f, omega=%.2f, subdivision=%d", 
-                     vx, vy, omega, subdivision);
-        controlManager->setSpeed(vx, vy, omega, acceleration, subdivision);
+                     a.vx, a.vy, a.omega, a.subdivision);
+        controlManager->setSpeed(a.vx, a.vy, a.omega, a.acceleration, a.subdivision);
     } 
     else if (strcmp(command, "move") == 0) {
-        float dx = doc["dx"] | 0.0;
-        float dy = doc["dy"] | 0.0;
-        float dtheta = doc["dtheta"] | 0.0;
-        float speed = doc["speed"] | 1.0;
-        float acceleration = doc["acceleration"] | 10.0;
-        uint16_t subdivision = doc["subdivision"] | 256;
-        Logger::debug(USB_TAG, "Move command: dx=%.2f, dy=%.2f, dtheta=%.2f, speed=%.2f", dx, dy, dtheta, speed);
-        controlManager->moveDistance(dx, dy, dtheta, acceleration, speed, subdivision);
+        JsonCommands::MoveArgs a = JsonCommands::readMoveArgs(doc);
+        Logger::debug(USB_TAG, "Move command: dx=%.2f, dy=%.2f, dtheta=%.2f, speed=%.2f", a.dx, a.dy, a.dtheta, a.speed);
+        controlManager->moveDistance(a.dx, a.dy, a.dtheta, a.acceleration, a.speed, a.subdivision);
     } 
     else if (strcmp(command, "stop") == 0) {
+        // 先停止再输出日志，日志不计入停止延迟
+        controlManager->stop(receivedUs);
         Logger::debug(USB_TAG, "Stop command");
-        controlManager->stop();
     } 
     else if (strcmp(command, "get_status") == 0) {
         Logger::debug(USB_TAG, "Status request");
         publishStatus();
     } 
+    else if (strcmp(command, "get_bus_stats") == 0) {
+        bool reset = doc["reset"] | false;
+        Logger::debug(USB_TAG, "Bus stats request, reset=%d", reset);
+        publishBusStats(reset);
+    }
+    else if (strcmp(command, "get_estop_stats") == 0) {
+        Logger::debug(USB_TAG, "E-stop stats request");
+        publishEStopStats();
+    }
+    else if (strcmp(command, "get_loop_stats") == 0) {
+        bool reset = doc["reset"] | false;
+        Logger::debug(USB_TAG, "Loop stats request, reset=%d", reset);
+        publishLoopStats(reset);
+    }
+    else if (strcmp(command, "get_boot_profile") == 0) {
+        Logger::debug(USB_TAG, "Boot profile request");
+        publishBootProfile();
+    }
+    else if (strcmp(command, "set_param") == 0) {
+        const char* name = doc["name"];
+        float value = doc["value"] | -1.0f;
+        bool save = doc["save"] | true;
+        Logger::debug(USB_TAG, "Set param: %s=%.4f, save=%d", name ? name : "", value, save);
+        if (controlManager->setParam(name, value, save)) {
+            publishParams(name);
+        } else {
+            Logger::warn(USB_TAG, "Invalid parameter");
+        }
+    }
+    else if (strcmp(command, "get_param") == 0) {
+        publishParams(doc["name"]);
+    }
     else if (strcmp(command, "set_interval") == 0) {
         // 设置自动发送状态的间隔
         uint32_t interval = doc["interval"] | 0;
@@ -216,18 +273,131 @@ void UsbControl::processCommand(const String& commandStr) {
 
 void UsbControl::publishStatus() {
     // 获取当前小车状态 - 从控制管理器获取
-    CarState state = controlManager->getCarState();
+    CarStateSnapshot snapshot = controlManager->getCarStateSnapshot();
     JsonDocument doc;
-    doc["vx"] = state.vx;
-    doc["vy"] = state.vy;
-    doc["omega"] = state.omega;
-    JsonArray speeds = doc["wheelSpeeds"].to<JsonArray>();
-    for (auto speed : state.wheelSpeeds) {
-        speeds.add(speed);
-    }
+    JsonCommands::writeStatus(doc, snapshot.value, snapshot.sequence, snapshot.timestampUs);
     char buffer[USB_JSON_BUFFER_SIZE];
     size_t n = serializeJson(doc, buffer);
     
     // 将 JSON 状态数据发送到 USB 虚拟串口
     Serial.println(buffer);
 }
+
+void UsbControl::publishBusStats(bool reset) {
+    JsonDocument doc;
+    JsonArray buses = doc["busStats"].to<JsonArray>();
+    // 报告约 1 KB，放在堆上避免占用任务栈
+    std::unique_ptr<BusStatsReport> report(new BusStatsReport());
+    for (size_t b = 0; b < controlManager->getBusCount(); ++b) {
+        if (!controlManager->getBusStats(b, *report, reset)) {
+            continue;
+        }
+        JsonObject bus = buses.add<JsonObject>();
+        bus["bus"] = b;
+        bus["windowMs"] = report->windowMs;
+        bus["utilisation"] = report->utilisation;
+        bus["dropped"] = report->droppedRecords;
+        if (report->schedule.periodUs != 0) {
+            JsonObject schedule = bus["schedule"].to<JsonObject>();
+            schedule["periodUs"] = report->schedule.periodUs;
+            schedule["cycles"] = report->schedule.cycles;
+            for (size_t c = 0; c < static_cast<size_t>(BusClass::COUNT); ++c) {
+                const BusSlotUsage& u = report->schedule.slots[c];
+                JsonArray row = schedule[busClassName(static_cast<BusClass>(c))].to<JsonArray>();
+                row.add(u.plannedUs);
+                row.add(u.avgUsedUs);
+                row.add(u.maxUsedUs);
+                row.add(u.transactions);
+                row.add(u.overrunCycles);
+                row.add(u.deferrals);
+            }
+        }
+        JsonArray entries = bus["entries"].to<JsonArray>();
+        for (size_t i = 0; i < report->entryCount; ++i) {
+            const BusStatsSummary& s = report->entries[i];
+            JsonArray row = entries.add<JsonArray>();
+            row.add(s.address);
+            row.add(s.funcCode);
+            row.add(s.count);
+            row.add(s.retries);
+            row.add(s.timeouts);
+            row.add(s.checksumErrors);
+            row.add(s.rejected);
+            row.add(s.minUs);
+            row.add(s.avgUs);
+            row.add(s.p99Us);
+            row.add(s.maxUs);
+        }
+    }
+
+    // 统计数据长度随电机与功能码数量变化，直接流式写出
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+void UsbControl::publishEStopStats() {
+    EStopStats stats = controlManager->getEStopStats();
+    JsonDocument doc;
+    JsonObject estop = doc["estop"].to<JsonObject>();
+    estop["count"] = stats.count;
+    estop["lastUs"] = stats.lastUs;
+    estop["maxUs"] = stats.maxUs;
+    estop["avgUs"] = stats.avgUs;
+    estop["targetUs"] = CarController::ESTOP_TARGET_US;
+    estop["overTarget"] = stats.overTarget;
+    estop["unconfirmed"] = stats.unconfirmed;
+    estop["lastAttempts"] = stats.lastAttempts;
+    estop["lastMoving"] = stats.lastMovingMask;
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+void UsbControl::publishLoopStats(bool reset) {
+    LoopStats stats = controlManager->getLoopStats(reset);
+    JsonDocument doc;
+    JsonObject loop = doc["loop"].to<JsonObject>();
+    loop["rateHz"] = stats.rateHz;
+    loop["periodUs"] = stats.periodUs;
+    loop["cycles"] = stats.cycles;
+    loop["overruns"] = stats.overruns;
+    loop["skipped"] = stats.skipped;
+    loop["commands"] = stats.commands;
+    loop["jitterAvgUs"] = stats.jitterAvgUs;
+    loop["jitterP99Us"] = stats.jitterP99Us;
+    loop["jitterMaxUs"] = stats.jitterMaxUs;
+    loop["workAvgUs"] = stats.workAvgUs;
+    loop["workP99Us"] = stats.workP99Us;
+    loop["workMaxUs"] = stats.workMaxUs;
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+void UsbControl::publishBootProfile() {
+    JsonDocument doc;
+    JsonArray milestones = doc["boot"].to<JsonArray>();
+    for (size_t i = 0; i < BootProfiler::count(); ++i) {
+        BootProfiler::Milestone m = BootProfiler::at(i);
+        if (!m.name) {
+            continue;
+        }
+        JsonArray row = milestones.add<JsonArray>();
+        row.add(m.name);
+        row.add(m.us);
+    }
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+void UsbControl::publishParams(const char* name) {
+    JsonDocument doc;
+    JsonObject params = doc["params"].to<JsonObject>();
+    float value;
+    for (size_t i = 0; i < ParamStore::paramCount(); ++i) {
+        const char* param = ParamStore::paramName(i);
+        if ((!name || strcmp(name, param) == 0) && controlManager->getParam(param, value)) {
+            params[param] = value;
+        }
+    }
+    serializeJson(doc, Serial);
+    Serial.println();
+}
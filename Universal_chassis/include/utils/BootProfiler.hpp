@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "utils/Logger.hpp"
+
+/**
+ * @brief 启动阶段耗时记录
+ *
+ * 各启动阶段完成时调用 mark() 记录里程碑及其时刻（micros()，自芯片复位后计时器启动起的微秒数）。
+ * 可在任意任务中调用，无锁、无堆分配；超过 MAX_MILESTONES 的里程碑被忽略。
+ */
+class BootProfiler {
+public:
+    static constexpr size_t MAX_MILESTONES = 16;
+
+    struct Milestone {
+        const char* name;   // 里程碑名称（须为静态字符串）
+        uint32_t us;        // 记录时刻（微秒）
+    };
+
+    // 记录一个里程碑
+    static void mark(const char* name) {
+        const uint32_t now = micros();
+        size_t slot = used.fetch_add(1);
+        if (slot >= MAX_MILESTONES) {
+            return;
+        }
+        milestones[slot].us = now;
+        milestones[slot].name = name;
+    }
+
+    // 已记录的里程碑数量
+    static size_t count() {
+        size_t n = used.load();
+        return n < MAX_MILESTONES ? n : MAX_MILESTONES;
+    }
+
+    // 第 index 个里程碑（另一任务正在写入时 name 可能为 nullptr）
+    static Milestone at(size_t index) {
+        return index < count() ? milestones[index] : Milestone{nullptr, 0};
+    }
+
+    // 按记录顺序输出全部里程碑到日志
+    static void report() {
+        for (size_t i = 0; i < count(); ++i) {
+            Milestone m = at(i);
+            if (m.name) {
+                Logger::info("BOOT", "%-14s %8lu us", m.name, static_cast<unsigned long>(m.us));
+            }
+        }
+    }
+
+private:
+    static Milestone milestones[MAX_MILESTONES];
+    static std::atomic<size_t> used;
+};
+
+// 定义静态成员变量
+inline BootProfiler::Milestone BootProfiler::milestones[BootProfiler::MAX_MILESTONES] = {};
+inline std::atomic<size_t> BootProfiler::used{0};
@@ -87,18 +87,27 @@ private:
 
     // 内部日志输出函数
     static void log(const char* tag, const char* level, const char* format, va_list args) {
-        // 计算所需缓冲区大小
+        // 计算所需缓冲区大小（va_list 只能遍历一次，第二次格式化使用副本）
+        va_list copy;
+        va_copy(copy, args);
         char temp[2];  // 用于测试大小的临时缓冲区
         int len = vsnprintf(temp, sizeof(temp), format, args);
-        if (len < 0) return;  // 格式化错误
+        if (len < 0) {  // 格式化错误
+            va_end(copy);
+            return;
+        }
         
         // 创建足够大的缓冲区
         size_t size = len + 1;
         char* buffer = (char*)malloc(size);
-        if (!buffer) return;  // 内存分配失败
+        if (!buffer) {  // 内存分配失败
+            va_end(copy);
+            return;
+        }
         
         // 格式化消息
-        vsnprintf(buffer, size, format, args);
+        vsnprintf(buffer, size, format, copy);
+        va_end(copy);
         
         // 输出到串口
         Serial.printf("[%s][%s] %s\n", level, tag, buffer);
@@ -108,4 +117,4 @@ private:
 };
 
 // 定义静态成员变量
-LogLevel Logger::logLevel = LOG_LEVEL_INFO; 
\ No newline at end of file
+inline LogLevel Logger::logLevel = LOG_LEVEL_INFO; 
\ No newline at end of file
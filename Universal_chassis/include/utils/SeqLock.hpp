@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 顺序锁保护的单值单元：写入者覆盖，读取者取最新值，均无锁、无堆分配
+ *
+ * 写入时序号先变为奇数、写完数据后再加 1 变为偶数；读取者在前后两次读到相同的偶数序号时得到一致的副本。
+ * 数据按 32 位原子字复制，读写并发时没有数据竞争（可在 ThreadSanitizer 下运行）。
+ *
+ * 与互斥锁不同，读写双方都不会阻塞：
+ *  - 多个写入者同时写入时，后到者放弃本次写入并返回 false（并发的两次写入本就没有先后，
+ *    等价于后到者先写入、随即被覆盖）；不允许丢失写入的调用者检查返回值并重试；
+ *  - 写入者在写入中途被抢占时，读取者返回 false 而不是自旋等待（同一核心上自旋会等不到写入者恢复），
+ *    调用者稍后重试即可。
+ *
+ * T 须可平凡复制。
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    /**
+     * @brief 覆盖当前值（任意任务）
+     * @return false 表示另一写入者正在写入，本次写入被放弃
+     */
+    bool write(const T& value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        if ((seq & 1) || !sequence.compare_exchange_strong(seq, seq + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        // 序号变为奇数先于数据写入对读取者可见
+        std::atomic_thread_fence(std::memory_order_release);
+        uint32_t buffer[WORDS] = {};
+        memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 读取当前值
+     * @return false 表示尚未写入过，或写入正在进行（out 未修改）
+     */
+    bool read(T& out) const {
+        const uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1)) {
+            return false;
+        }
+        uint32_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        // 数据读取先于再次读取序号
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    // 已完成的写入次数（回绕），可用于判断值是否更新
+    uint32_t version() const {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> words[WORDS] = {};
+};
+
+/**
+ * @brief 带发布序号与时间戳的快照
+ */
+template <typename T>
+struct Snapshot {
+    T value{};
+    uint32_t sequence = 0;      // 发布序号，从 1 开始递增；0 表示尚未发布
+    uint32_t timestampUs = 0;   // 发布时刻（发布者给出，如 micros()）
+};
+
+/**
+ * @brief 单写多读的双缓冲发布：写入者交替写两个槽位，写完后才把读取者指向新槽位
+ *
+ * 每个槽位各带一个顺序锁序号。读取者只读已发布的槽位，写入者写的是另一个，因此读取者不等待进行中的写入；
+ * 只有一次读取期间写入者连续发布两次、回到同一槽位时才需重读，重读得到的是更新的快照，
+ * 即使读取者优先级更高、写入者停在写入中途也不会自旋。写入者从不等待读取者，耗时固定。
+ *
+ * 只允许一个写入任务；T 须可平凡复制。
+ */
+template <typename T>
+class DoubleBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "DoubleBuffer requires a trivially copyable type");
+
+public:
+    // 发布新值（仅写入任务）
+    void publish(const T& value, uint32_t timestampUs) {
+        uint32_t seq = published.load(std::memory_order_relaxed) + 1;
+        if (seq == 0) {
+            seq = 2;    // 回绕时跳过 0（0 表示尚未发布），并保持两个槽位交替
+        }
+        Slot& slot = slots[seq & 1];
+        slot.guard.store((seq << 1) | 1, std::memory_order_relaxed);
+        // 槽位序号变为奇数先于数据写入对读取者可见
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Snapshot<T> entry;
+        entry.value = value;
+        entry.sequence = seq;
+        entry.timestampUs = timestampUs;
+        uint32_t buffer[WORDS] = {};
+        memcpy(buffer, &entry, sizeof(entry));
+        for (size_t i = 0; i < WORDS; ++i) {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        slot.guard.store(seq << 1, std::memory_order_release);
+        published.store(seq, std::memory_order_release);
+    }
+
+    // 读取最新发布的快照（任意任务）；尚未发布时返回值初始化的快照（sequence 为 0）
+    Snapshot<T> read() const {
+        Snapshot<T> out;
+        for (;;) {
+            const uint32_t seq = published.load(std::memory_order_acquire);
+            if (seq == 0) {
+                return out;
+            }
+            const Slot& slot = slots[seq & 1];
+            const uint32_t guard = slot.guard.load(std::memory_order_acquire);
+            if (guard != (seq << 1)) {
+                continue;   // 写入者已回到该槽位，此时另一槽位已发布更新的快照
+            }
+            uint32_t buffer[WORDS];
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            // 数据读取先于再次读取槽位序号
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.guard.load(std::memory_order_relaxed) == guard) {
+                memcpy(&out, buffer, sizeof(out));
+                return out;
+            }
+        }
+    }
+
+    // 最新发布序号，0 表示尚未发布
+    uint32_t sequence() const {
+        return published.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(Snapshot<T>) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    struct Slot {
+        std::atomic<uint32_t> guard{0};     // 序号 × 2，写入中为奇数
+        std::atomic<uint32_t> words[WORDS] = {};
+    };
+
+    Slot slots[2];
+    std::atomic<uint32_t> published{0};
+};
@@ -0,0 +1,78 @@
+/*
+ * @Description: Arduino 主机垫片（[env:native]）
+ *
+ * 只提供控制栈与其依赖库（ArduinoJson、PubSubClient）用到的部分：计时与延时、String、Print/Stream 基类、HardwareSerial。
+ * millis()/micros() 与 ESP32 一样为 32 位计数（自进程启动起），按无符号差值计算间隔的代码在回绕时行为一致。
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "WString.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// 主机上没有独立的程序存储区
+#define PROGMEM
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+class Print {
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (n < size && write(buffer[n])) {
+            ++n;
+        }
+        return n;
+    }
+    size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0; }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str()); }
+    size_t println(const char* str = "") { return write(str) + write("\r\n"); }
+    size_t println(const String& str) { return println(str.c_str()); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+
+    // 读取至多 length 个已到达的字节（不等待）
+    size_t readBytes(char* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length && available() > 0) {
+            int b = read();
+            if (b < 0) {
+                break;
+            }
+            buffer[n++] = static_cast<char>(b);
+        }
+        return n;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes(reinterpret_cast<char*>(buffer), length); }
+};
+
+#include "HardwareSerial.h"
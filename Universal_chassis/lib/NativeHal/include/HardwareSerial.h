@@ -0,0 +1,79 @@
+/*
+ * @Description: HardwareSerial 主机垫片
+ *
+ * 串口号 n 映射到环境变量 UC_SERIAL<n> 指定的设备（如 /dev/ttyUSB0 或 sim/emm42_pty 的从设备），
+ * begin() 时以原始模式打开并设置波特率；未指定设备时为空设备（写入丢弃、没有可读数据）。
+ * Serial 对应 ESP32-S3 的 USB 虚拟串口（与 UART 0 无关）：设备由 UC_USB 指定，未指定时使用标准输入/输出。
+ *
+ * 主机仿真程序可以用 attachBackend() 为串口指定 SerialBackend（如 sim/ 的驱动器仿真），优先于设备文件。
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#define SERIAL_8N1 0x800001c
+
+// UART 0 默认引脚（ESP32-S3 板级 pins_arduino.h），主机上不使用
+static const uint8_t TX = 43;
+static const uint8_t RX = 44;
+
+// 串口后端：由主机仿真程序实现，替代设备文件
+class SerialBackend {
+public:
+    virtual ~SerialBackend() = default;
+    // begin() / updateBaudRate() 时通知波特率
+    virtual void setBaud(uint32_t baud) { (void)baud; }
+    virtual size_t write(const uint8_t* data, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    // 等待已写入的数据发送完成
+    virtual void flush() {}
+};
+
+class HardwareSerial : public Stream {
+public:
+    // USB 虚拟串口（Serial）的串口号
+    static constexpr int USB_CDC = -1;
+
+    explicit HardwareSerial(int uartNum) : uartNum(uartNum) {}
+    ~HardwareSerial() override;
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1,
+               bool invert = false, unsigned long timeoutMs = 20000UL, uint8_t rxfifoFullThrhd = 112);
+    void end();
+    void updateBaudRate(unsigned long baud);
+    uint32_t baudRate() { return baud; }
+    size_t setRxBufferSize(size_t size) { return size; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    // 等待发送完成
+    void flush() override;
+
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    operator bool() const { return backend || readFd >= 0 || writeFd >= 0; }
+
+    /**
+     * @brief 为串口号 uartNum（USB_CDC 表示 Serial）指定后端，在该串口 begin() 时生效；nullptr 取消
+     */
+    static void attachBackend(int uartNum, SerialBackend* backend);
+
+private:
+    // 读入一个字节到 peeked，无数据返回 false
+    bool fill();
+
+    int uartNum;
+    uint32_t baud = 0;
+    SerialBackend* backend = nullptr;
+    int readFd = -1;
+    int writeFd = -1;
+    bool ownsFd = false;        // 打开的设备（标准输入/输出不关闭）
+    int peeked = -1;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,31 @@
+/*
+ * @Description: IPAddress 主机垫片（IPv4）
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return octets[index]; }
+    uint8_t& operator[](int index) { return octets[index]; }
+    bool operator==(const IPAddress& other) const {
+        return octets[0] == other.octets[0] && octets[1] == other.octets[1] &&
+               octets[2] == other.octets[2] && octets[3] == other.octets[3];
+    }
+
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+
+private:
+    uint8_t octets[4] = {0, 0, 0, 0};
+};
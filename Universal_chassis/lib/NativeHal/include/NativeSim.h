@@ -0,0 +1,71 @@
+/*
+ * @Description: NativeHal 虚拟时间调度
+ *
+ * 默认情况下任务是并发运行的 std::thread，时间取系统单调时钟。开启虚拟时间后：
+ *  - 同一时刻只有一个任务运行，按优先级调度（高优先级就绪即抢占，同优先级按节拍轮转），
+ *    与单核 FreeRTOS 的调度顺序一致；
+ *  - 时间只在任务阻塞（延时、等待队列/信号量/通知）或调用计时函数时推进：所有任务都阻塞时
+ *    直接跳到最近的唤醒时刻，相同输入下运行结果逐次相同，并可快于真实时间运行；
+ *  - micros()/millis() 每次调用计 1 µs CPU 时间，delayMicroseconds() 按忙等计入，保证轮询循环能推进时间。
+ *
+ * 抢占只发生在调用 FreeRTOS / 计时接口时（唤醒其他任务、读取时间），不会打断纯计算。
+ * 虚拟时间模式下只有任务线程（xTaskCreate 创建的线程与调用 beginVirtualTime 的线程）可以调用 FreeRTOS 接口。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "freertos/FreeRTOS.h"
+
+namespace NativeSim {
+
+/**
+ * @brief 开启虚拟时间调度，须在创建任何任务之前调用
+ * @param mainTaskName 调用线程登记的任务名（如 Arduino 的 "loopTask"）
+ * @param mainPriority 调用线程的任务优先级
+ * @param speed 虚拟时间相对真实时间的最高倍数：1 为实时（配合串口、网络等外部输入），0 为不限速
+ */
+void beginVirtualTime(const char* mainTaskName, UBaseType_t mainPriority, double speed);
+
+// 是否处于虚拟时间模式
+bool virtualTime();
+
+// 自启动起的微秒数（虚拟时间模式下为虚拟时钟，只读，不计 CPU 时间）
+uint64_t nowUs();
+
+// 当前任务阻塞到 us 时刻（让出 CPU）；实时模式下休眠
+void sleepUntilUs(uint64_t us);
+
+// 当前任务占用 CPU us 微秒（忙等，期间更高优先级的任务可抢占）；实时模式下忙等
+void busyUs(uint32_t us);
+
+// 任务调度统计（只在虚拟时间模式下累计）
+struct TaskStats {
+    const char* name;
+    UBaseType_t priority;
+    bool finished;              // 任务函数已返回或已删除
+    uint32_t runs;              // 被调度运行的次数
+    uint64_t cpuUs;             // 运行期间经过的虚拟时间
+    uint64_t readyWaitTotalUs;  // 就绪到开始运行的累计等待
+    uint64_t readyWaitMaxUs;    // 就绪到开始运行的最长等待
+    uint64_t maxGapUs;          // 相邻两次开始运行的最大间隔（含阻塞时间）
+};
+
+// 队列深度统计（两种模式都累计）
+struct QueueStats {
+    const char* name;           // vQueueAddToRegistry 登记的名称，未登记为 nullptr
+    UBaseType_t length;
+    UBaseType_t waiting;        // 当前元素数
+    UBaseType_t highWater;      // 最大元素数
+    uint32_t sends;             // 成功写入次数
+    uint32_t fullRejects;       // 队列满导致的写入失败次数
+};
+
+// 按创建顺序填写至多 max 个任务的统计，返回任务总数
+size_t taskStats(TaskStats* out, size_t max);
+
+// 按创建顺序填写至多 max 个队列的统计，返回队列总数
+size_t queueStats(QueueStats* out, size_t max);
+
+} // namespace NativeSim
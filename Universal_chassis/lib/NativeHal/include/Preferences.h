@@ -0,0 +1,31 @@
+/*
+ * @Description: Preferences（NVS）主机垫片
+ *
+ * 设置环境变量 UC_NVS_DIR 时每个键保存为 <UC_NVS_DIR>/<命名空间>.<键>.bin，跨进程保留；
+ * 否则保存在进程内存中。只实现二进制块接口。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    bool isKey(const char* key);
+    bool remove(const char* key);
+
+private:
+    std::string path(const char* key) const;
+
+    std::string ns;
+    bool opened = false;
+    bool readOnly = false;
+};
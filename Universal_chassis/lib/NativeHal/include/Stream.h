@@ -0,0 +1,7 @@
+/*
+ * @Description: Stream 主机垫片（Print / Stream 定义在 Arduino.h 中）
+ */
+
+#pragma once
+
+#include "Arduino.h"
@@ -0,0 +1,62 @@
+/*
+ * @Description: Arduino String 主机垫片（std::string 实现，只含控制栈与 ArduinoJson 用到的接口）
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+class String {
+public:
+    String() = default;
+    String(const char* str) : value(str ? str : "") {}
+    explicit String(char c) : value(1, c) {}
+
+    String& operator=(const char* str) {
+        value = str ? str : "";
+        return *this;
+    }
+
+    String& operator+=(char c) {
+        value.push_back(c);
+        return *this;
+    }
+    String& operator+=(const char* str) {
+        if (str) {
+            value += str;
+        }
+        return *this;
+    }
+    String& operator+=(const String& other) {
+        value += other.value;
+        return *this;
+    }
+
+    bool concat(char c) {
+        value.push_back(c);
+        return true;
+    }
+    bool concat(const char* str, size_t length) {
+        value.append(str, length);
+        return true;
+    }
+    bool concat(const char* str) { return str ? concat(str, strlen(str)) : false; }
+
+    bool reserve(size_t size) {
+        value.reserve(size);
+        return true;
+    }
+
+    const char* c_str() const { return value.c_str(); }
+    size_t length() const { return value.size(); }
+    char operator[](size_t index) const { return index < value.size() ? value[index] : '\0'; }
+
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* str) const { return str && value == str; }
+    bool operator!=(const String& other) const { return value != other.value; }
+
+private:
+    std::string value;
+};
@@ -0,0 +1,104 @@
+/*
+ * @Description: WiFi / WiFiClient 主机垫片
+ *
+ * WiFi 的连接状态由主机程序控制：begin() 后经过关联时间（默认 1500 ms）变为 WL_CONNECTED；
+ * setLinkUp(false) 模拟接入点丢失，状态变为 WL_CONNECTION_LOST 并断开全部 TCP 连接，
+ * 恢复后与 ESP32 的自动重连一样再经过关联时间重新连上。
+ *
+ * WiFiClient 使用主机的 TCP 套接字（非阻塞收发）。连接的目标主机由环境变量 UC_NET_HOST 替换
+ * （如 127.0.0.1，端口不变），用于把 config.h 中的 MQTT Broker 指向本机 Broker；
+ * 未设置时所有连接按不可达处理（等待连接超时后失败），仿真不会访问外部网络。
+ * 虚拟时间模式下连接耗时按固定值计入虚拟时间：成功或被拒绝为 CONNECT_US，不可达为连接超时。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include "Arduino.h"
+#include "Client.h"
+#include "IPAddress.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    IPAddress localIP();
+
+    // ---- 主机扩展 ----
+
+    /**
+     * @brief 接入点可用 / 丢失（默认可用）
+     */
+    void setLinkUp(bool up);
+    bool linkUp();
+
+    /**
+     * @brief begin() 或链路恢复到 WL_CONNECTED 的关联时间
+     */
+    void setAssociateMs(uint32_t ms);
+
+    /**
+     * @brief 链路代数：每次丢失加 1，WiFiClient 据此判断连接是否已随链路断开
+     */
+    uint32_t linkGeneration();
+
+private:
+    std::mutex mutex;
+    bool wanted = false;            // 已调用 begin()，链路恢复后自动重连
+    bool up = true;
+    bool everConnected = false;
+    uint64_t readyUs = 0;           // 关联完成时刻
+    uint32_t associateUs = 1500000;
+    uint32_t generation = 0;
+};
+
+extern WiFiClass WiFi;
+
+class WiFiClient : public Client {
+public:
+    // 虚拟时间模式下连接建立（或被拒绝）计入的耗时
+    static constexpr uint32_t CONNECT_US = 2000;
+    // 与 ESP32 WiFiClient 默认值一致
+    static constexpr uint32_t DEFAULT_CONNECT_TIMEOUT_MS = 3000;
+
+    WiFiClient() = default;
+    ~WiFiClient() override;
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    void setConnectTimeout(uint32_t ms) { connectTimeoutMs = ms; }
+
+private:
+    // 链路已丢失时关闭套接字
+    bool alive();
+
+    int fd = -1;
+    uint32_t generation = 0;
+    uint32_t connectTimeoutMs = DEFAULT_CONNECT_TIMEOUT_MS;
+};
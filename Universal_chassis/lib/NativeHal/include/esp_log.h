@@ -0,0 +1,19 @@
+/*
+ * @Description: ESP-IDF 日志接口主机垫片（日志统一由 Logger 经 Serial 输出，此处不做处理）
+ */
+
+#pragma once
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+inline void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    (void)tag;
+    (void)level;
+}
@@ -0,0 +1,34 @@
+/*
+ * @Description: FreeRTOS 主机垫片：基本类型与常量
+ *
+ * 只用于 [env:native]。任务、队列与信号量由 std::thread / std::mutex / std::condition_variable 实现
+ * （NativeRtos.cpp），语义与 FreeRTOS 一致的部分：
+ *  - 节拍 1 ms（与 ESP32 Arduino 的 configTICK_RATE_HZ 相同），portMAX_DELAY 表示无限等待；
+ *  - 互斥量允许在其他任务中释放（按二值信号量实现），不支持递归获取；
+ *  - 栈大小被忽略；默认调度交给操作系统（优先级无效），NativeSim::beginVirtualTime 开启虚拟时间后
+ *    按优先级逐个运行任务（见 NativeSim.h）。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE  ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define errQUEUE_FULL  ((BaseType_t)0)
+#define errQUEUE_EMPTY ((BaseType_t)0)
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTICKS_TO_MS(ticks) ((TickType_t)(((TickType_t)(ticks) * (TickType_t)1000U) / (TickType_t)configTICK_RATE_HZ))
+
+#define tskNO_AFFINITY 0x7FFFFFFF
@@ -0,0 +1,32 @@
+/*
+ * @Description: FreeRTOS 主机垫片：队列（按值拷贝的定长元素）
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+struct NativeQueue;
+typedef NativeQueue* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait);
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticksToWait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticksToWait);
+
+// 长度为 1 的队列：覆盖已有元素
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item);
+
+// 为队列登记名称（NativeSim::queueStats 报告中使用）
+void vQueueAddToRegistry(QueueHandle_t queue, const char* name);
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return xQueueSendToBack(queue, item, ticksToWait);
+}
@@ -0,0 +1,21 @@
+/*
+ * @Description: FreeRTOS 主机垫片：信号量与互斥量
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+struct NativeSemaphore;
+typedef NativeSemaphore* SemaphoreHandle_t;
+
+// 互斥量：初始可获取，最大计数 1
+SemaphoreHandle_t xSemaphoreCreateMutex();
+// 二值信号量：初始不可获取
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore);
@@ -0,0 +1,49 @@
+/*
+ * @Description: FreeRTOS 主机垫片：任务、延时与任务通知
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+struct NativeTask;
+typedef NativeTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+/**
+ * @brief 创建任务（独立线程）
+ *
+ * 任务函数返回或调用 vTaskDelete(NULL) 后线程结束；任务句柄在进程生命周期内有效。
+ */
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle);
+
+// ESP32 双核扩展：核心号被忽略
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId);
+
+/**
+ * @brief 删除任务
+ *
+ * 只支持删除自身（NULL 或自身句柄），立即结束调用线程；删除其他任务时该任务在下一次延时或等待通知时结束。
+ */
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+
+// 以 *previousWakeTime 为基准等待 increment 个节拍，并更新基准；已错过唤醒时刻时立即返回 pdFALSE
+BaseType_t xTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+
+TickType_t xTaskGetTickCount();
+
+// 当前任务句柄；非 xTaskCreate 创建的线程（如 main）首次调用时登记
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+const char* pcTaskGetName(TaskHandle_t task);
+
+// 任务通知（计数语义）
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+
+void taskYIELD();
@@ -0,0 +1,70 @@
+#include "Arduino.h"
+#include "NativeSim.h"
+#include <thread>
+
+namespace {
+
+// 读取时间（自进程启动起，对应 ESP32 的芯片复位）；虚拟时间模式下每次读取计 1 µs CPU 时间，
+// 轮询时间的循环因此总能推进时钟
+uint64_t elapsedUs() {
+    if (NativeSim::virtualTime()) {
+        NativeSim::busyUs(1);
+    }
+    return NativeSim::nowUs();
+}
+
+} // namespace
+
+uint32_t millis() {
+    return static_cast<uint32_t>(elapsedUs() / 1000);
+}
+
+uint32_t micros() {
+    return static_cast<uint32_t>(elapsedUs());
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// 与 ESP32 一样忙等，保证微秒级精度
+void delayMicroseconds(uint32_t us) {
+    NativeSim::busyUs(us);
+}
+
+void yield() {
+    if (NativeSim::virtualTime()) {
+        taskYIELD();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+size_t Print::printf(const char* format, ...) {
+    char local[256];
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(local, sizeof(local), format, args);
+    va_end(args);
+    if (len < 0) {
+        va_end(copy);
+        return 0;
+    }
+    size_t written;
+    if (static_cast<size_t>(len) < sizeof(local)) {
+        written = write(reinterpret_cast<const uint8_t*>(local), static_cast<size_t>(len));
+    } else {
+        char* buffer = static_cast<char*>(malloc(static_cast<size_t>(len) + 1));
+        if (!buffer) {
+            va_end(copy);
+            return 0;
+        }
+        vsnprintf(buffer, static_cast<size_t>(len) + 1, format, copy);
+        written = write(reinterpret_cast<const uint8_t*>(buffer), static_cast<size_t>(len));
+        free(buffer);
+    }
+    va_end(copy);
+    return written;
+}
@@ -0,0 +1,197 @@
+#include "HardwareSerial.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+HardwareSerial Serial(HardwareSerial::USB_CDC);
+
+namespace {
+
+// 串口号 → 后端（下标 0 为 USB 虚拟串口）
+constexpr int MAX_UARTS = 8;
+SerialBackend* backends[MAX_UARTS + 1] = {};
+
+// 数值波特率到 termios 常量，不支持的速率返回 0
+speed_t speedOf(unsigned long baud) {
+    switch (baud) {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        default:      return 0;
+    }
+}
+
+void applyBaud(int fd, unsigned long baud) {
+    struct termios tio;
+    const speed_t speed = speedOf(baud);
+    if (fd < 0 || !isatty(fd) || speed == 0 || tcgetattr(fd, &tio) != 0) {
+        return;
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+} // namespace
+
+HardwareSerial::~HardwareSerial() {
+    end();
+}
+
+void HardwareSerial::attachBackend(int uartNum, SerialBackend* backend) {
+    if (uartNum >= USB_CDC && uartNum < MAX_UARTS) {
+        backends[uartNum + 1] = backend;
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin, bool invert,
+                           unsigned long timeoutMs, uint8_t rxfifoFullThrhd) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    (void)invert;
+    (void)timeoutMs;
+    (void)rxfifoFullThrhd;
+    end();
+    this->baud = static_cast<uint32_t>(baud);
+
+    if (uartNum >= USB_CDC && uartNum < MAX_UARTS && backends[uartNum + 1]) {
+        backend = backends[uartNum + 1];
+        backend->setBaud(this->baud);
+        return;
+    }
+
+    char name[16];
+    if (uartNum == USB_CDC) {
+        snprintf(name, sizeof(name), "UC_USB");
+    } else {
+        snprintf(name, sizeof(name), "UC_SERIAL%d", uartNum);
+    }
+    const char* device = getenv(name);
+    if (device && *device) {
+        int fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0) {
+            fprintf(stderr, "HardwareSerial(%d): cannot open %s\n", uartNum, device);
+            return;
+        }
+        struct termios tio;
+        if (isatty(fd) && tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+        applyBaud(fd, baud);
+        readFd = writeFd = fd;
+        ownsFd = true;
+    } else if (uartNum == USB_CDC) {
+        readFd = STDIN_FILENO;
+        writeFd = STDOUT_FILENO;
+        ownsFd = false;
+    }
+}
+
+void HardwareSerial::end() {
+    backend = nullptr;
+    if (ownsFd && readFd >= 0) {
+        close(readFd);
+    }
+    readFd = writeFd = -1;
+    ownsFd = false;
+    peeked = -1;
+}
+
+void HardwareSerial::updateBaudRate(unsigned long baud) {
+    this->baud = static_cast<uint32_t>(baud);
+    if (backend) {
+        backend->setBaud(this->baud);
+    } else if (ownsFd) {
+        applyBaud(writeFd, baud);
+    }
+}
+
+bool HardwareSerial::fill() {
+    if (peeked >= 0) {
+        return true;
+    }
+    if (backend) {
+        peeked = backend->read();
+        return peeked >= 0;
+    }
+    if (readFd < 0) {
+        return false;
+    }
+    struct pollfd pfd = {readFd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & POLLIN)) {
+        return false;
+    }
+    uint8_t b;
+    if (::read(readFd, &b, 1) != 1) {
+        return false;
+    }
+    peeked = b;
+    return true;
+}
+
+int HardwareSerial::available() {
+    if (backend) {
+        return backend->available() + (peeked >= 0 ? 1 : 0);
+    }
+    if (readFd < 0) {
+        return 0;
+    }
+    int pending = 0;
+    if (ioctl(readFd, FIONREAD, &pending) != 0) {
+        pending = 0;
+    }
+    return pending + (peeked >= 0 ? 1 : 0);
+}
+
+int HardwareSerial::read() {
+    if (!fill()) {
+        return -1;
+    }
+    int b = peeked;
+    peeked = -1;
+    return b;
+}
+
+int HardwareSerial::peek() {
+    return fill() ? peeked : -1;
+}
+
+void HardwareSerial::flush() {
+    if (backend) {
+        backend->flush();
+    } else if (writeFd >= 0 && ownsFd && isatty(writeFd)) {
+        tcdrain(writeFd);
+    }
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (backend) {
+        return backend->write(buffer, size);
+    }
+    if (writeFd < 0) {
+        return size;    // 空设备：写入丢弃
+    }
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::write(writeFd, buffer + done, size - done);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            break;
+        } else {
+            struct pollfd pfd = {writeFd, POLLOUT, 0};
+            poll(&pfd, 1, 10);
+        }
+    }
+    return done;
+}
@@ -0,0 +1,777 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "NativeSim.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using SteadyClock = std::chrono::steady_clock;
+
+namespace {
+
+// 节拍计数起点（进程启动）
+const SteadyClock::time_point tickEpoch = SteadyClock::now();
+
+// 任务删除（自身）通过异常退出线程
+struct TaskExit {};
+
+constexpr uint64_t NEVER = UINT64_MAX;
+constexpr uint64_t TICK_US = 1000000ULL / configTICK_RATE_HZ;
+
+} // namespace
+
+struct NativeTask {
+    std::string name;
+    TaskFunction_t function = nullptr;
+    void* param = nullptr;
+    UBaseType_t priority = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifyCount = 0;
+    std::atomic<bool> deleteRequested{false};
+
+    // 虚拟时间调度（由调度器互斥量保护）
+    enum class State { READY, RUNNING, BLOCKED, FINISHED } state = State::READY;
+    std::condition_variable turnCv;
+    bool turn = false;                  // 轮到本任务运行
+    std::function<bool()> wakeWhen;     // 阻塞条件，为空时只等待超时
+    uint64_t wakeUs = NEVER;
+    bool wokenByCondition = false;
+    uint64_t readySeq = 0;              // 同优先级按就绪先后运行
+    uint64_t readySinceUs = 0;
+    uint64_t dispatchedUs = 0;
+    NativeSim::TaskStats stats = {};
+    bool everRun = false;
+};
+
+struct NativeQueue {
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    size_t length;
+    size_t itemSize;
+    size_t head = 0;            // 队首元素下标
+    size_t count = 0;
+    std::vector<uint8_t> storage;
+    std::string name;
+    size_t highWater = 0;
+    uint32_t sends = 0;
+    uint32_t fullRejects = 0;
+
+    NativeQueue(size_t length, size_t itemSize)
+        : length(length), itemSize(itemSize), storage(length * itemSize) {}
+
+    uint8_t* slot(size_t index) { return &storage[((head + index) % length) * itemSize]; }
+
+    void countSend() {
+        ++sends;
+        if (count > highWater) {
+            highWater = count;
+        }
+    }
+};
+
+struct NativeSemaphore {
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t maxCount;
+
+    NativeSemaphore(UBaseType_t maxCount, UBaseType_t initial) : count(initial), maxCount(maxCount) {}
+};
+
+namespace {
+
+thread_local NativeTask* currentTask = nullptr;
+
+// 全部队列（统计用）
+std::mutex registryMutex;
+std::vector<NativeQueue*> queueRegistry;
+
+//============================== 虚拟时间调度器 ==============================
+
+struct Scheduler {
+    std::mutex mutex;
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> nowUs{0};
+    double speed = 0.0;
+    SteadyClock::time_point realStart;
+    NativeTask* current = nullptr;
+    std::vector<NativeTask*> tasks;     // 全部任务（含已结束），按创建顺序
+    uint64_t readySeq = 0;
+};
+
+Scheduler sched;
+
+bool virtualMode() {
+    return sched.enabled.load(std::memory_order_relaxed);
+}
+
+void makeReady(NativeTask* task) {
+    task->state = NativeTask::State::READY;
+    task->readySeq = ++sched.readySeq;
+    task->readySinceUs = sched.nowUs.load();
+}
+
+// 条件成立或超时的阻塞任务转为就绪
+void wakeBlocked() {
+    const uint64_t now = sched.nowUs.load();
+    for (NativeTask* task : sched.tasks) {
+        if (task->state != NativeTask::State::BLOCKED) {
+            continue;
+        }
+        if (task->wakeWhen && task->wakeWhen()) {
+            task->wokenByCondition = true;
+            makeReady(task);
+        } else if (now >= task->wakeUs) {
+            task->wokenByCondition = false;
+            makeReady(task);
+        }
+    }
+}
+
+// 优先级最高、就绪最早的任务
+NativeTask* highestReady() {
+    NativeTask* best = nullptr;
+    for (NativeTask* task : sched.tasks) {
+        if (task->state != NativeTask::State::READY) {
+            continue;
+        }
+        if (!best || task->priority > best->priority ||
+            (task->priority == best->priority && task->readySeq < best->readySeq)) {
+            best = task;
+        }
+    }
+    return best;
+}
+
+void printSchedule(FILE* out);
+
+// 所有任务都无限期阻塞：虚拟时间无法推进
+[[noreturn]] void deadlock() {
+    fprintf(stderr, "\nNativeSim: all tasks blocked forever at %.3f s\n", sched.nowUs.load() / 1e6);
+    printSchedule(stderr);
+    fflush(stdout);
+    _Exit(3);
+}
+
+// 限速：虚拟时间不超过真实时间的 speed 倍
+void pace(uint64_t targetUs, std::unique_lock<std::mutex>& lock) {
+    if (sched.speed <= 0.0) {
+        return;
+    }
+    const auto realTarget = sched.realStart +
+        std::chrono::microseconds(static_cast<int64_t>(static_cast<double>(targetUs) / sched.speed));
+    if (realTarget > SteadyClock::now()) {
+        lock.unlock();
+        std::this_thread::sleep_until(realTarget);
+        lock.lock();
+    }
+}
+
+void switchOut(NativeTask* task) {
+    task->stats.cpuUs += sched.nowUs.load() - task->dispatchedUs;
+}
+
+void dispatch(NativeTask* task) {
+    const uint64_t now = sched.nowUs.load();
+    const uint64_t wait = now - task->readySinceUs;
+    task->stats.readyWaitTotalUs += wait;
+    if (wait > task->stats.readyWaitMaxUs) {
+        task->stats.readyWaitMaxUs = wait;
+    }
+    if (task->everRun && now - task->dispatchedUs > task->stats.maxGapUs) {
+        task->stats.maxGapUs = now - task->dispatchedUs;
+    }
+    task->everRun = true;
+    ++task->stats.runs;
+    task->dispatchedUs = now;
+    task->state = NativeTask::State::RUNNING;
+    task->turn = true;
+    sched.current = task;
+    task->turnCv.notify_one();
+}
+
+void waitTurn(NativeTask* task, std::unique_lock<std::mutex>& lock) {
+    task->turnCv.wait(lock, [task] { return task->turn; });
+    task->turn = false;
+}
+
+// 当前任务已让出 CPU（状态已设为就绪/阻塞/结束）：选择下一个任务运行，必要时推进虚拟时间；
+// self 未结束时等待再次轮到自己
+void reschedule(NativeTask* self, std::unique_lock<std::mutex>& lock) {
+    for (;;) {
+        wakeBlocked();
+        if (NativeTask* next = highestReady()) {
+            dispatch(next);
+            break;
+        }
+        uint64_t wake = NEVER;
+        for (NativeTask* task : sched.tasks) {
+            if (task->state == NativeTask::State::BLOCKED && task->wakeUs < wake) {
+                wake = task->wakeUs;
+            }
+        }
+        if (wake == NEVER) {
+            deadlock();
+        }
+        pace(wake, lock);
+        if (wake > sched.nowUs.load()) {
+            sched.nowUs.store(wake);
+        }
+    }
+    if (self->state != NativeTask::State::FINISHED) {
+        waitTurn(self, lock);
+    }
+}
+
+// 阻塞当前任务直到 cond 成立或到达 wakeUs，条件成立返回 true
+bool blockUntil(std::function<bool()> cond, uint64_t wakeUs) {
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    NativeTask* self = sched.current;
+    if (!self || self != currentTask) {
+        fprintf(stderr, "NativeSim: blocking call from a thread that is not the running task\n");
+        abort();
+    }
+    switchOut(self);
+    self->state = NativeTask::State::BLOCKED;
+    self->wakeWhen = std::move(cond);
+    self->wakeUs = wakeUs;
+    reschedule(self, lock);
+    self->wakeWhen = nullptr;
+    self->wakeUs = NEVER;
+    return self->wokenByCondition;
+}
+
+// 抢占点：唤醒条件已满足的任务，优先级更高（或同优先级且当前任务已运行满一个节拍）时让出 CPU
+void preemptionPoint() {
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    NativeTask* self = sched.current;
+    if (!self || self != currentTask) {
+        return;
+    }
+    wakeBlocked();
+    NativeTask* next = highestReady();
+    if (!next) {
+        return;
+    }
+    const bool sliceUsed = sched.nowUs.load() - self->dispatchedUs >= TICK_US;
+    if (next->priority > self->priority || (next->priority == self->priority && sliceUsed)) {
+        switchOut(self);
+        makeReady(self);
+        reschedule(self, lock);
+    }
+}
+
+// 节拍对齐的唤醒时刻：与 FreeRTOS 一样在第 ticks 个节拍中断时唤醒
+uint64_t wakeAfterTicks(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        return NEVER;
+    }
+    return (sched.nowUs.load() / TICK_US + ticks) * TICK_US;
+}
+
+//============================== 实时模式辅助 ==============================
+
+// 等待截止时刻；portMAX_DELAY 返回 false 表示无限等待
+bool deadlineOf(TickType_t ticks, SteadyClock::time_point& deadline) {
+    if (ticks == portMAX_DELAY) {
+        return false;
+    }
+    deadline = SteadyClock::now() + std::chrono::milliseconds(pdTICKS_TO_MS(ticks));
+    return true;
+}
+
+// 在 cv 上等待 ready() 成立，超时返回 false；虚拟时间模式下由调度器阻塞（cv 不使用）
+template <typename Pred>
+bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t ticks, Pred ready) {
+    if (virtualMode()) {
+        if (ready()) {
+            return true;
+        }
+        if (ticks == 0) {
+            return false;
+        }
+        std::mutex* m = lock.mutex();
+        lock.unlock();
+        blockUntil([m, &ready] {
+            std::lock_guard<std::mutex> guard(*m);
+            return ready();
+        }, wakeAfterTicks(ticks));
+        lock.lock();
+        return ready();
+    }
+    SteadyClock::time_point deadline;
+    if (!deadlineOf(ticks, deadline)) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_until(lock, deadline, ready);
+}
+
+// 被请求删除的任务在阻塞调用处结束
+void checkDeleted() {
+    if (currentTask && currentTask->deleteRequested.load()) {
+        throw TaskExit();
+    }
+}
+
+void taskEntry(NativeTask* task) {
+    currentTask = task;
+    if (virtualMode()) {
+        std::unique_lock<std::mutex> lock(sched.mutex);
+        waitTurn(task, lock);
+    }
+    try {
+        task->function(task->param);
+    } catch (const TaskExit&) {
+    }
+    if (virtualMode()) {
+        std::unique_lock<std::mutex> lock(sched.mutex);
+        switchOut(task);
+        task->state = NativeTask::State::FINISHED;
+        task->stats.finished = true;
+        reschedule(task, lock);
+    }
+}
+
+void printSchedule(FILE* out) {
+    fprintf(out, "%-20s %4s %8s %10s %12s %12s %12s\n", "task", "prio", "runs", "cpu(ms)", "wait-avg(us)",
+            "wait-max(us)", "max-gap(ms)");
+    for (NativeTask* task : sched.tasks) {
+        const NativeSim::TaskStats& s = task->stats;
+        fprintf(out, "%-20s %4u %8lu %10.1f %12.1f %12llu %12.1f%s\n", task->name.c_str(), task->priority,
+                static_cast<unsigned long>(s.runs), s.cpuUs / 1000.0,
+                s.runs ? static_cast<double>(s.readyWaitTotalUs) / s.runs : 0.0,
+                static_cast<unsigned long long>(s.readyWaitMaxUs), s.maxGapUs / 1000.0,
+                task->state == NativeTask::State::BLOCKED ? "  (blocked)" : "");
+    }
+}
+
+} // namespace
+
+//============================== 虚拟时间接口 ==============================
+
+namespace NativeSim {
+
+void beginVirtualTime(const char* mainTaskName, UBaseType_t mainPriority, double speed) {
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    if (sched.enabled.load()) {
+        return;
+    }
+    if (!currentTask) {
+        currentTask = new NativeTask();
+    }
+    currentTask->name = mainTaskName ? mainTaskName : "main";
+    currentTask->priority = mainPriority;
+    currentTask->stats.name = currentTask->name.c_str();
+    currentTask->stats.priority = mainPriority;
+    currentTask->state = NativeTask::State::RUNNING;
+    currentTask->everRun = true;
+    currentTask->stats.runs = 1;
+    sched.tasks.push_back(currentTask);
+    sched.current = currentTask;
+    sched.speed = speed;
+    sched.realStart = SteadyClock::now();
+    sched.nowUs.store(0);
+    sched.enabled.store(true);
+}
+
+bool virtualTime() {
+    return virtualMode();
+}
+
+uint64_t nowUs() {
+    if (virtualMode()) {
+        return sched.nowUs.load(std::memory_order_relaxed);
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        SteadyClock::now() - tickEpoch).count());
+}
+
+void sleepUntilUs(uint64_t us) {
+    if (virtualMode()) {
+        if (us > sched.nowUs.load()) {
+            blockUntil(nullptr, us);
+        }
+        return;
+    }
+    std::this_thread::sleep_until(tickEpoch + std::chrono::microseconds(us));
+}
+
+void busyUs(uint32_t us) {
+    if (virtualMode()) {
+        const uint64_t now = sched.nowUs.fetch_add(us) + us;
+        if (sched.speed > 0.0) {
+            // 轮询外部输入（串口、网络）的忙等循环也不超过限速
+            std::unique_lock<std::mutex> lock(sched.mutex);
+            pace(now, lock);
+        }
+        preemptionPoint();
+        return;
+    }
+    const uint64_t end = nowUs() + us;
+    while (nowUs() < end) {
+    }
+}
+
+size_t taskStats(TaskStats* out, size_t max) {
+    std::lock_guard<std::mutex> lock(sched.mutex);
+    const uint64_t now = sched.nowUs.load();
+    for (size_t i = 0; i < sched.tasks.size() && i < max; ++i) {
+        NativeTask* task = sched.tasks[i];
+        out[i] = task->stats;
+        out[i].name = task->name.c_str();
+        out[i].priority = task->priority;
+        if (task->state == NativeTask::State::RUNNING) {
+            out[i].cpuUs += now - task->dispatchedUs;
+        }
+    }
+    return sched.tasks.size();
+}
+
+size_t queueStats(QueueStats* out, size_t max) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (size_t i = 0; i < queueRegistry.size() && i < max; ++i) {
+        NativeQueue* queue = queueRegistry[i];
+        std::lock_guard<std::mutex> queueLock(queue->mutex);
+        out[i].name = queue->name.empty() ? nullptr : queue->name.c_str();
+        out[i].length = static_cast<UBaseType_t>(queue->length);
+        out[i].waiting = static_cast<UBaseType_t>(queue->count);
+        out[i].highWater = static_cast<UBaseType_t>(queue->highWater);
+        out[i].sends = queue->sends;
+        out[i].fullRejects = queue->fullRejects;
+    }
+    return queueRegistry.size();
+}
+
+} // namespace NativeSim
+
+//============================== 任务 ==============================
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    (void)stackDepth;
+    NativeTask* task = new NativeTask();
+    task->name = name ? name : "";
+    task->function = function;
+    task->param = param;
+    task->priority = priority;
+    if (handle) {
+        *handle = task;
+    }
+    if (virtualMode()) {
+        {
+            std::lock_guard<std::mutex> lock(sched.mutex);
+            sched.tasks.push_back(task);
+            makeReady(task);
+        }
+        std::thread(taskEntry, task).detach();
+        // 新任务优先级更高时立即运行
+        preemptionPoint();
+        return pdPASS;
+    }
+    std::thread(taskEntry, task).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    (void)coreId;
+    return xTaskCreate(function, name, stackDepth, param, priority, handle);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        throw TaskExit();
+    }
+    task->deleteRequested.store(true);
+    xTaskNotifyGive(task);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    checkDeleted();
+    if (virtualMode()) {
+        if (ticks == 0) {
+            taskYIELD();
+        } else {
+            blockUntil(nullptr, wakeAfterTicks(ticks));
+        }
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pdTICKS_TO_MS(ticks)));
+    }
+    checkDeleted();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    checkDeleted();
+    const TickType_t wake = *previousWakeTime + increment;
+    const TickType_t now = xTaskGetTickCount();
+    *previousWakeTime = wake;
+    // 节拍回绕安全的比较：唤醒时刻已过则不等待
+    if (static_cast<int32_t>(wake - now) <= 0) {
+        return pdFALSE;
+    }
+    if (virtualMode()) {
+        blockUntil(nullptr, wakeAfterTicks(wake - now));
+    } else {
+        std::this_thread::sleep_until(tickEpoch + std::chrono::milliseconds(pdTICKS_TO_MS(wake)));
+    }
+    checkDeleted();
+    return pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    xTaskDelayUntil(previousWakeTime, increment);
+}
+
+TickType_t xTaskGetTickCount() {
+    return static_cast<TickType_t>(NativeSim::nowUs() / TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!currentTask) {
+        // 外部线程（main 等）：登记一个任务对象以支持任务通知，线程结束后不回收
+        currentTask = new NativeTask();
+        currentTask->name = "native";
+    }
+    return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    if (!task) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    return task->name.c_str();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        ++task->notifyCount;
+    }
+    task->cv.notify_one();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    checkDeleted();
+    NativeTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    waitFor(task->cv, lock, ticksToWait, [task] { return task->notifyCount > 0 || task->deleteRequested.load(); });
+    const uint32_t value = task->notifyCount;
+    if (value > 0) {
+        task->notifyCount = clearCountOnExit ? 0 : value - 1;
+    }
+    lock.unlock();
+    checkDeleted();
+    return value;
+}
+
+void taskYIELD() {
+    if (!virtualMode()) {
+        std::this_thread::yield();
+        return;
+    }
+    // 同优先级及更高优先级的就绪任务先运行
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    NativeTask* self = sched.current;
+    if (!self || self != currentTask) {
+        return;
+    }
+    switchOut(self);
+    makeReady(self);
+    reschedule(self, lock);
+}
+
+//============================== 队列 ==============================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0 || itemSize == 0) {
+        return nullptr;
+    }
+    NativeQueue* queue = new NativeQueue(length, itemSize);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    queueRegistry.push_back(queue);
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto it = queueRegistry.begin(); it != queueRegistry.end(); ++it) {
+            if (*it == queue) {
+                queueRegistry.erase(it);
+                break;
+            }
+        }
+    }
+    delete queue;
+}
+
+void vQueueAddToRegistry(QueueHandle_t queue, const char* name) {
+    if (!queue) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->name = name ? name : "";
+}
+
+namespace {
+
+BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait, bool front) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->notFull, lock, ticksToWait, [queue] { return queue->count < queue->length; })) {
+        ++queue->fullRejects;
+        return errQUEUE_FULL;
+    }
+    if (front) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        memcpy(queue->slot(0), item, queue->itemSize);
+    } else {
+        memcpy(queue->slot(queue->count), item, queue->itemSize);
+    }
+    ++queue->count;
+    queue->countSend();
+    lock.unlock();
+    queue->notEmpty.notify_one();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdPASS;
+}
+
+BaseType_t queueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait, bool remove) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->notEmpty, lock, ticksToWait, [queue] { return queue->count > 0; })) {
+        return errQUEUE_EMPTY;
+    }
+    memcpy(buffer, queue->slot(0), queue->itemSize);
+    if (!remove) {
+        return pdPASS;
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    --queue->count;
+    lock.unlock();
+    queue->notFull.notify_one();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdPASS;
+}
+
+} // namespace
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->head = 0;
+        queue->count = 1;
+        memcpy(queue->slot(0), item, queue->itemSize);
+        queue->countSend();
+    }
+    queue->notEmpty.notify_one();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return static_cast<UBaseType_t>(queue->count);
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return static_cast<UBaseType_t>(queue->length - queue->count);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->head = 0;
+        queue->count = 0;
+    }
+    queue->notFull.notify_all();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdPASS;
+}
+
+//============================== 信号量 ==============================
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new NativeSemaphore(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return new NativeSemaphore(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    return new NativeSemaphore(maxCount, initialCount);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitFor(semaphore->cv, lock, ticksToWait, [semaphore] { return semaphore->count > 0; })) {
+        return pdFALSE;
+    }
+    --semaphore->count;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->count >= semaphore->maxCount) {
+            return pdFALSE;
+        }
+        ++semaphore->count;
+    }
+    semaphore->cv.notify_one();
+    if (virtualMode()) {
+        preemptionPoint();
+    }
+    return pdTRUE;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    return semaphore->count;
+}
@@ -0,0 +1,130 @@
+#include "Preferences.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// 未设置 UC_NVS_DIR 时的进程内存储：键为 "<命名空间>.<键>"
+std::map<std::string, std::vector<uint8_t>>& memoryStore() {
+    static std::map<std::string, std::vector<uint8_t>> store;
+    return store;
+}
+
+std::mutex storeMutex;
+
+const char* nvsDir() {
+    const char* dir = getenv("UC_NVS_DIR");
+    return dir && *dir ? dir : nullptr;
+}
+
+bool loadValue(const std::string& id, const std::string& file, std::vector<uint8_t>& value) {
+    if (file.empty()) {
+        auto it = memoryStore().find(id);
+        if (it == memoryStore().end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+    FILE* f = fopen(file.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    value.clear();
+    uint8_t chunk[256];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        value.insert(value.end(), chunk, chunk + n);
+    }
+    fclose(f);
+    return true;
+}
+
+} // namespace
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (!name || !*name || strlen(name) > 15) {
+        return false;
+    }
+    ns = name;
+    this->readOnly = readOnly;
+    opened = true;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+std::string Preferences::path(const char* key) const {
+    const char* dir = nvsDir();
+    return dir ? std::string(dir) + "/" + ns + "." + key + ".bin" : std::string();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!opened || readOnly || !key) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(storeMutex);
+    const std::string file = path(key);
+    if (file.empty()) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        memoryStore()[ns + "." + key].assign(bytes, bytes + length);
+        return length;
+    }
+    FILE* f = fopen(file.c_str(), "wb");
+    if (!f) {
+        return 0;
+    }
+    size_t written = fwrite(value, 1, length, f);
+    fclose(f);
+    return written;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    if (!opened || !key) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(storeMutex);
+    std::vector<uint8_t> value;
+    if (!loadValue(ns + "." + key, path(key), value) || value.size() > maxLength) {
+        return 0;
+    }
+    memcpy(buffer, value.data(), value.size());
+    return value.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened || !key) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(storeMutex);
+    std::vector<uint8_t> value;
+    return loadValue(ns + "." + key, path(key), value) ? value.size() : 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!opened || !key) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(storeMutex);
+    std::vector<uint8_t> value;
+    return loadValue(ns + "." + key, path(key), value);
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly || !key) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(storeMutex);
+    const std::string file = path(key);
+    if (file.empty()) {
+        return memoryStore().erase(ns + "." + key) > 0;
+    }
+    return ::remove(file.c_str()) == 0;
+}
@@ -0,0 +1,242 @@
+#include "WiFi.h"
+#include "NativeSim.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+//============================== WiFiClass ==============================
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+    (void)ssid;
+    (void)passphrase;
+    std::lock_guard<std::mutex> lock(mutex);
+    wanted = true;
+    readyUs = NativeSim::nowUs() + associateUs;
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+    (void)wifiOff;
+    std::lock_guard<std::mutex> lock(mutex);
+    wanted = false;
+    ++generation;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!wanted) {
+        return WL_DISCONNECTED;
+    }
+    if (!up) {
+        return everConnected ? WL_CONNECTION_LOST : WL_NO_SSID_AVAIL;
+    }
+    if (NativeSim::nowUs() < readyUs) {
+        return WL_DISCONNECTED;
+    }
+    everConnected = true;
+    return WL_CONNECTED;
+}
+
+IPAddress WiFiClass::localIP() {
+    return status() == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+void WiFiClass::setLinkUp(bool value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (value == up) {
+        return;
+    }
+    up = value;
+    if (up) {
+        readyUs = NativeSim::nowUs() + associateUs;
+    } else {
+        ++generation;
+    }
+}
+
+bool WiFiClass::linkUp() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return up;
+}
+
+void WiFiClass::setAssociateMs(uint32_t ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    associateUs = ms * 1000;
+}
+
+uint32_t WiFiClass::linkGeneration() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generation;
+}
+
+//============================== WiFiClient ==============================
+
+namespace {
+
+// 在真实时间内连接，返回套接字，失败返回 -1；timedOut 表示目标不可达（而非被拒绝）
+int openSocket(const char* host, uint16_t port, uint32_t timeoutMs, bool& timedOut) {
+    timedOut = false;
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host, service, &hints, &result) != 0 || !result) {
+        timedOut = true;
+        return -1;
+    }
+    int fd = socket(result->ai_family, result->ai_socktype | SOCK_NONBLOCK, result->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(result);
+        return -1;
+    }
+    int rc = ::connect(fd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (rc < 0 && errno == EINPROGRESS) {
+        pollfd p = {fd, POLLOUT, 0};
+        if (poll(&p, 1, static_cast<int>(timeoutMs)) <= 0) {
+            timedOut = true;
+            close(fd);
+            return -1;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        rc = error == 0 ? 0 : -1;
+    }
+    if (rc < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+WiFiClient::~WiFiClient() {
+    stop();
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    (void)host;     // 目标主机由 UC_NET_HOST 决定
+    stop();
+    if (WiFi.status() != WL_CONNECTED) {
+        return 0;
+    }
+    const uint64_t startUs = NativeSim::nowUs();
+    const char* target = getenv("UC_NET_HOST");
+    bool timedOut = true;
+    if (target && *target) {
+        fd = openSocket(target, port, connectTimeoutMs, timedOut);
+    }
+    if (NativeSim::virtualTime()) {
+        NativeSim::sleepUntilUs(startUs + (timedOut ? connectTimeoutMs * 1000ULL : CONNECT_US));
+    } else if (!target || !*target) {
+        delay(connectTimeoutMs);
+    }
+    // 连接期间链路丢失
+    if (fd >= 0 && WiFi.status() != WL_CONNECTED) {
+        stop();
+    }
+    generation = WiFi.linkGeneration();
+    return fd >= 0 ? 1 : 0;
+}
+
+bool WiFiClient::alive() {
+    if (fd >= 0 && WiFi.linkGeneration() != generation) {
+        stop();
+    }
+    return fd >= 0;
+}
+
+size_t WiFiClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (!alive()) {
+        return 0;
+    }
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd p = {fd, POLLOUT, 0};
+            poll(&p, 1, 100);
+        } else {
+            stop();
+            break;
+        }
+    }
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (!alive()) {
+        return 0;
+    }
+    int count = 0;
+    if (ioctl(fd, FIONREAD, &count) < 0) {
+        return 0;
+    }
+    return count;
+}
+
+int WiFiClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (!alive()) {
+        return -1;
+    }
+    ssize_t n = recv(fd, buffer, size, MSG_DONTWAIT);
+    if (n == 0) {
+        stop();     // 对端关闭
+        return -1;
+    }
+    return n < 0 ? -1 : static_cast<int>(n);
+}
+
+int WiFiClient::peek() {
+    if (!alive()) {
+        return -1;
+    }
+    uint8_t b;
+    return recv(fd, &b, 1, MSG_DONTWAIT | MSG_PEEK) == 1 ? b : -1;
+}
+
+void WiFiClient::stop() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+uint8_t WiFiClient::connected() {
+    if (!alive()) {
+        return 0;
+    }
+    uint8_t b;
+    ssize_t n = recv(fd, &b, 1, MSG_DONTWAIT | MSG_PEEK);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,770 @@
+/*
+ * @Description: Emm42_V5.0 驱动器主机仿真
+ *
+ * 在 PC 上仿真挂在同一条串口总线上的若干 Emm42 驱动器，没有硬件时也能运行总线吞吐与控制环延迟测试：
+ *  - VirtualDriver：单个驱动器的协议状态机与运动模型（使能、速度斜坡、位置运动、立即停止、多机同步、
+ *    控制命令应答设置、状态标志、驱动配置读写）；
+ *  - Emm42Bus：多驱动器总线，按字节时间戳接收命令，按波特率排期应答字节，
+ *    可注入处理延迟、抖动、丢字节与比特翻转。
+ * 所有接口显式传入当前时刻（微秒），不读取系统时钟，可直接用于虚拟时间仿真。
+ * 本文件只依赖 Emm42Frame.h 与标准库。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <random>
+#include "StepperMotor/Emm42Frame.h"
+
+namespace Emm42Sim {
+
+// 电机状态标志位（0x3A 应答与系统状态中的电机状态字节）
+constexpr uint8_t STATUS_ENABLED = 0x01;         // 使能
+constexpr uint8_t STATUS_IN_POSITION = 0x02;     // 到位
+constexpr uint8_t STATUS_STALLED = 0x04;         // 堵转
+constexpr uint8_t STATUS_STALL_PROTECT = 0x08;   // 堵转保护
+
+// 就绪状态标志位（系统状态中的就绪状态字节）
+constexpr uint8_t READY_ENCODER = 0x01;          // 编码器就绪
+constexpr uint8_t READY_CALIBRATED = 0x02;       // 校准表就绪
+
+// 控制命令应答设置（驱动配置参数中的取值）
+constexpr uint8_t RESPONSE_NONE = 0;
+constexpr uint8_t RESPONSE_RECEIVE = 1;
+constexpr uint8_t RESPONSE_REACHED = 2;
+constexpr uint8_t RESPONSE_BOTH = 3;
+
+// 驱动配置参数区（0x42 应答与 0x48 命令中的 28 字节）字段偏移
+namespace cfg {
+constexpr size_t MOTOR_TYPE = 0;
+constexpr size_t SUBDIVISION = 5;       // 0 表示 256
+constexpr size_t OPEN_LOOP_CURRENT = 8;
+constexpr size_t BAUD = 14;             // BAUD_RATES 序号
+constexpr size_t ID = 16;
+constexpr size_t CHECKSUM = 17;         // 0-0x6B, 1-XOR, 2-CRC8
+constexpr size_t RESPONSE = 18;
+constexpr size_t BYTES = 28;
+}
+
+// 串口波特率选项（驱动配置参数中以序号表示）
+constexpr uint32_t BAUD_RATES[] = {9600, 19200, 25000, 38400, 57600, 115200, 256000, 512000, 921600};
+
+// 命令帧总长度：0x48 修改驱动配置（D1 子命令）为 33 字节，未知功能码返回 0
+inline size_t commandLength(uint8_t funcCode) {
+    return funcCode == 0x48 ? 33 : Emm42::requestLength(funcCode);
+}
+
+// 追加 "符号(1字节) + 大端数值"，负数符号为 0x01
+inline void pushSigned(Emm42::Frame& frame, int64_t value, size_t width) {
+    frame.push(value < 0 ? 0x01 : 0x00);
+    uint64_t magnitude = static_cast<uint64_t>(value < 0 ? -value : value);
+    for (size_t i = width; i-- > 0; ) {
+        frame.push(static_cast<uint8_t>((magnitude >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void pushU16(Emm42::Frame& frame, uint16_t value) {
+    frame.push(static_cast<uint8_t>(value >> 8));
+    frame.push(static_cast<uint8_t>(value & 0xFF));
+}
+
+inline void pushU32(Emm42::Frame& frame, uint32_t value) {
+    pushU16(frame, static_cast<uint16_t>(value >> 16));
+    pushU16(frame, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+/**
+ * @brief 单个仿真驱动器
+ *
+ * 位置以圈为单位积分，对外按协议换算：实时/目标位置每圈 65536，位置运动脉冲数每圈
+ * 整步数 × 细分（电机类型 25 为 200 整步，50 为 400 整步）。
+ * 速度斜坡与固件一致：加速度档位 a 非 0 时每 (256 - a) × 50 µs 转速变化 1 RPM，a 为 0 时立即到达。
+ */
+class VirtualDriver {
+public:
+    explicit VirtualDriver(uint8_t address, ChecksumType checksum = ChecksumType::FIXED) {
+        memset(config, 0, sizeof(config));
+        config[cfg::MOTOR_TYPE] = 25;
+        config[cfg::SUBDIVISION] = 16;
+        config[cfg::OPEN_LOOP_CURRENT] = 0x04;    // 1200 mA
+        config[cfg::OPEN_LOOP_CURRENT + 1] = 0xB0;
+        config[cfg::BAUD] = 5;                    // 115200
+        config[cfg::ID] = address;
+        config[cfg::CHECKSUM] = checksum == ChecksumType::XOR ? 1 : checksum == ChecksumType::CRC8 ? 2 : 0;
+        config[cfg::RESPONSE] = RESPONSE_RECEIVE;
+    }
+
+    uint8_t address() const { return config[cfg::ID]; }
+
+    ChecksumType checksumType() const {
+        switch (config[cfg::CHECKSUM]) {
+            case 1:  return ChecksumType::XOR;
+            case 2:  return ChecksumType::CRC8;
+            default: return ChecksumType::FIXED;
+        }
+    }
+
+    uint32_t baudRate() const {
+        return config[cfg::BAUD] < sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]) ? BAUD_RATES[config[cfg::BAUD]] : 0;
+    }
+
+    uint16_t subdivision() const { return config[cfg::SUBDIVISION] == 0 ? 256 : config[cfg::SUBDIVISION]; }
+    uint8_t commandResponse() const { return config[cfg::RESPONSE]; }
+
+    // 仿真参数设置
+    void setCommandResponse(uint8_t mode) { config[cfg::RESPONSE] = mode; }
+    void setSubdivision(uint16_t value) { config[cfg::SUBDIVISION] = value >= 256 ? 0 : static_cast<uint8_t>(value); }
+    void setMotorType(uint8_t type) { config[cfg::MOTOR_TYPE] = type; }
+    void setVersions(uint8_t firmware, uint8_t hardware) { firmwareVersion = firmware; hardwareVersion = hardware; }
+
+    void setBaudRate(uint32_t rate) {
+        for (uint8_t i = 0; i < sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]); ++i) {
+            if (BAUD_RATES[i] == rate) {
+                config[cfg::BAUD] = i;
+            }
+        }
+    }
+
+    // 注入堵转保护：电机立即停止，运动命令以 E2 拒绝，重新使能后解除
+    void setStalled(bool stalled) {
+        stallProtect = stalled;
+        if (stalled) {
+            haltMotion();
+        }
+    }
+
+    // 离线的驱动器不响应任何命令（模拟掉线或未接入）
+    void setOnline(bool online) { onlineFlag = online; }
+    bool online() const { return onlineFlag; }
+
+    // 运动状态
+    bool enabled() const { return enabledFlag; }
+    double speedRpm() const { return rpm; }
+    double positionRev() const { return posRev; }
+
+    /**
+     * @brief 处理一帧已通过本驱动器地址与校验检查的命令
+     * @param frame 完整命令帧（含地址与校验字节）
+     * @param respond 是否由本驱动器应答（广播命令只有地址 1 应答）
+     * @param nowUs 命令帧接收完成时刻
+     * @param reply 输出应答，无应答时长度为 0
+     */
+    void handle(const uint8_t* frame, size_t length, bool respond, uint64_t nowUs, Emm42::Frame& reply) {
+        reply.clear();
+        advanceTo(nowUs);
+        const uint8_t func = frame[1];
+        const ChecksumType replyType = checksumType();
+        const uint8_t replyAddr = address();
+
+        auto ack = [&](uint8_t status) {
+            reply.push(replyAddr);
+            reply.push(func);
+            reply.push(status);
+        };
+        auto invalid = [&]() {
+            reply.clear();
+            reply.push(replyAddr);
+            reply.push(0x00);
+            reply.push(Emm42::REPLY_ERROR);
+        };
+
+        if (length != commandLength(func)) {
+            invalid();
+        } else if (Emm42::isAckFunction(func) && isControl(func)) {
+            // 控制命令：带同步标志的命令先锁存，等待多机同步触发
+            bool ok = true;
+            const bool sync = func != 0xFF && frame[length - 2] == 0x01;
+            if (func == 0xFF) {
+                ok = frame[2] == 0x66;
+                if (ok && latchedLength > 0) {
+                    execute(latched, latchedLength, nowUs);
+                    latchedLength = 0;
+                }
+            } else if (!validControl(frame)) {
+                ok = false;
+            } else if (sync) {
+                memcpy(latched, frame, length);
+                latchedLength = length;
+            } else {
+                ok = execute(frame, length, nowUs);
+            }
+            const uint8_t mode = commandResponse();
+            // 到位应答模式下位置命令只在到位时应答
+            const bool immediate = mode == RESPONSE_RECEIVE || mode == RESPONSE_BOTH ||
+                                   (mode == RESPONSE_REACHED && func != 0xFD) || mode > RESPONSE_BOTH;
+            if (respond && immediate) {
+                ack(ok ? Emm42::REPLY_OK : Emm42::REPLY_CONDITION);
+            }
+            if (func == 0xFD && ok && respond && (mode == RESPONSE_REACHED || mode == RESPONSE_BOTH)) {
+                reachedReply = true;
+            }
+        } else if (Emm42::isAckFunction(func)) {
+            // 修改参数命令
+            if (applyModify(frame, length)) {
+                ack(Emm42::REPLY_OK);
+            } else {
+                invalid();
+            }
+            if (!respond) {
+                reply.clear();
+            }
+        } else if (!read(frame, reply)) {
+            invalid();
+        }
+
+        if (!respond) {
+            reply.clear();
+        }
+        if (reply.length > 0) {
+            reply.seal(replyType);
+        }
+        // 修改 ID / 校验方式 / 波特率在应答发出后生效
+        if (pendingConfigValid) {
+            memcpy(config, pendingConfig, sizeof(config));
+            pendingConfigValid = false;
+        }
+    }
+
+    /**
+     * @brief 推进运动模型
+     * @param nowUs 目标时刻
+     * @param reachedFrame 位置运动到达且需要到位应答时输出应答帧
+     * @param reachedUs 到达时刻
+     * @return 输出了到位应答返回 true
+     */
+    bool advance(uint64_t nowUs, Emm42::Frame& reachedFrame, uint64_t& reachedUs) {
+        bool arrived = advanceTo(nowUs, &reachedUs);
+        if (!arrived || !reachedReply) {
+            return false;
+        }
+        reachedReply = false;
+        reachedFrame.clear();
+        reachedFrame.push(address());
+        reachedFrame.push(0xFD);
+        reachedFrame.push(0x9F);
+        reachedFrame.seal(checksumType());
+        return true;
+    }
+
+    // 电机状态字节
+    uint8_t motorStatus() const {
+        return (enabledFlag ? STATUS_ENABLED : 0) | (inPosition ? STATUS_IN_POSITION : 0) |
+               (stallProtect ? (STATUS_STALLED | STATUS_STALL_PROTECT) : 0);
+    }
+
+private:
+    enum class Mode : uint8_t { IDLE, VELOCITY, POSITION };
+
+    // 运动模型积分步长（微秒）
+    static constexpr uint64_t STEP_US = 500;
+    // 位置运动末段的最低转速，保证在有限时间内到达
+    static constexpr double CREEP_RPM = 1.0;
+
+    static bool isControl(uint8_t func) {
+        return func == 0xF3 || func == 0xF6 || func == 0xFD || func == 0xFE || func == 0xFF;
+    }
+
+    // 控制命令的固定字段检查
+    static bool validControl(const uint8_t* frame) {
+        switch (frame[1]) {
+            case 0xF3: return frame[2] == 0xAB;
+            case 0xFE: return frame[2] == 0x98;
+            default:   return true;
+        }
+    }
+
+    uint32_t pulsesPerRev() const {
+        return (config[cfg::MOTOR_TYPE] == 50 ? 400u : 200u) * subdivision();
+    }
+
+    // 执行控制命令，条件不满足返回 false
+    bool execute(const uint8_t* frame, size_t length, uint64_t nowUs) {
+        (void)length;
+        (void)nowUs;
+        switch (frame[1]) {
+            case 0xF3:
+                enabledFlag = frame[3] != 0;
+                if (enabledFlag) {
+                    stallProtect = false;
+                } else {
+                    haltMotion();
+                }
+                return true;
+            case 0xF6: {
+                if (!enabledFlag || stallProtect) {
+                    return false;
+                }
+                const int sign = frame[2] ? -1 : 1;
+                mode = Mode::VELOCITY;
+                targetRpm = sign * static_cast<double>(Emm42::readU16(&frame[3]));
+                accelLevel = frame[5];
+                inPosition = false;
+                return true;
+            }
+            case 0xFD: {
+                if (!enabledFlag || stallProtect) {
+                    return false;
+                }
+                const int sign = frame[2] ? -1 : 1;
+                const uint32_t pulses = Emm42::readU32(&frame[6]);
+                const double delta = sign * static_cast<double>(pulses) / pulsesPerRev();
+                const bool absolute = frame[10] != 0;
+                targetRev = absolute ? delta : (mode == Mode::POSITION ? targetRev : posRev) + delta;
+                cruiseRpm = Emm42::readU16(&frame[3]);
+                accelLevel = frame[5];
+                inputPulses += sign * static_cast<int64_t>(pulses);
+                mode = Mode::POSITION;
+                inPosition = false;
+                return true;
+            }
+            case 0xFE:
+                haltMotion();
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void haltMotion() {
+        mode = Mode::IDLE;
+        rpm = 0.0;
+        targetRpm = 0.0;
+        targetRev = posRev;
+        reachedReply = false;
+    }
+
+    // 积分运动状态到 nowUs，位置运动在此期间到达返回 true
+    bool advanceTo(uint64_t nowUs, uint64_t* arrivedUs = nullptr) {
+        if (nowUs <= lastUs) {
+            return false;
+        }
+        uint64_t t = lastUs;
+        lastUs = nowUs;
+        if (mode == Mode::IDLE && rpm == 0.0) {
+            return false;
+        }
+        const double rampUs = accelLevel == 0 ? 0.0 : (256 - accelLevel) * 50.0;
+        // 减速度（圈/秒²）
+        const double decel = rampUs == 0.0 ? 0.0 : (1e6 / rampUs) / 60.0;
+        while (t < nowUs) {
+            const uint64_t step = std::min<uint64_t>(STEP_US, nowUs - t);
+            t += step;
+            double target = 0.0;
+            if (mode == Mode::VELOCITY) {
+                target = targetRpm;
+            } else if (mode == Mode::POSITION) {
+                const double remaining = targetRev - posRev;
+                double limit = cruiseRpm;
+                if (decel > 0.0) {
+                    // 剩余距离内能减速到 0 的最高转速
+                    limit = std::min(limit, std::max(CREEP_RPM, std::sqrt(2.0 * decel * std::fabs(remaining)) * 60.0));
+                }
+                target = remaining >= 0 ? limit : -limit;
+            }
+            if (rampUs == 0.0) {
+                rpm = target;
+            } else {
+                const double maxDelta = step / rampUs;
+                rpm += std::max(-maxDelta, std::min(maxDelta, target - rpm));
+            }
+            const double move = rpm / 60.0 * step * 1e-6;
+            if (mode == Mode::POSITION) {
+                const double remaining = targetRev - posRev;
+                if (std::fabs(move) >= std::fabs(remaining) || remaining == 0.0) {
+                    posRev = targetRev;
+                    rpm = 0.0;
+                    mode = Mode::IDLE;
+                    inPosition = true;
+                    if (arrivedUs) {
+                        *arrivedUs = t;
+                    }
+                    return true;
+                }
+            }
+            posRev += move;
+            if (mode == Mode::IDLE && rpm == 0.0) {
+                break;
+            }
+        }
+        return false;
+    }
+
+    // 修改参数命令，格式错误返回 false
+    bool applyModify(const uint8_t* frame, size_t length) {
+        (void)length;
+        switch (frame[1]) {
+            case 0x84:
+                if (frame[2] != 0x8A) return false;
+                config[cfg::SUBDIVISION] = frame[4];
+                return true;
+            case 0xAE:
+                if (frame[2] != 0x4B || frame[4] == 0) return false;
+                memcpy(pendingConfig, config, sizeof(config));
+                pendingConfig[cfg::ID] = frame[4];
+                pendingConfigValid = true;
+                return true;
+            case 0x46:
+                return frame[2] == 0x69;
+            case 0x44:
+                if (frame[2] != 0x33) return false;
+                config[cfg::OPEN_LOOP_CURRENT] = frame[4];
+                config[cfg::OPEN_LOOP_CURRENT + 1] = frame[5];
+                return true;
+            case 0x4A:
+                if (frame[2] != 0xC3) return false;
+                kp = Emm42::readU32(&frame[4]);
+                ki = Emm42::readU32(&frame[8]);
+                kd = Emm42::readU32(&frame[12]);
+                return true;
+            case 0xF7:
+                return frame[2] == 0x1C;
+            case 0x4F:
+                return frame[2] == 0x71;
+            case 0x48:
+                if (frame[2] != 0xD1) return false;
+                memcpy(pendingConfig, &frame[4], cfg::BYTES);
+                pendingConfigValid = true;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    int32_t position65536() const { return static_cast<int32_t>(std::llround(posRev * 65536.0)); }
+    int32_t target65536() const {
+        return static_cast<int32_t>(std::llround((mode == Mode::POSITION ? targetRev : posRev) * 65536.0));
+    }
+
+    uint16_t phaseCurrentMa() const {
+        if (!enabledFlag) return 0;
+        return rpm != 0.0 ? 800 : 300;
+    }
+
+    // 读取命令，未知功能码或格式错误返回 false
+    bool read(const uint8_t* frame, Emm42::Frame& reply) {
+        const uint8_t func = frame[1];
+        reply.push(address());
+        reply.push(func);
+        switch (func) {
+            case 0x1F:
+                reply.push(firmwareVersion);
+                reply.push(hardwareVersion);
+                return true;
+            case 0x20:
+                pushU16(reply, 1200);   // 相电阻 mΩ
+                pushU16(reply, 2400);   // 相电感 µH
+                return true;
+            case 0x21:
+                pushU32(reply, kp);
+                pushU32(reply, ki);
+                pushU32(reply, kd);
+                return true;
+            case 0x24:
+                pushU16(reply, busVoltageMv);
+                return true;
+            case 0x27:
+                pushU16(reply, phaseCurrentMa());
+                return true;
+            case 0x31:
+                pushU16(reply, static_cast<uint16_t>(position65536() & 0xFFFF));
+                return true;
+            case 0x32:
+                pushSigned(reply, inputPulses, 4);
+                return true;
+            case 0x33:
+            case 0x34:
+                pushSigned(reply, target65536(), 4);
+                return true;
+            case 0x35:
+                pushSigned(reply, std::lround(rpm), 2);
+                return true;
+            case 0x36:
+                pushSigned(reply, position65536(), 4);
+                return true;
+            case 0x37:
+                pushSigned(reply, 0, 4);
+                return true;
+            case 0x3A:
+                reply.push(motorStatus());
+                return true;
+            case 0x42:
+                if (frame[2] != 0x6C) return false;
+                reply.push(0x21);
+                reply.push(0x15);
+                for (size_t i = 0; i < cfg::BYTES; ++i) reply.push(config[i]);
+                return true;
+            case 0x43:
+                if (frame[2] != 0x7A) return false;
+                reply.push(0x1F);
+                reply.push(0x09);
+                pushU16(reply, busVoltageMv);
+                pushU16(reply, phaseCurrentMa());
+                pushU16(reply, static_cast<uint16_t>(position65536() & 0xFFFF));
+                pushSigned(reply, target65536(), 4);
+                pushSigned(reply, std::lround(rpm), 2);
+                pushSigned(reply, position65536(), 4);
+                pushSigned(reply, 0, 4);
+                reply.push(READY_ENCODER | READY_CALIBRATED);
+                reply.push(motorStatus());
+                return true;
+            default:
+                reply.clear();
+                return false;
+        }
+    }
+
+    uint8_t config[cfg::BYTES];
+    uint8_t pendingConfig[cfg::BYTES];
+    bool pendingConfigValid = false;
+    uint8_t firmwareVersion = 0xF5;
+    uint8_t hardwareVersion = 0x78;
+    uint16_t busVoltageMv = 24000;
+    uint32_t kp = 0x7D00, ki = 0x0064, kd = 0x7D00;
+    bool onlineFlag = true;
+
+    bool enabledFlag = false;
+    bool stallProtect = false;
+    bool inPosition = true;
+    bool reachedReply = false;          // 位置运动到达时需发送到位应答
+    Mode mode = Mode::IDLE;
+    double rpm = 0.0;                   // 当前转速（带符号）
+    double targetRpm = 0.0;             // 速度模式目标转速（带符号）
+    double cruiseRpm = 0.0;             // 位置模式运行转速
+    double posRev = 0.0;                // 实时位置（圈）
+    double targetRev = 0.0;             // 位置模式目标（圈）
+    uint8_t accelLevel = 0;
+    int64_t inputPulses = 0;
+    uint64_t lastUs = 0;
+
+    uint8_t latched[Emm42::MAX_FRAME_LEN];   // 等待多机同步触发的命令
+    size_t latchedLength = 0;
+};
+
+// 链路故障注入
+struct LinkFaults {
+    uint32_t latencyUs = 100;       // 命令帧接收完成到应答首字节开始发送的处理延迟
+    uint32_t jitterUs = 0;          // 附加延迟，在 [0, jitterUs] 内均匀分布
+    double dropRate = 0.0;          // 每字节丢失概率（双向）
+    double corruptRate = 0.0;       // 每字节随机翻转一位的概率（双向）
+};
+
+// 总线统计
+struct BusCounters {
+    uint32_t frames = 0;            // 收到的完整命令帧
+    uint32_t ignored = 0;           // 因校验失败或波特率不符被驱动器忽略的帧
+    uint32_t replies = 0;           // 发出的应答帧
+    uint32_t droppedBytes = 0;      // 注入丢失的字节（双向）
+    uint32_t corruptedBytes = 0;    // 注入翻转的字节（双向）
+};
+
+/**
+ * @brief 仿真总线：若干 VirtualDriver 共享一条半双工串口
+ *
+ * 命令帧按功能码确定长度切分；变长或未知功能码的帧在线路空闲超过 3 个字节时间后整体处理，
+ * 切分出错（如比特翻转改变了功能码）时同样由空闲间隔恢复同步。
+ * 应答在命令帧接收完成后经处理延迟排期，多个驱动器的应答在线路上依次发送、互不重叠。
+ * 主机波特率与驱动器配置的波特率不一致时，驱动器收不到有效帧（不应答）。
+ */
+class Emm42Bus {
+public:
+    explicit Emm42Bus(uint32_t baud = 115200, uint32_t seed = 1) : baud(baud), rng(seed) {}
+
+    // 添加驱动器，返回的引用在总线生命周期内有效
+    VirtualDriver& addDriver(uint8_t address, ChecksumType checksum = ChecksumType::FIXED) {
+        drivers.emplace_back(address, checksum);
+        drivers.back().setBaudRate(baud);
+        return drivers.back();
+    }
+
+    // 按地址查找驱动器，不存在返回 nullptr
+    VirtualDriver* driver(uint8_t address) {
+        for (auto& d : drivers) {
+            if (d.address() == address) return &d;
+        }
+        return nullptr;
+    }
+
+    size_t driverCount() const { return drivers.size(); }
+    VirtualDriver& driverAt(size_t index) { return drivers[index]; }
+
+    void setFaults(const LinkFaults& value) { faults = value; }
+    const LinkFaults& linkFaults() const { return faults; }
+    const BusCounters& counters() const { return stats; }
+
+    // 主机侧波特率（0 表示不检查驱动器波特率）
+    void setHostBaud(uint32_t rate) { baud = rate; }
+    uint32_t hostBaud() const { return baud; }
+
+    // n 个字节在线路上的传输时间（8N1，每字节 10 位）
+    uint64_t wireUs(size_t bytes) const {
+        const uint32_t rate = baud ? baud : 115200;
+        return static_cast<uint64_t>(bytes) * 10000000ULL / rate;
+    }
+
+    /**
+     * @brief 主机写入字节
+     * @param startUs 第一个字节开始发送的时刻；第 i 个字节在 startUs + wireUs(i + 1) 接收完成
+     */
+    void write(const uint8_t* data, size_t length, uint64_t startUs) {
+        for (size_t i = 0; i < length; ++i) {
+            uint8_t byte = data[i];
+            if (inject(byte)) {
+                receiveByte(byte, startUs + wireUs(i + 1));
+            }
+        }
+    }
+
+    // 推进驱动器运动模型并处理帧间空闲超时
+    void poll(uint64_t nowUs) {
+        if (rxLength > 0 && nowUs - lastRxUs > wireUs(IDLE_GAP_BYTES)) {
+            flushIdle();
+        }
+        for (auto& d : drivers) {
+            Emm42::Frame reached;
+            uint64_t reachedUs = nowUs;
+            if (d.advance(nowUs, reached, reachedUs)) {
+                scheduleReply(reached, reachedUs);
+            }
+        }
+    }
+
+    // 到 nowUs 为止已到达主机的应答字节数
+    int available(uint64_t nowUs) {
+        poll(nowUs);
+        int count = 0;
+        for (const auto& b : tx) {
+            if (b.atUs > nowUs) break;
+            ++count;
+        }
+        return count;
+    }
+
+    // 读取一个已到达的应答字节，没有返回 -1
+    int read(uint64_t nowUs) {
+        if (tx.empty() || tx.front().atUs > nowUs) {
+            return -1;
+        }
+        uint8_t value = tx.front().value;
+        tx.pop_front();
+        return value;
+    }
+
+    // 下一个应答字节的到达时刻，没有待发送字节返回 false
+    bool nextByteUs(uint64_t& atUs) const {
+        if (tx.empty()) return false;
+        atUs = tx.front().atUs;
+        return true;
+    }
+
+    // 丢弃尚未读取的应答字节（主机切换波特率时）
+    void flushReplies() { tx.clear(); }
+
+private:
+    struct PendingByte {
+        uint64_t atUs;
+        uint8_t value;
+    };
+
+    // 帧间空闲判定（字节时间）
+    static constexpr size_t IDLE_GAP_BYTES = 3;
+
+    bool chance(double p) {
+        return p > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < p;
+    }
+
+    // 故障注入：返回 false 表示字节丢失
+    bool inject(uint8_t& byte) {
+        if (chance(faults.dropRate)) {
+            ++stats.droppedBytes;
+            return false;
+        }
+        if (chance(faults.corruptRate)) {
+            byte ^= static_cast<uint8_t>(1u << std::uniform_int_distribution<int>(0, 7)(rng));
+            ++stats.corruptedBytes;
+        }
+        return true;
+    }
+
+    void receiveByte(uint8_t byte, uint64_t atUs) {
+        if (rxLength > 0 && atUs - lastRxUs > wireUs(IDLE_GAP_BYTES)) {
+            flushIdle();
+        }
+        lastRxUs = atUs;
+        if (rxLength >= sizeof(rx)) {
+            rxLength = 0;       // 超长帧：丢弃
+        }
+        rx[rxLength++] = byte;
+        if (rxLength >= 2) {
+            const size_t expected = commandLength(rx[1]);
+            if (expected != 0 && rxLength == expected) {
+                dispatch(rx, rxLength, atUs);
+                rxLength = 0;
+            }
+        }
+    }
+
+    // 空闲超时：缓冲中的数据整体作为一帧（变长或未知功能码）
+    void flushIdle() {
+        if (rxLength >= 3) {
+            dispatch(rx, rxLength, lastRxUs);
+        }
+        rxLength = 0;
+    }
+
+    void dispatch(const uint8_t* frame, size_t length, uint64_t endUs) {
+        ++stats.frames;
+        const uint8_t addr = frame[0];
+        for (auto& d : drivers) {
+            if (!d.online() || (addr != 0 && addr != d.address())) {
+                continue;
+            }
+            if ((baud != 0 && d.baudRate() != baud) ||
+                !Emm42::verifyChecksum(d.checksumType(), Emm42::ByteSpan(frame, length))) {
+                ++stats.ignored;
+                continue;
+            }
+            // 广播命令由地址 1 的驱动器应答
+            const bool respond = addr != 0 || d.address() == 1;
+            Emm42::Frame reply;
+            d.handle(frame, length, respond, endUs, reply);
+            if (reply.length > 0) {
+                uint64_t delay = faults.latencyUs;
+                if (faults.jitterUs > 0) {
+                    delay += std::uniform_int_distribution<uint32_t>(0, faults.jitterUs)(rng);
+                }
+                scheduleReply(reply, endUs + delay);
+            }
+        }
+    }
+
+    void scheduleReply(const Emm42::Frame& reply, uint64_t readyUs) {
+        const uint64_t startUs = std::max(readyUs, lineFreeUs);
+        for (size_t i = 0; i < reply.length; ++i) {
+            uint8_t byte = reply.bytes[i];
+            if (inject(byte)) {
+                tx.push_back({startUs + wireUs(i + 1), byte});
+            }
+        }
+        lineFreeUs = startUs + wireUs(reply.length);
+        ++stats.replies;
+    }
+
+    std::deque<VirtualDriver> drivers;
+    uint32_t baud;
+    LinkFaults faults;
+    BusCounters stats;
+    std::mt19937 rng;
+
+    uint8_t rx[Emm42::MAX_FRAME_LEN];
+    size_t rxLength = 0;
+    uint64_t lastRxUs = 0;
+
+    std::deque<PendingByte> tx;         // 已排期的应答字节（按到达时刻排序）
+    uint64_t lineFreeUs = 0;            // 驱动器→主机方向线路空闲时刻
+};
+
+} // namespace Emm42Sim
@@ -0,0 +1,87 @@
+/*
+ * @Description: 仿真总线传输层
+ *
+ * 把 Emm42Sim::Emm42Bus 接到 MotorTransport 接口上，在进程内直接驱动仿真驱动器：
+ * 主机程序（基准测试、native 环境）可以像使用 UartTransport 一样收发命令帧。
+ * 时间由 SimClock 提供：SteadyClock 使用系统单调时钟并真实等待帧的传输时间；
+ * 虚拟时间仿真可换用自行推进的时钟。
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "StepperMotor/MotorTransport.h"
+#include "Emm42Emulator.h"
+
+namespace Emm42Sim {
+
+// 仿真时钟接口
+class SimClock {
+public:
+    virtual ~SimClock() = default;
+    virtual uint64_t nowUs() = 0;
+    // 等待到指定时刻
+    virtual void sleepUntil(uint64_t us) = 0;
+};
+
+// 系统单调时钟：粗等待交给调度器，最后 200 µs 忙等以保证字节时间精度
+class SteadyClock : public SimClock {
+public:
+    uint64_t nowUs() override {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void sleepUntil(uint64_t us) override {
+        uint64_t now = nowUs();
+        if (us > now + 200) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us - now - 200));
+        }
+        while (nowUs() < us) {
+        }
+    }
+};
+
+class EmulatedTransport : public MotorTransport {
+public:
+    EmulatedTransport(Emm42Bus& bus, SimClock& clock) : bus(bus), clock(clock) {}
+
+    // 多帧拼接为一次写入，返回时全部字节已在线路上传输完成
+    bool writeFrames(const Emm42::ByteSpan* frames, size_t count) override {
+        uint8_t buffer[Emm42::MAX_FRAME_LEN * MAX_WRITE_FRAMES];
+        size_t length = 0;
+        for (size_t i = 0; i < count && i < MAX_WRITE_FRAMES; ++i) {
+            for (size_t j = 0; j < frames[i].size; ++j) {
+                buffer[length++] = frames[i].data[j];
+            }
+        }
+        const uint64_t startUs = clock.nowUs();
+        bus.write(buffer, length, startUs);
+        clock.sleepUntil(startUs + bus.wireUs(length));
+        return true;
+    }
+
+    int available() override { return bus.available(clock.nowUs()); }
+
+    int read() override { return bus.read(clock.nowUs()); }
+
+    uint32_t replyWireUs(size_t frameLen) const override {
+        return static_cast<uint32_t>(bus.wireUs(frameLen));
+    }
+
+    bool setBitRate(uint32_t rate) override {
+        bus.setHostBaud(rate);
+        bus.flushReplies();
+        return true;
+    }
+
+    uint32_t bitRate() const override { return bus.hostBaud(); }
+
+private:
+    Emm42Bus& bus;
+    SimClock& clock;
+};
+
+} // namespace Emm42Sim
@@ -0,0 +1,250 @@
+/*
+ * @Description: 伪终端上的 Emm42 驱动器仿真
+ *
+ * 创建一个伪终端，在其上仿真挂在同一条串口总线上的若干 Emm42_V5.0 驱动器（Emm42Emulator.h）。
+ * 上位机工具或 native 固件打开打印出的从设备路径（或 --link 指定的符号链接）即可像真实串口一样通讯；
+ * 从设备上设置的波特率与驱动器配置的波特率不一致时驱动器不应答，可用于验证波特率协商。
+ *
+ * 编译运行（在 Universal_chassis 目录下）：
+ *   g++ -O2 -std=gnu++17 -Iinclude sim/emm42_pty.cpp -o emm42_pty
+ *   ./emm42_pty --addr 1,2,3,4 --latency 150 --jitter 50 --drop 0.001 --link /tmp/emm42
+ */
+
+#include "Emm42Emulator.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+volatile sig_atomic_t running = 1;
+
+void onSignal(int) {
+    running = 0;
+}
+
+uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct Options {
+    std::vector<uint8_t> addresses{1, 2, 3, 4};
+    uint32_t baud = 115200;
+    ChecksumType checksum = ChecksumType::FIXED;
+    uint8_t response = Emm42Sim::RESPONSE_RECEIVE;
+    Emm42Sim::LinkFaults faults;
+    uint32_t seed = 1;
+    const char* link = nullptr;
+    bool trace = false;
+};
+
+void usage(const char* name) {
+    fprintf(stderr,
+            "用法: %s [选项]\n"
+            "  --addr 1,2,3,4        驱动器地址\n"
+            "  --baud 115200         驱动器波特率\n"
+            "  --checksum fixed|xor|crc8\n"
+            "  --response none|receive|reached|both   控制命令应答设置\n"
+            "  --latency US          应答处理延迟（默认 100）\n"
+            "  --jitter US           应答附加随机延迟上限\n"
+            "  --drop P              每字节丢失概率\n"
+            "  --corrupt P           每字节翻转一位的概率\n"
+            "  --seed N              故障注入随机种子\n"
+            "  --link PATH           为从设备创建符号链接\n"
+            "  --trace               打印收发字节\n",
+            name);
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--trace") == 0) {
+            opt.trace = true;
+            continue;
+        }
+        if (!value) {
+            return false;
+        }
+        ++i;
+        if (strcmp(arg, "--addr") == 0) {
+            opt.addresses.clear();
+            for (char* p = const_cast<char*>(value); *p; ) {
+                long a = strtol(p, &p, 0);
+                if (a < 1 || a > 255) return false;
+                opt.addresses.push_back(static_cast<uint8_t>(a));
+                if (*p == ',') ++p;
+            }
+        } else if (strcmp(arg, "--baud") == 0) {
+            opt.baud = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--checksum") == 0) {
+            if (strcmp(value, "xor") == 0) opt.checksum = ChecksumType::XOR;
+            else if (strcmp(value, "crc8") == 0) opt.checksum = ChecksumType::CRC8;
+            else if (strcmp(value, "fixed") == 0) opt.checksum = ChecksumType::FIXED;
+            else return false;
+        } else if (strcmp(arg, "--response") == 0) {
+            if (strcmp(value, "none") == 0) opt.response = Emm42Sim::RESPONSE_NONE;
+            else if (strcmp(value, "receive") == 0) opt.response = Emm42Sim::RESPONSE_RECEIVE;
+            else if (strcmp(value, "reached") == 0) opt.response = Emm42Sim::RESPONSE_REACHED;
+            else if (strcmp(value, "both") == 0) opt.response = Emm42Sim::RESPONSE_BOTH;
+            else return false;
+        } else if (strcmp(arg, "--latency") == 0) {
+            opt.faults.latencyUs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--jitter") == 0) {
+            opt.faults.jitterUs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--drop") == 0) {
+            opt.faults.dropRate = strtod(value, nullptr);
+        } else if (strcmp(arg, "--corrupt") == 0) {
+            opt.faults.corruptRate = strtod(value, nullptr);
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt.seed = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--link") == 0) {
+            opt.link = value;
+        } else {
+            return false;
+        }
+    }
+    return !opt.addresses.empty();
+}
+
+// 从设备当前设置的波特率（伪终端主设备上的 termios 即从设备的设置），未知返回 0
+uint32_t slaveBaud(int master) {
+    struct termios tio;
+    if (tcgetattr(master, &tio) != 0) {
+        return 0;
+    }
+    switch (cfgetospeed(&tio)) {
+        case B9600:    return 9600;
+        case B19200:   return 19200;
+        case B38400:   return 38400;
+        case B57600:   return 57600;
+        case B115200:  return 115200;
+#ifdef B230400
+        case B230400:  return 230400;
+#endif
+#ifdef B460800
+        case B460800:  return 460800;
+#endif
+#ifdef B921600
+        case B921600:  return 921600;
+#endif
+        default:       return 0;
+    }
+}
+
+void trace(const char* dir, const uint8_t* data, size_t length) {
+    printf("%s", dir);
+    for (size_t i = 0; i < length; ++i) {
+        printf(" %02X", data[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    const char* slaveName = ptsname(master);
+    // 保持从设备打开：没有客户端时主设备读取不会返回 EIO；同时设置为原始模式与驱动器波特率
+    int slave = open(slaveName, O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        perror("open slave");
+        return 1;
+    }
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B115200);
+    tcsetattr(slave, TCSANOW, &tio);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    if (opt.link) {
+        unlink(opt.link);
+        if (symlink(slaveName, opt.link) != 0) {
+            perror("symlink");
+        }
+    }
+
+    Emm42Sim::Emm42Bus bus(opt.baud, opt.seed);
+    bus.setFaults(opt.faults);
+    for (uint8_t addr : opt.addresses) {
+        Emm42Sim::VirtualDriver& d = bus.addDriver(addr, opt.checksum);
+        d.setCommandResponse(opt.response);
+    }
+
+    printf("emm42_pty: %s%s%s  驱动器 %zu 个  %u bps\n", slaveName, opt.link ? " -> " : "",
+           opt.link ? opt.link : "", opt.addresses.size(), opt.baud);
+    fflush(stdout);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    uint8_t buffer[256];
+    while (running) {
+        uint64_t now = nowUs();
+        bus.setHostBaud(slaveBaud(master));
+
+        ssize_t n = read(master, buffer, sizeof(buffer));
+        if (n > 0) {
+            // 字节已到达：按当前波特率倒推发送起点
+            const uint64_t wire = bus.wireUs(static_cast<size_t>(n));
+            bus.write(buffer, static_cast<size_t>(n), now > wire ? now - wire : 0);
+            if (opt.trace) {
+                trace("<-", buffer, static_cast<size_t>(n));
+            }
+        }
+
+        bus.poll(now);
+        size_t out = 0;
+        while (out < sizeof(buffer) && bus.available(now) > 0) {
+            buffer[out++] = static_cast<uint8_t>(bus.read(now));
+        }
+        if (out > 0) {
+            if (write(master, buffer, out) < 0) {
+                perror("write");
+            }
+            if (opt.trace) {
+                trace("->", buffer, out);
+            }
+        }
+
+        // 等待主机数据或下一个应答字节，最长 1 ms（推进运动模型与帧间空闲判定）
+        uint64_t waitUs = 1000;
+        uint64_t nextUs;
+        if (bus.nextByteUs(nextUs)) {
+            waitUs = nextUs > now ? std::min<uint64_t>(waitUs, nextUs - now) : 0;
+        }
+        struct pollfd pfd = {master, POLLIN, 0};
+        struct timespec ts = {0, static_cast<long>(waitUs * 1000)};
+        ppoll(&pfd, 1, &ts, nullptr);
+    }
+
+    const Emm42Sim::BusCounters& c = bus.counters();
+    printf("\nframes %u  ignored %u  replies %u  dropped %u  corrupted %u\n",
+           c.frames, c.ignored, c.replies, c.droppedBytes, c.corruptedBytes);
+    if (opt.link) {
+        unlink(opt.link);
+    }
+    close(slave);
+    close(master);
+    return 0;
+}
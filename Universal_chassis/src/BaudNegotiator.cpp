@@ -0,0 +1,297 @@
+#include "StepperMotor/BaudNegotiator.h"
+#include <Arduino.h>
+
+namespace {
+
+// 默认候选波特率：Emm42 支持的全部速率，从高到低
+constexpr uint32_t DEFAULT_CANDIDATES[] = {921600, 512000, 256000, 115200, 57600, 38400, 25000, 19200, 9600};
+
+// 切换波特率后等待驱动器与本地串口稳定的时间
+constexpr uint32_t SETTLE_MS = 5;
+
+// 判断驱动器是否在线时每个驱动器的最多读取次数
+constexpr int PRESENCE_TRIES = 3;
+
+// 当前校验方式无应答时依次尝试的校验方式
+constexpr ChecksumType CHECKSUM_TYPES[] = {ChecksumType::FIXED, ChecksumType::XOR, ChecksumType::CRC8};
+
+} // namespace
+
+BaudNegotiator::BaudNegotiator(MotorBus* bus, StepperMotor* const* motors, size_t count)
+    : bus(bus)
+{
+    for (size_t i = 0; i < count && motorCount < MAX_MOTORS; ++i) {
+        if (motors[i]) {
+            this->motors[motorCount++] = motors[i];
+        }
+    }
+    setCandidates(DEFAULT_CANDIDATES, sizeof(DEFAULT_CANDIDATES) / sizeof(DEFAULT_CANDIDATES[0]));
+    qualityMutex = xSemaphoreCreateMutex();
+}
+
+void BaudNegotiator::setCandidates(const uint32_t* rates, size_t count) {
+    candidateCount = 0;
+    for (size_t i = 0; i < count && candidateCount < MAX_CANDIDATES; ++i) {
+        candidates[candidateCount++] = rates[i];
+    }
+}
+
+void BaudNegotiator::setErrorLimits(uint16_t probesPerMotor, float maxErrorRate, float fallbackErrorRate) {
+    this->probesPerMotor = probesPerMotor;
+    this->maxErrorRate = maxErrorRate;
+    this->fallbackErrorRate = fallbackErrorRate;
+}
+
+bool BaudNegotiator::negotiate(bool persist) {
+    if (!bus || motorCount == 0) {
+        return false;
+    }
+
+    // 1. 找到驱动器当前使用的速率：先试串口已打开的速率，再按候选顺序；
+    //    该速率下应答的驱动器参与协商，未接入的驱动器不阻止其余驱动器提速
+    const uint32_t opened = bus->bitRate();
+    uint32_t current = 0;
+    if (detectAt(opened) > 0) {
+        current = opened;
+    } else {
+        for (size_t i = 0; i < candidateCount; ++i) {
+            if (candidates[i] != opened && detectAt(candidates[i]) > 0) {
+                current = candidates[i];
+                break;
+            }
+        }
+    }
+    if (current == 0) {
+        bus->changeBitRate(opened);
+        return false;
+    }
+
+    // 2. 从最高候选速率向下尝试，误码率测试通过即采用
+    for (size_t i = 0; i < candidateCount && candidates[i] > current; ++i) {
+        const uint32_t target = candidates[i];
+        if (!switchRate(current, target, false)) {
+            continue;
+        }
+        if (probe(probesPerMotor) <= maxErrorRate) {
+            current = target;
+            break;
+        }
+        // 误码率不达标：切回原速率
+        if (!switchRate(target, current, false)) {
+            // 切回失败时驱动器仍停留在 target，只能继续使用该速率
+            current = target;
+            break;
+        }
+    }
+
+    // 3. 写入 Flash，下次上电直接使用
+    if (persist) {
+        setDriverRate(current, true);
+    }
+
+    // 从协商结束时开始统计
+    lastStats = bus->linkStats();
+    lastWindowMs = millis();
+    xSemaphoreTake(qualityMutex, portMAX_DELAY);
+    linkQuality.baudRate = current;
+    xSemaphoreGive(qualityMutex);
+    return true;
+}
+
+bool BaudNegotiator::supervise() {
+    if (!bus) {
+        return false;
+    }
+    const LinkStats now = bus->linkStats();
+    const uint32_t nowMs = millis();
+    const uint32_t windowMs = nowMs - lastWindowMs;
+
+    LinkQuality q = quality();
+    q.baudRate = currentRate();
+    q.attempts = now.attempts - lastStats.attempts;
+    q.timeouts = now.timeouts - lastStats.timeouts;
+    q.checksumErrors = now.checksumErrors - lastStats.checksumErrors;
+    q.errorRate = q.attempts ? static_cast<float>(q.timeouts + q.checksumErrors) / q.attempts : 0.0f;
+    if (windowMs > 0) {
+        q.txBytesPerSec = (now.txBytes - lastStats.txBytes) * 1000.0f / windowMs;
+        q.rxBytesPerSec = (now.rxBytes - lastStats.rxBytes) * 1000.0f / windowMs;
+    }
+
+    // 误码率超标：降到下一档速率（样本过少时不判定）
+    bool fellBack = false;
+    if (q.attempts >= MIN_WINDOW_ATTEMPTS && q.errorRate > fallbackErrorRate) {
+        const uint32_t current = q.baudRate;
+        for (size_t i = 0; i < candidateCount; ++i) {
+            if (candidates[i] < current) {
+                if (switchRate(current, candidates[i], false)) {
+                    q.baudRate = candidates[i];
+                    ++q.fallbacks;
+                    fellBack = true;
+                }
+                break;
+            }
+        }
+    }
+
+    xSemaphoreTake(qualityMutex, portMAX_DELAY);
+    linkQuality = q;
+    xSemaphoreGive(qualityMutex);
+
+    // 降速过程本身的通讯不计入下一个窗口
+    lastStats = bus->linkStats();
+    lastWindowMs = millis();
+    return fellBack;
+}
+
+bool BaudNegotiator::startSupervisor(uint32_t periodMs, UBaseType_t taskPriority) {
+    if (supervisorHandle) {
+        return true;
+    }
+    this->periodMs = periodMs;
+    return xTaskCreate(supervisorTaskWrapper, "baudSupervisor", 3072, this, taskPriority, &supervisorHandle) == pdPASS;
+}
+
+void BaudNegotiator::supervisorTaskWrapper(void* param) {
+    BaudNegotiator* self = static_cast<BaudNegotiator*>(param);
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(self->periodMs));
+        self->supervise();
+    }
+}
+
+LinkQuality BaudNegotiator::quality() const {
+    LinkQuality q;
+    xSemaphoreTake(qualityMutex, portMAX_DELAY);
+    q = linkQuality;
+    xSemaphoreGive(qualityMutex);
+    return q;
+}
+
+size_t BaudNegotiator::onlineCount() const {
+    size_t count = 0;
+    for (size_t m = 0; m < motorCount; ++m) {
+        count += online[m] ? 1 : 0;
+    }
+    return count;
+}
+
+float BaudNegotiator::probe(uint16_t probesPerMotor) {
+    uint32_t attempts = 0;
+    uint32_t errors = 0;
+    for (size_t m = 0; m < motorCount; ++m) {
+        if (!online[m]) {
+            continue;
+        }
+        uint32_t replies = 0;
+        for (uint16_t i = 0; i < probesPerMotor; ++i) {
+            // 读取系统状态（31 字节应答），单次尝试、不重发、不经过熔断器
+            BusTransaction tx;
+            motors[m]->prepareReadSystemStatus(tx);
+            tx.maxRetries = 0;
+            tx.budgetUs = 0;
+            BusError error = bus->execute(tx);
+            ++attempts;
+            if (error == BusError::NONE) {
+                ++replies;
+            } else {
+                ++errors;
+            }
+        }
+        if (probesPerMotor > 0 && replies == 0) {
+            return 1.0f;
+        }
+    }
+    return attempts ? static_cast<float>(errors) / attempts : 1.0f;
+}
+
+bool BaudNegotiator::present(StepperMotor* motor, int tries) {
+    for (int i = 0; i < tries; ++i) {
+        BusTransaction tx;
+        motor->prepareReadSystemStatus(tx);
+        tx.maxRetries = 0;
+        tx.budgetUs = 0;
+        if (bus->execute(tx) == BusError::NONE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BaudNegotiator::detectAt(uint32_t rate) {
+    size_t count = 0;
+    for (size_t m = 0; m < motorCount; ++m) {
+        online[m] = false;
+    }
+    if (!bus->changeBitRate(rate)) {
+        return 0;
+    }
+    delay(SETTLE_MS);
+    for (size_t m = 0; m < motorCount; ++m) {
+        // 先以当前校验方式读取，无应答再逐一尝试其余校验方式（校验不符的命令驱动器不会应答）
+        const ChecksumType configured = motors[m]->getChecksumType();
+        online[m] = present(motors[m], PRESENCE_TRIES);
+        for (ChecksumType type : CHECKSUM_TYPES) {
+            if (online[m]) {
+                break;
+            }
+            if (type != configured) {
+                motors[m]->setChecksumType(type);
+                online[m] = present(motors[m], 1);
+            }
+        }
+        if (online[m]) {
+            ++count;
+        } else {
+            motors[m]->setChecksumType(configured);
+        }
+    }
+    return count;
+}
+
+bool BaudNegotiator::respondsAt(uint32_t rate) {
+    if (!bus->changeBitRate(rate)) {
+        return false;
+    }
+    delay(SETTLE_MS);
+    for (size_t m = 0; m < motorCount; ++m) {
+        if (online[m] && !present(motors[m], PRESENCE_TRIES)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BaudNegotiator::switchRate(uint32_t from, uint32_t to, bool persist) {
+    // 驱动器应答修改命令后才切换速率，部分驱动器的应答可能丢失，以切换后的探测结果为准
+    setDriverRate(to, persist);
+    if (respondsAt(to)) {
+        return true;
+    }
+    // 部分驱动器未切换：把已切换的驱动器改回原速率
+    setDriverRate(from, false);
+    bus->changeBitRate(from);
+    delay(SETTLE_MS);
+    return false;
+}
+
+bool BaudNegotiator::setDriverRate(uint32_t rate, bool persist) {
+    bool success = true;
+    for (size_t m = 0; m < motorCount; ++m) {
+        if (!online[m]) {
+            continue;
+        }
+        DriverConfig config;
+        if (!motors[m]->readDriverConfig(config)) {
+            success = false;
+            continue;
+        }
+        if (config.serialBaudRate == rate && !persist) {
+            continue;
+        }
+        config.serialBaudRate = rate;
+        if (!motors[m]->modifyDriverConfig(config, persist)) {
+            success = false;
+        }
+    }
+    return success;
+}
@@ -0,0 +1,268 @@
+#include "StepperMotor/CanTransport.h"
+
+//============================== CanTransport ==============================
+
+bool CanTransport::writeFrames(const Emm42::ByteSpan* frames, size_t count) {
+    if (count == 0 || count > MAX_WRITE_FRAMES) {
+        return false;
+    }
+
+    // 全部帧分包后一次提交，各帧的分包在发送队列中连续排列
+    Emm42::Can::Packet packets[MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS];
+    size_t packetCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t n = Emm42::Can::fragment(frames[i], packets + packetCount,
+                                        MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS - packetCount);
+        if (n == 0) {
+            return false;
+        }
+        packetCount += n;
+    }
+    return sendPackets(packets, packetCount);
+}
+
+int CanTransport::available() {
+    pump();
+    return static_cast<int>(rxCount);
+}
+
+int CanTransport::read() {
+    if (rxCount == 0) {
+        pump();
+        if (rxCount == 0) {
+            return -1;
+        }
+    }
+    uint8_t byte = rxBuffer[rxHead];
+    rxHead = (rxHead + 1) % RX_BUFFER_SIZE;
+    --rxCount;
+    return byte;
+}
+
+uint32_t CanTransport::replyWireUs(size_t frameLen) const {
+    return canBitrate ? static_cast<uint32_t>(Emm42::Can::frameWireBits(frameLen) * 1000000ULL / canBitrate) : 0;
+}
+
+void CanTransport::pump() {
+    Emm42::Can::Packet packet;
+    Emm42::Frame frame;
+    while (receivePacket(packet)) {
+        if (!reassembler.feed(packet, frame)) {
+            continue;
+        }
+        // 缓冲区满时丢弃整帧，由应答超时处理
+        if (frame.length > RX_BUFFER_SIZE - rxCount) {
+            continue;
+        }
+        for (size_t i = 0; i < frame.length; ++i) {
+            rxBuffer[(rxHead + rxCount) % RX_BUFFER_SIZE] = frame.bytes[i];
+            ++rxCount;
+        }
+    }
+}
+
+//============================== TwaiTransport ==============================
+
+#if defined(ESP_PLATFORM)
+
+#include <Arduino.h>
+#include "driver/twai.h"
+
+TwaiTransport::TwaiTransport(int txPin, int rxPin, uint32_t bitrate)
+    : CanTransport(bitrate), txPin(txPin), rxPin(rxPin)
+{
+}
+
+bool TwaiTransport::begin() {
+    if (started) {
+        return true;
+    }
+
+    twai_timing_config_t timing;
+    switch (bitRate()) {
+        case 125000:  timing = TWAI_TIMING_CONFIG_125KBITS(); break;
+        case 250000:  timing = TWAI_TIMING_CONFIG_250KBITS(); break;
+        case 500000:  timing = TWAI_TIMING_CONFIG_500KBITS(); break;
+        case 800000:  timing = TWAI_TIMING_CONFIG_800KBITS(); break;
+        case 1000000: timing = TWAI_TIMING_CONFIG_1MBITS(); break;
+        default:      return false;
+    }
+    twai_general_config_t general = TWAI_GENERAL_CONFIG_DEFAULT(
+        static_cast<gpio_num_t>(txPin), static_cast<gpio_num_t>(rxPin), TWAI_MODE_NORMAL);
+    // 发送队列容纳一次突发的全部分包，接收队列容纳四轮系统状态应答的全部分包
+    general.tx_queue_len = MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS;
+    general.rx_queue_len = 64;
+    twai_filter_config_t filter = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+
+    if (twai_driver_install(&general, &timing, &filter) != ESP_OK) {
+        return false;
+    }
+    if (twai_start() != ESP_OK) {
+        twai_driver_uninstall();
+        return false;
+    }
+    started = true;
+    return true;
+}
+
+bool TwaiTransport::sendPackets(const Emm42::Can::Packet* packets, size_t count) {
+    if (!started) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        twai_message_t message = {};
+        message.extd = 1;
+        message.identifier = packets[i].id;
+        message.data_length_code = packets[i].length;
+        for (uint8_t j = 0; j < packets[i].length; ++j) {
+            message.data[j] = packets[i].data[j];
+        }
+        if (twai_transmit(&message, 0) != ESP_OK) {
+            return false;
+        }
+    }
+
+    // 等待发送队列清空（与串口 flush 语义一致），上限为全部分包按最坏情况发送时间的两倍
+    uint32_t limitUs = static_cast<uint32_t>(count * 160ULL * 1000000ULL / bitRate()) * 2 + 1000;
+    uint32_t startUs = micros();
+    twai_status_info_t status;
+    while (twai_get_status_info(&status) == ESP_OK && status.msgs_to_tx > 0) {
+        if (micros() - startUs > limitUs) {
+            return false;
+        }
+        delayMicroseconds(20);
+    }
+    return true;
+}
+
+bool TwaiTransport::receivePacket(Emm42::Can::Packet& packet) {
+    if (!started) {
+        return false;
+    }
+    twai_message_t message;
+    while (twai_receive(&message, 0) == ESP_OK) {
+        // 只接受扩展数据帧
+        if (!message.extd || message.rtr) {
+            continue;
+        }
+        packet.id = message.identifier;
+        packet.length = message.data_length_code > 8 ? 8 : message.data_length_code;
+        for (uint8_t j = 0; j < packet.length; ++j) {
+            packet.data[j] = message.data[j];
+        }
+        return true;
+    }
+    return false;
+}
+
+#endif
+
+//============================== SocketCanTransport ==============================
+
+#if defined(__linux__)
+
+#include <cstring>
+#include <fcntl.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+SocketCanTransport::SocketCanTransport(const char* ifname, uint32_t bitrate)
+    : CanTransport(bitrate), ifname(ifname)
+{
+}
+
+SocketCanTransport::~SocketCanTransport() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool SocketCanTransport::begin() {
+    if (fd >= 0) {
+        return true;
+    }
+    int sock = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (sock < 0) {
+        return false;
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
+        close(sock);
+        return false;
+    }
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(sock);
+        return false;
+    }
+
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    fd = sock;
+    return true;
+}
+
+bool SocketCanTransport::sendPackets(const Emm42::Can::Packet* packets, size_t count) {
+    if (fd < 0) {
+        return false;
+    }
+
+    // 全部分包通过一次 sendmmsg 提交给内核发送队列
+    struct can_frame frames[MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS];
+    struct iovec iovs[MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS];
+    struct mmsghdr msgs[MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS];
+    if (count > MAX_WRITE_FRAMES * Emm42::Can::MAX_PACKETS) {
+        return false;
+    }
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (size_t i = 0; i < count; ++i) {
+        memset(&frames[i], 0, sizeof(frames[i]));
+        frames[i].can_id = (packets[i].id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        frames[i].can_dlc = packets[i].length;
+        memcpy(frames[i].data, packets[i].data, packets[i].length);
+        iovs[i].iov_base = &frames[i];
+        iovs[i].iov_len = sizeof(frames[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    while (sent < count) {
+        int n = sendmmsg(fd, msgs + sent, static_cast<unsigned int>(count - sent), 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool SocketCanTransport::receivePacket(Emm42::Can::Packet& packet) {
+    if (fd < 0) {
+        return false;
+    }
+    struct can_frame frame;
+    while (::read(fd, &frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame))) {
+        // 只接受扩展数据帧
+        if (!(frame.can_id & CAN_EFF_FLAG) || (frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+            continue;
+        }
+        packet.id = frame.can_id & CAN_EFF_MASK;
+        packet.length = frame.can_dlc > 8 ? 8 : frame.can_dlc;
+        memcpy(packet.data, frame.data, packet.length);
+        return true;
+    }
+    return false;
+}
+
+#endif
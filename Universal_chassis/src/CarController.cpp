@@ -1,14 +1,38 @@
 #include "CarController/CarController.h"
+#include <Arduino.h>
 #include <cmath>
 #include <array>
 
-// 构造函数：保存传入对象指针，并初始化默认参数
+// 构造函数：单总线拓扑，motor0 为唯一总线上的广播电机
 CarController::CarController(StepperMotor* motorRF, StepperMotor* motorRR,
                              StepperMotor* motorLR, StepperMotor* motorLF,
                              StepperMotor* motor0, KinematicsModel* kinematicsModel)
+    : CarController(motorRF, motorRR, motorLR, motorLF, {motor0}, kinematicsModel)
+{
+}
+
+// 构造函数：保存传入对象指针，并初始化默认参数
+CarController::CarController(StepperMotor* motorRF, StepperMotor* motorRR,
+                             StepperMotor* motorLR, StepperMotor* motorLF,
+                             std::initializer_list<StepperMotor*> broadcastMotors,
+                             KinematicsModel* kinematicsModel)
     : motorRF(motorRF), motorRR(motorRR), motorLR(motorLR), motorLF(motorLF),
-      motor0(motor0), kinematics(kinematicsModel)
+      kinematics(kinematicsModel),
+      wheels{motorRF, motorRR, motorLR, motorLF}
 {
+    // 每条总线一个广播电机（地址 0），超出 MAX_BUSES 的部分忽略
+    for (auto motor : broadcastMotors) {
+        if (motor && busCount < MAX_BUSES)
+            broadcasters[busCount++] = motor;
+    }
+    // 广播命令由地址 1 的驱动器应答：总线上没有地址 1 的车轮时广播控制命令不等待应答
+    for (size_t b = 0; b < busCount; ++b) {
+        bool replies = false;
+        for (auto wheel : wheels)
+            replies = replies || (wheel->address() == 1 && wheel->bus() == broadcasters[b]->bus());
+        broadcasters[b]->setBroadcastReplies(replies);
+    }
+
     // 初始化默认控制参数
     defaultConfig.defaultAcceleration = 10.0f;
     defaultConfig.defaultSubdivision = 256;
@@ -22,12 +46,21 @@ CarController::CarController(StepperMotor* motorRF, StepperMotor* motorRR,
     currentState.wheelSpeeds[1] = 0;
     currentState.wheelSpeeds[2] = 0;
     currentState.wheelSpeeds[3] = 0;
- 
-    //使能所有的电机
-    motorRF->enableMotor(true, false);
-    motorRR->enableMotor(true, false);
-    motorLR->enableMotor(true, false);
-    motorLF->enableMotor(true, false);
+    currentState.wheelHealth.fill(MotorHealth::HEALTHY);
+    currentState.telemetry = TelemetrySnapshot{};
+
+    // 不设调用预算：启动阶段的使能等调用按重发次数照常重发，运行时预算由 ControlManager 设置
+    estopMutex = xSemaphoreCreateMutex();
+}
+
+// 使能/关闭全部车轮电机：先全部提交再统一等待，多总线时并行执行
+BusResult CarController::enableMotors(bool enable) {
+    std::array<BusTransaction, 4> txs;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        wheels[i]->prepareEnable(txs[i], enable);
+        wheels[i]->submit(txs[i]);
+    }
+    return awaitWheelAcks(txs);
 }
 
 // 设置默认控制参数（加速度、细分数）配置接口
@@ -36,60 +69,70 @@ void CarController::configure(const CarControllerConfig& config) {
 }
 
 // 速度模式控制（使用默认加速度）
-bool CarController::setSpeed(float vx, float vy, float omega) {
+BusResult CarController::setSpeed(float vx, float vy, float omega) {
     return setSpeed(vx, vy, omega, defaultConfig.defaultAcceleration, defaultConfig.defaultSubdivision);       //加速度调用默认加速度
 }
 
 // 速度模式控制（自定义加速度）  
 // 本函数通过运动学模型计算各电机的转速指令，并将负值转为方向信息传递给电机控制
-bool CarController::setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision) {
+BusResult CarController::setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision) {
+    return setSpeed(vx, vy, omega, acceleration, subdivision, estopGeneration());
+}
+
+// 速度模式控制（指定命令所属的紧急停止代数）：提交后等待全部应答
+BusResult CarController::setSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision,
+                             uint32_t generation) {
+    BusResult result = beginSetSpeed(vx, vy, omega, acceleration, subdivision, generation);
+    if (!result)
+        return result;
+    return finishMotion();
+}
+
+// 提交速度命令，不等待应答
+BusResult CarController::beginSetSpeed(float vx, float vy, float omega, float acceleration, uint16_t subdivision,
+                                       uint32_t generation) {
+    (void)subdivision;  // 速度模式按转速下发，与细分无关
     // 计算速度指令
     // 注意：这里假设运动学模型的 calculateSpeedCommands 输出类型已修改为 std::array<int16_t, 4>
     std::array<int16_t, 4> speedCommands;
     kinematics->calculateSpeedCommands(vx, vy, omega, reinterpret_cast<std::array<uint16_t, 4>&>(speedCommands));
     
-    bool success = true;
-    
-    // 对每个电机，分解速度正负得到方向和速度幅值
+    // 对每个电机，分解速度正负得到方向和速度幅值，构造带同步标志的命令事务，
+    // 与广播同步触发帧在一次串口写入中发出，四个车轮在收到触发帧时同时启动
     // 轮序：0-右前轮, 1-右后轮, 2-左后轮, 3-左前轮
-    int16_t cmd = speedCommands[0];
-    uint8_t dirRF = (cmd >= 0) ? 1 : 0;
-    uint16_t rpmRF = static_cast<uint16_t>(std::abs(cmd));
-    if (!motorRF->setSpeedMode(dirRF, rpmRF, static_cast<uint8_t>(acceleration), false))
-        success = false;
-    
-    cmd = speedCommands[1];
-    uint8_t dirRR = (cmd >= 0) ? 1 : 0;
-    uint16_t rpmRR = static_cast<uint16_t>(std::abs(cmd));
-    if (!motorRR->setSpeedMode(dirRR, rpmRR, static_cast<uint8_t>(acceleration), false))
-        success = false;
-    
-    cmd = speedCommands[2];
-    uint8_t dirLR = (cmd >= 0) ? 1 : 0;
-    uint16_t rpmLR = static_cast<uint16_t>(std::abs(cmd));
-    if (!motorLR->setSpeedMode(dirLR, rpmLR, static_cast<uint8_t>(acceleration), false))
-        success = false;
-    
-    cmd = speedCommands[3];
-    uint8_t dirLF = (cmd >= 0) ? 1 : 0;
-    uint16_t rpmLF = static_cast<uint16_t>(std::abs(cmd));
-    if (!motorLF->setSpeedMode(dirLF, rpmLF, static_cast<uint8_t>(acceleration), false))
-        success = false;
-    
-    // 触发多机同步运动
-    if (!motorRF->syncMove())
-        success = false;
-    
-    return success;
+    finishMotion();     // 上一条运动命令的事务须先完成才能复用
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        int16_t cmd = speedCommands[i];
+        uint8_t dir = (cmd >= 0) ? 1 : 0;
+        uint16_t rpm = static_cast<uint16_t>(std::abs(cmd));
+        wheels[i]->prepareSpeedMode(motionTxs[i], dir, rpm, static_cast<uint8_t>(acceleration), true);
+    }
+
+    return sendSyncBurst(generation);
 }
 
 // 位置模式控制（使用默认控制参数）
-bool CarController::moveDistance(float dx, float dy, float dtheta) {
+BusResult CarController::moveDistance(float dx, float dy, float dtheta) {
     return moveDistance(dx, dy, dtheta, defaultConfig.defaultAcceleration, defaultConfig.defaultSpeed, defaultConfig.defaultSubdivision);
 }
 
 // 位置模式控制（完整参数版本）  
-bool CarController::moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision) {
+BusResult CarController::moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision) {
+    return moveDistance(dx, dy, dtheta, acceleration, speed, subdivision, estopGeneration());
+}
+
+// 位置模式控制（指定命令所属的紧急停止代数）：提交后等待全部应答
+BusResult CarController::moveDistance(float dx, float dy, float dtheta, float acceleration, float speed, uint16_t subdivision,
+                                 uint32_t generation) {
+    BusResult result = beginMoveDistance(dx, dy, dtheta, acceleration, speed, subdivision, generation);
+    if (!result)
+        return result;
+    return finishMotion();
+}
+
+// 提交位置命令，不等待应答
+BusResult CarController::beginMoveDistance(float dx, float dy, float dtheta, float acceleration, float speed,
+                                           uint16_t subdivision, uint32_t generation) {
     std::array<int32_t, 4> pulseCommands;
     kinematics->calculatePositionCommands(dx, dy, dtheta, pulseCommands, subdivision);
     
@@ -114,69 +157,432 @@ bool CarController::moveDistance(float dx, float dy, float dtheta, float acceler
     // 如果计算出的速度为0，使用默认速度
     uint16_t speedRpm = (maxSpeed > 0) ? maxSpeed : 100;
     
-    bool success = true;    
-    
-    int32_t pulses = pulseCommands[0];
-    uint8_t dirRF = (pulses >= 0) ? 1 : 0;  // 正方向为1，负方向为0
-    uint32_t absPulsesRF = static_cast<uint32_t>(std::abs(pulses));
-    if (!motorRF->setPositionMode(dirRF, speedRpm, static_cast<uint8_t>(acceleration), absPulsesRF, false, false))
-        success = false;
-    
-    pulses = pulseCommands[1];
-    uint8_t dirRR = (pulses >= 0) ? 1 : 0;
-    uint32_t absPulsesRR = static_cast<uint32_t>(std::abs(pulses));
-    if (!motorRR->setPositionMode(dirRR, speedRpm, static_cast<uint8_t>(acceleration), absPulsesRR, false, false))
-        success = false;
-    
-    pulses = pulseCommands[2];
-    uint8_t dirLR = (pulses >= 0) ? 1 : 0;
-    uint32_t absPulsesLR = static_cast<uint32_t>(std::abs(pulses));
-    if (!motorLR->setPositionMode(dirLR, speedRpm, static_cast<uint8_t>(acceleration), absPulsesLR, false, false))
-        success = false;
-    
-    pulses = pulseCommands[3];
-    uint8_t dirLF = (pulses >= 0) ? 1 : 0;
-    uint32_t absPulsesLF = static_cast<uint32_t>(std::abs(pulses));
-    if (!motorLF->setPositionMode(dirLF, speedRpm, static_cast<uint8_t>(acceleration), absPulsesLF, false, false))
-        success = false;
-    
-    // 触发多机同步运动
-    if (!motorRF->syncMove())
-        success = false;
-    
-    return success;
+    finishMotion();     // 上一条运动命令的事务须先完成才能复用
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        int32_t pulses = pulseCommands[i];
+        uint8_t dir = (pulses >= 0) ? 1 : 0;  // 正方向为1，负方向为0
+        uint32_t absPulses = static_cast<uint32_t>(std::abs(pulses));
+        wheels[i]->preparePositionMode(motionTxs[i], dir, speedRpm, static_cast<uint8_t>(acceleration), absPulses, false, true);
+    }
+
+    return sendSyncBurst(generation);
+}
+
+// 带同步标志的车轮命令按总线分组提交，不等待应答；
+// 提交前在紧急停止锁内检查代数，命令发出之后（包括帧构造期间）发生过紧急停止则不再提交
+BusResult CarController::sendSyncBurst(uint32_t generation) {
+
+    // 按总线分组；已熔断的车轮不进入突发，其余车轮照常下发
+    BusTransaction* groups[MAX_BUSES][4];
+    size_t counts[MAX_BUSES] = {};
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        if (!wheels[i]->admit(motionTxs[i]))
+            continue;
+        int b = busIndexOf(wheels[i]);
+        if (b < 0) {
+            motionTxs[i].fail(BusError::NO_PORT);   // 车轮所在总线没有配置广播电机
+            continue;
+        }
+        groups[b][counts[b]++] = &motionTxs[i];
+    }
+
+    triggerBuses = 0;
+    for (size_t b = 0; b < busCount; ++b) {
+        if (counts[b] > 0 || busCount == 1)     // 多总线时没有待触发车轮的总线不发送触发帧
+            triggerBuses |= 1u << b;
+    }
+
+    const bool allowed = beginMotionSubmit(generation);
+    bool accepted = allowed;
+    if (allowed && busCount == 1) {
+        // 单总线：车轮命令与同步触发帧在一次串口写入中发出
+        accepted = broadcasters[0]->submitSyncBurst(groups[0], counts[0], syncTxs[0]);
+    } else if (allowed) {
+        // 多总线：各总线并行写出车轮命令，车轮应答后再在各总线上背靠背提交同步触发帧
+        for (size_t b = 0; b < busCount; ++b) {
+            if (counts[b] > 0)
+                broadcasters[b]->bus()->submitBurst(groups[b], counts[b]);
+        }
+    }
+    endMotionSubmit();
+    if (!allowed)
+        return dropMotion();
+    if (!accepted)
+        return BusError::QUEUE_FULL;
+
+    pendingGeneration = generation;
+    if (busCount == 1) {
+        motionGeneration = generation;
+        motionStage = MotionStage::TRIGGERED;
+    } else {
+        motionStage = MotionStage::WHEEL_ACKS;
+    }
+    return BusResult();
+}
+
+// 多总线：在各总线上背靠背提交同步触发帧，各总线任务几乎同时写出，车轮的启动时刻差仅为任务唤醒的时间差。
+// 等待应答期间发生紧急停止：车轮已收到带同步标志的命令，不再发送触发帧即不会启动
+bool CarController::triggerMotion() {
+    const bool allowed = beginMotionSubmit(pendingGeneration);
+    for (size_t b = 0; allowed && b < busCount; ++b) {
+        broadcasters[b]->prepareSyncMove(syncTxs[b]);
+        syncTxs[b].priority = BusPriority::HIGH;
+        if (triggerBuses & (1u << b))
+            broadcasters[b]->submit(syncTxs[b]);
+    }
+    endMotionSubmit();
+    if (!allowed)
+        return false;
+    motionGeneration = pendingGeneration;
+    motionStage = MotionStage::TRIGGERED;
+    return true;
+}
+
+// 推进已提交的运动命令
+bool CarController::collectMotion(BusResult& result) {
+    if (motionStage == MotionStage::IDLE || !motionSettled())
+        return false;
+    if (motionStage == MotionStage::WHEEL_ACKS) {
+        // 车轮应答已全部完成：提交同步触发帧，其应答留到之后收集
+        if (triggerMotion() && !motionSettled())
+            return false;
+    }
+    result = finishMotion();
+    return true;
+}
+
+// 等待进行中的运动命令全部完成（事务均已完成时不阻塞）
+BusResult CarController::finishMotion() {
+    if (motionStage == MotionStage::IDLE)
+        return BusResult();
+
+    BusResult result = awaitWheelAcks(motionTxs);
+    if (motionStage == MotionStage::WHEEL_ACKS && !triggerMotion()) {
+        motionStage = MotionStage::IDLE;
+        return dropMotion();
+    }
+    motionStage = MotionStage::IDLE;
+    for (size_t b = 0; b < busCount; ++b) {
+        if (!(triggerBuses & (1u << b)))
+            continue;
+        broadcasters[b]->await(syncTxs[b]);
+        result.merge(broadcasters[b]->ackError(syncTxs[b]));
+    }
+    return result;
+}
+
+// 进行中的运动命令是否已全部完成
+bool CarController::motionSettled() const {
+    for (const auto& tx : motionTxs) {
+        if (!tx.isDone())
+            return false;
+    }
+    if (motionStage != MotionStage::TRIGGERED)
+        return true;
+    for (size_t b = 0; b < busCount; ++b) {
+        if ((triggerBuses & (1u << b)) && !syncTxs[b].isDone())
+            return false;
+    }
+    return true;
+}
+
+// 持有紧急停止锁并检查代数
+bool CarController::beginMotionSubmit(uint32_t generation) {
+    xSemaphoreTake(estopMutex, portMAX_DELAY);
+    return estopGen.load(std::memory_order_relaxed) == generation;
+}
+
+void CarController::endMotionSubmit() {
+    xSemaphoreGive(estopMutex);
+}
+
+// 运动命令因紧急停止被丢弃
+BusResult CarController::dropMotion() {
+    for (auto wheel : wheels)
+        wheel->discardSpeedSetpoint();
+    return BusError::PREEMPTED;
+}
+
+// 重发车轮 i 丢失的速度设定值
+void CarController::resendSetpoint(size_t i) {
+    BusTransaction tx;
+    if (!wheels[i]->prepareResendSpeedSetpoint(tx))
+        return;
+    const bool allowed = beginMotionSubmit(motionGeneration);
+    if (allowed)
+        wheels[i]->submit(tx);
+    endMotionSubmit();
+    if (allowed)
+        wheels[i]->await(tx);
+    else
+        wheels[i]->discardSpeedSetpoint();  // 构造事务时已重新记录，停止后不再验证
+}
+
+// 更新已熔断车轮的位掩码
+void CarController::publishWheelHealth() {
+    uint8_t open = 0;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        if (wheels[i]->health() == MotorHealth::OPEN)
+            open |= 1u << i;
+    }
+    openWheels.store(open, std::memory_order_relaxed);
+}
+
+// 等待四个车轮的命令事务完成，结果为第一个失败车轮的错误
+BusResult CarController::awaitWheelAcks(std::array<BusTransaction, 4>& txs) {
+    BusResult result;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        wheels[i]->await(txs[i]);
+        result.merge(wheels[i]->ackError(txs[i]));
+    }
+    publishWheelHealth();
+    return result;
+}
+
+// 查找电机所在总线对应的广播电机序号，未配置返回 -1
+int CarController::busIndexOf(const StepperMotor* motor) const {
+    for (size_t b = 0; b < busCount; ++b) {
+        if (broadcasters[b]->bus() == motor->bus())
+            return static_cast<int>(b);
+    }
+    return -1;
+}
+
+// 启用/关闭免应答控制命令模式，四个车轮与广播电机需全部切换成功
+BusResult CarController::setUnacknowledgedMode(bool enable) {
+    BusResult result;
+    for (auto wheel : wheels)
+        result.merge(wheel->enableUnacknowledgedMode(enable).error);
+    for (size_t b = 0; b < busCount; ++b)
+        result.merge(broadcasters[b]->enableUnacknowledgedMode(enable).error);
+    // 部分电机启用失败时全部回退，避免同一突发中混合两种应答方式
+    if (!result && enable)
+        setUnacknowledgedMode(false);
+    return result;
+}
+
+// 电机表是否包含四个车轮且配置有效
+bool CarController::coversWheels(const MotorTable& table) const {
+    for (auto wheel : wheels) {
+        int b = busIndexOf(wheel);
+        const MotorProfile* profile = b < 0 ? nullptr : table.find(wheel->address(), static_cast<uint8_t>(b));
+        if (!profile || !profile->configValid)
+            return false;
+    }
+    return true;
+}
+
+// 应用启动探测得到的电机表
+bool CarController::applyMotorTable(const MotorTable& table) {
+    bool consistent = true;
+    std::array<bool, MAX_BUSES> busChecksumSet{};
+    const MotorProfile* reference = nullptr;   // 第一个读到配置的车轮，其余车轮与之比较
+    bool sameSteps = true, sameSubdivision = true, sameResponse = true;
+
+    for (auto wheel : wheels) {
+        int b = busIndexOf(wheel);
+        const MotorProfile* profile = b < 0 ? nullptr : table.find(wheel->address(), static_cast<uint8_t>(b));
+        if (!profile) {
+            wheel->markAbsent();
+            consistent = false;
+            continue;
+        }
+        wheel->setChecksumType(profile->checksumType);
+        // 广播帧只有一种校验方式：同一总线上的驱动器须一致
+        if (!busChecksumSet[b]) {
+            broadcasters[b]->setChecksumType(profile->checksumType);
+            busChecksumSet[b] = true;
+        } else if (broadcasters[b]->getChecksumType() != profile->checksumType) {
+            consistent = false;
+        }
+
+        if (!profile->configValid) {
+            consistent = false;
+            continue;
+        }
+        if (!reference) {
+            reference = profile;
+            continue;
+        }
+        sameSteps = sameSteps && profile->fullStepsPerRev() == reference->fullStepsPerRev();
+        sameSubdivision = sameSubdivision && profile->config.subdivision == reference->config.subdivision;
+        sameResponse = sameResponse && profile->config.cmdResponse == reference->config.cmdResponse;
+    }
+
+    publishWheelHealth();
+    if (!reference) {
+        return false;
+    }
+    if (sameSteps) {
+        kinematics->setFullStepsPerRevolution(reference->fullStepsPerRev());
+    }
+    if (sameSubdivision) {
+        defaultConfig.defaultSubdivision = reference->config.subdivision;
+    }
+    if (sameResponse) {
+        // 广播命令由地址 1 的驱动器应答，与车轮使用相同的应答设置
+        for (auto wheel : wheels)
+            wheel->assumeCommandResponse(reference->config.cmdResponse);
+        for (size_t b = 0; b < busCount; ++b)
+            broadcasters[b]->assumeCommandResponse(reference->config.cmdResponse);
+    }
+    return consistent && sameSteps && sameSubdivision && sameResponse;
 }
 
-// 紧急停止所有电机
+// 停止所有电机
 bool CarController::stop() {
-    bool success = true;
-    //停止主控板步进电机
-    if (!motor0->stopMotor(false))
-        success = false;
+    return emergencyStop(micros());
+}
+
+// 紧急停止：抢占总线广播停止，再回读转速确认
+// 可在任意任务中执行：只读取车轮的常量配置，熔断状态取自控制任务发布的位掩码
+bool CarController::emergencyStop(uint32_t receivedUs) {
+    xSemaphoreTake(estopMutex, portMAX_DELAY);
+    // 锁存：此前发出的运动命令不再提交
+    estopGen.fetch_add(1, std::memory_order_release);
+
+    // 需要确认的车轮：已熔断（不在线）的车轮不会应答，不参与确认
+    uint8_t moving = static_cast<uint8_t>(~openWheels.load(std::memory_order_relaxed) & 0x0F);
 
-    return success;
+    std::array<BusTransaction, MAX_BUSES> stopTxs;
+    std::array<BusTransaction, 4> reads;
+    uint32_t latencyUs = 0;
+    uint8_t attempts = 0;
+    do {
+        ++attempts;
+        // 各总线同时抢占，停止帧不等待应答
+        for (size_t b = 0; b < busCount; ++b) {
+            broadcasters[b]->prepareStopCommand(stopTxs[b], false);
+            broadcasters[b]->bus()->preempt(stopTxs[b]);
+        }
+        for (size_t b = 0; b < busCount; ++b) {
+            broadcasters[b]->bus()->wait(stopTxs[b]);
+            // 端到端延迟只统计第一次广播：收到命令到停止帧发送完成
+            if (attempts == 1 && stopTxs[b].ok()) {
+                uint32_t sentUs = stopTxs[b].firstSendUs + stopTxs[b].latencyUs - receivedUs;
+                if (sentUs > latencyUs)
+                    latencyUs = sentUs;
+            }
+        }
+
+        // 回读实时转速确认停止，HIGH 优先级不受周期预算限制
+        for (size_t i = 0; i < wheels.size(); ++i) {
+            if (moving & (1u << i)) {
+                wheels[i]->prepareReadRealTimeSpeed(reads[i]);
+                reads[i].priority = BusPriority::HIGH;
+                wheels[i]->bus()->submit(reads[i]);
+            }
+        }
+        for (size_t i = 0; i < wheels.size(); ++i) {
+            if (!(moving & (1u << i)))
+                continue;
+            wheels[i]->bus()->wait(reads[i]);
+            int16_t rpm;
+            if (wheels[i]->parseRealTimeSpeed(reads[i], rpm) && rpm == 0)
+                moving &= ~(1u << i);
+        }
+    } while (moving && attempts < ESTOP_MAX_ATTEMPTS);
+
+    ++estopStats.count;
+    estopStats.lastUs = latencyUs;
+    if (latencyUs > estopStats.maxUs)
+        estopStats.maxUs = latencyUs;
+    estopTotalUs += latencyUs;
+    estopStats.avgUs = static_cast<uint32_t>(estopTotalUs / estopStats.count);
+    if (latencyUs > ESTOP_TARGET_US)
+        ++estopStats.overTarget;
+    if (moving)
+        ++estopStats.unconfirmed;
+    estopStats.lastAttempts = attempts;
+    estopStats.lastMovingMask = moving;
+    xSemaphoreGive(estopMutex);
+    return moving == 0;
+}
+
+EStopStats CarController::getEStopStats() const {
+    xSemaphoreTake(estopMutex, portMAX_DELAY);
+    EStopStats stats = estopStats;
+    xSemaphoreGive(estopMutex);
+    return stats;
 }
 
 // 获取当前小车状态
 // 读取各个步进电机的反馈转速，并填充到 currentState.wheelSpeeds 中；其他速度信息此处暂设为0
 CarState CarController::getCarState() {
+    beginStatePoll();
+    finishStatePoll();
+    return currentState;
+}
+
+// 提交状态轮询
+// 每个车轮一次读取系统状态（0x43），一帧应答即包含转速、位置、电流等全部遥测；
+// 四个读取事务一次性提交，总线任务在上一帧应答完成后立即发送下一帧；
+// 已熔断的车轮除低频探测外不占用总线
+bool CarController::beginStatePoll() {
+    if (pollInFlight)
+        return false;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        wheels[i]->prepareReadSystemStatus(pollTxs[i]);
+        wheels[i]->submit(pollTxs[i]);
+    }
+    pollInFlight = true;
+    return true;
+}
+
+// 收集已完成的状态轮询
+bool CarController::collectCarState(CarState& state) {
+    if (!pollInFlight)
+        return false;
+    for (const auto& tx : pollTxs) {
+        if (!tx.isDone())
+            return false;
+    }
+    finishStatePoll();
+    state = currentState;
+    return true;
+}
+
+// 等待并解析状态轮询（事务均已完成时不阻塞）
+void CarController::finishStatePoll() {
+    if (!pollInFlight)
+        return;
+    pollInFlight = false;
+
     std::array<int16_t, 4> speeds;
-    int16_t sRF, sRR, sLR, sLF;
-    if (!motorRF->readRealTimeSpeed(sRF))
-        sRF = 0;
-    if (!motorRR->readRealTimeSpeed(sRR))
-        sRR = 0;
-    if (!motorLR->readRealTimeSpeed(sLR))
-        sLR = 0;
-    if (!motorLF->readRealTimeSpeed(sLF))
-        sLF = 0;
-    speeds[0] = static_cast<uint16_t>(sRF);
-    speeds[1] = static_cast<uint16_t>(sRR);
-    speeds[2] = static_cast<uint16_t>(sLR);
-    speeds[3] = static_cast<uint16_t>(sLF);
-    // 如果有符号整数的值是负数，那么转换为无符号类型后，它的值会变成一个大的正数
-    kinematics->calculateWheelSpeeds(reinterpret_cast<std::array<int16_t, 4>&>(speeds),currentState.vx,currentState.vy,currentState.omega);
-    
+    TelemetrySnapshot& telemetry = currentState.telemetry;
+    for (size_t i = 0; i < wheels.size(); ++i) {
+        wheels[i]->await(pollTxs[i]);
+        currentState.wheelHealth[i] = wheels[i]->health();
+        telemetry.valid[i] = wheels[i]->parseSystemStatus(pollTxs[i], telemetry.wheels[i]);
+        if (!telemetry.valid[i]) {
+            speeds[i] = 0;
+            continue;
+        }
+        speeds[i] = telemetry.wheels[i].realTimeSpeed;
+        // 免应答模式：用实测转速验证上一次速度设定值是否送达，丢失则单独重发
+        if (wheels[i]->verifySpeedSetpoint(speeds[i]) == SetpointCheck::LOST)
+            resendSetpoint(i);
+    }
+    publishWheelHealth();
+    telemetry.timestampMs = millis();
+    kinematics->calculateWheelSpeeds(speeds, currentState.vx, currentState.vy, currentState.omega);
+
     currentState.wheelSpeeds = speeds;
-    return currentState;
+}
+
+// 设置车轮单次调用的时间预算
+void CarController::setCallBudget(uint32_t budgetUs) {
+    for (auto wheel : wheels)
+        wheel->setCallBudget(budgetUs);
+}
+
+// 至少容纳一次重发的车轮调用预算：各车轮读取系统状态（0x43）所需预算的最大值
+uint32_t CarController::minCallBudgetUs() const {
+    uint32_t budgetUs = 0;
+    for (auto wheel : wheels) {
+        const uint32_t wheelUs = wheel->retryBudgetUs(0x43);
+        if (wheelUs > budgetUs)
+            budgetUs = wheelUs;
+    }
+    return budgetUs;
 }
@@ -12,6 +12,26 @@ NormalWheelKinematics::NormalWheelKinematics(float wheelRadius, float trackWidth
     wheelCircumference = 2.0f * static_cast<float>(M_PI) * wheelRadius;
 }
 
+bool NormalWheelKinematics::setGeometry(const ChassisGeometry& geometry)
+{
+    if (!(geometry.wheelRadius > 0.0f) || !(geometry.trackWidth > 0.0f) || !(geometry.reductionRatio > 0.0f))
+        return false;
+    wheelRadius = geometry.wheelRadius;
+    trackWidth = geometry.trackWidth;
+    reductionRatio = geometry.reductionRatio;
+    wheelCircumference = 2.0f * static_cast<float>(M_PI) * wheelRadius;
+    return true;
+}
+
+ChassisGeometry NormalWheelKinematics::geometry() const
+{
+    ChassisGeometry g;
+    g.wheelRadius = wheelRadius;
+    g.trackWidth = trackWidth;
+    g.reductionRatio = reductionRatio;
+    return g;
+}
+
 void NormalWheelKinematics::calculateSpeedCommands(float vx, float vy, float omega, std::array<uint16_t, 4> &speeds)
 {
     // 计算右侧和左侧轮子对应的旋转速度（单位：RPM）
@@ -33,7 +53,7 @@ void NormalWheelKinematics::calculatePositionCommands(float dx, float dy, float
 {
 
     // 计算每圈对应的脉冲数
-    float pulsesPerRotation = 200.0f * subdivision; // 200 * 细分数 = 每圈脉冲数
+    float pulsesPerRotation = static_cast<float>(fullStepsPerRev) * subdivision; // 整步数 * 细分数 = 每圈脉冲数
 
     // 计算纯前进的脉冲数
     float pulses_forward = (dx / wheelCircumference) * pulsesPerRotation;
@@ -0,0 +1,788 @@
+#include "StepperMotor/MotorBus.h"
+#include <Arduino.h>
+
+namespace {
+
+// 等待事务完成的信号：每个提交事务的任务一个二值信号量（首次提交时创建，任务存续期间复用）。
+// 不使用任务通知：调用者任务自己的通知（如控制任务的命令唤醒）不会被总线等待吞掉，事务完成也不会误唤醒其通知等待
+thread_local SemaphoreHandle_t taskCompletionSignal = nullptr;
+
+SemaphoreHandle_t completionSignal() {
+    if (!taskCompletionSignal) {
+        taskCompletionSignal = xSemaphoreCreateBinary();
+    }
+    return taskCompletionSignal;
+}
+
+} // namespace
+
+MotorBus::MotorBus(HardwareSerial* port)
+    : uart(port), transport(port ? &uart : nullptr)
+{
+    createQueues();
+}
+
+MotorBus::MotorBus(MotorTransport* transport)
+    : uart(nullptr), transport(transport)
+{
+    createQueues();
+}
+
+void MotorBus::createQueues() {
+    // 队列名供调试器与主机仿真的队列深度统计使用（未启用队列注册表时为空操作）
+    static const char* const laneNames[LANE_COUNT] = {"busHigh", "busSetpoint", "busTelemetry", "busDiagnostic"};
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        queues[lane] = xQueueCreate(QUEUE_DEPTH, sizeof(BusTransaction*));
+        vQueueAddToRegistry(queues[lane], laneNames[lane]);
+    }
+    portMutex = xSemaphoreCreateMutex();
+    statsMutex = xSemaphoreCreateMutex();
+}
+
+bool MotorBus::begin(UBaseType_t taskPriority) {
+    if (workerHandle) {
+        return true;
+    }
+    return xTaskCreate(workerTaskWrapper, "motorBusTask", 4096, this, taskPriority, &workerHandle) == pdPASS;
+}
+
+bool MotorBus::submit(BusTransaction& tx) {
+    tx.done.store(false);
+    tx.error = BusError::PENDING;
+    tx.waiter = completionSignal();
+
+    if (!workerHandle) {
+        // 总线任务未启动：在调用者上下文中同步执行
+        xSemaphoreTake(portMutex, portMAX_DELAY);
+        dispatch(tx);
+        xSemaphoreGive(portMutex);
+        return true;
+    }
+
+    QueueHandle_t queue = queues[laneOf(tx)];
+    BusTransaction* ptr = &tx;
+    if (xQueueSend(queue, &ptr, 0) != pdTRUE) {
+        // 突发中的后续事务随队首一同失败
+        failChain(tx, BusError::QUEUE_FULL);
+        return false;
+    }
+    xTaskNotifyGive(workerHandle);
+    return true;
+}
+
+bool MotorBus::preempt(BusTransaction& tx) {
+    tx.done.store(false);
+    tx.error = BusError::PENDING;
+    tx.waiter = completionSignal();
+    tx.priority = BusPriority::HIGH;
+    tx.expectReply = false;
+    tx.maxRetries = 0;
+    tx.burstNext = nullptr;
+
+    if (!workerHandle) {
+        // 总线任务未启动：同步执行路径中没有可抢占的事务
+        xSemaphoreTake(portMutex, portMAX_DELAY);
+        dispatch(tx);
+        xSemaphoreGive(portMutex);
+        return true;
+    }
+
+    BusTransaction* expected = nullptr;
+    if (!urgent.compare_exchange_strong(expected, &tx)) {
+        tx.fail(BusError::QUEUE_FULL);
+        return false;
+    }
+    // 总线任务优先级高于提交者，通知后立即切换到总线任务
+    xTaskNotifyGive(workerHandle);
+    return true;
+}
+
+void MotorBus::failChain(BusTransaction& head, BusError error) {
+    for (BusTransaction* p = &head; p; ) {
+        BusTransaction* next = p->burstNext;
+        p->burstNext = nullptr;
+        complete(*p, error);
+        p = next;
+    }
+}
+
+bool MotorBus::submitBurst(BusTransaction* const* txs, size_t count) {
+    if (count == 0) {
+        return true;
+    }
+    if (count > MAX_BURST) {
+        for (size_t i = 0; i < count; ++i) {
+            txs[i]->waiter = completionSignal();
+            complete(*txs[i], BusError::QUEUE_FULL);
+        }
+        return false;
+    }
+    // 后续事务挂在队首事务上，作为一个队列项提交
+    for (size_t i = 1; i < count; ++i) {
+        txs[i]->done.store(false);
+        txs[i]->error = BusError::PENDING;
+        txs[i]->waiter = completionSignal();
+        txs[i]->burstNext = (i + 1 < count) ? txs[i + 1] : nullptr;
+    }
+    txs[0]->burstNext = (count > 1) ? txs[1] : nullptr;
+    return submit(*txs[0]);
+}
+
+bool MotorBus::submitAll(BusTransaction* const* txs, size_t count) {
+    bool accepted = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (!submit(*txs[i])) {
+            accepted = false;
+        }
+    }
+    return accepted;
+}
+
+BusError MotorBus::wait(BusTransaction& tx) {
+    // 完成时总线任务释放提交者的完成信号；同一任务的多个事务共用信号，循环检查以容忍其它事务的完成
+    SemaphoreHandle_t signal = completionSignal();
+    while (!tx.done.load()) {
+        xSemaphoreTake(signal, pdMS_TO_TICKS(10));
+    }
+    return tx.error;
+}
+
+bool MotorBus::waitAll(BusTransaction* const* txs, size_t count) {
+    bool allOk = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (wait(*txs[i]) != BusError::NONE) {
+            allOk = false;
+        }
+    }
+    return allOk;
+}
+
+BusError MotorBus::execute(BusTransaction& tx) {
+    submit(tx);
+    return wait(tx);
+}
+
+bool MotorBus::changeBitRate(uint32_t rate) {
+    BusTransaction tx;
+    tx.linkRate = rate;
+    tx.priority = BusPriority::HIGH;
+    return execute(tx) == BusError::NONE;
+}
+
+LinkStats MotorBus::linkStats() const {
+    LinkStats stats;
+    stats.txBytes = txBytes.load(std::memory_order_relaxed);
+    stats.rxBytes = rxBytes.load(std::memory_order_relaxed);
+    stats.attempts = replyAttempts.load(std::memory_order_relaxed);
+    stats.timeouts = replyTimeouts.load(std::memory_order_relaxed);
+    stats.checksumErrors = replyChecksumErrors.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MotorBus::setCycleBudget(uint32_t periodUs, uint32_t setpointUs, uint32_t telemetryUs, uint32_t diagnosticUs) {
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    budgetPeriodUs = periodUs;
+    budgetUs[static_cast<size_t>(BusClass::SETPOINT)] = setpointUs;
+    budgetUs[static_cast<size_t>(BusClass::TELEMETRY)] = telemetryUs;
+    budgetUs[static_cast<size_t>(BusClass::DIAGNOSTIC)] = diagnosticUs;
+    budgetChanged.store(true);
+    xSemaphoreGive(statsMutex);
+    if (workerHandle) {
+        xTaskNotifyGive(workerHandle);
+    }
+}
+
+void MotorBus::busStats(BusStatsReport& report, bool reset) {
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    const uint32_t nowMs = millis();
+    report.windowMs = nowMs - statsSinceMs;
+    report.utilisation = report.windowMs
+        ? busyUs.load(std::memory_order_relaxed) / (report.windowMs * 10.0f)
+        : 0.0f;
+    report.droppedRecords = stats.droppedRecords();
+    report.entryCount = stats.size();
+    for (size_t i = 0; i < report.entryCount; ++i) {
+        report.entries[i] = stats.summary(i);
+    }
+    report.schedule.periodUs = budgetPeriodUs;
+    report.schedule.cycles = scheduleCycles;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+        BusSlotUsage& slot = report.schedule.slots[c];
+        slot.plannedUs = budgetUs[c];
+        slot.avgUsedUs = scheduleCycles ? static_cast<uint32_t>(slotUsedUs[c] / scheduleCycles) : 0;
+        slot.maxUsedUs = slotMaxUs[c];
+        slot.transactions = slotTransactions[c];
+        slot.overrunCycles = slotOverruns[c];
+        slot.deferrals = slotDeferrals[c];
+    }
+    if (reset) {
+        stats.reset();
+        busyUs.store(0, std::memory_order_relaxed);
+        statsSinceMs = nowMs;
+        scheduleCycles = 0;
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            slotUsedUs[c] = 0;
+            slotMaxUs[c] = 0;
+            slotTransactions[c] = 0;
+            slotOverruns[c] = 0;
+            slotDeferrals[c] = 0;
+        }
+    }
+    xSemaphoreGive(statsMutex);
+}
+
+void MotorBus::recordStats(const BusTransaction& tx, BusError error) {
+    // 收到应答（含拒绝）或无需应答的事务计入延迟
+    const bool replied = error == BusError::NONE || error == BusError::REJECTED ||
+                         error == BusError::INVALID_COMMAND;
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    stats.record(tx.address(), tx.funcCode(), tx.attempts,
+                 error == BusError::TIMEOUT, error == BusError::CHECKSUM,
+                 error == BusError::REJECTED || error == BusError::INVALID_COMMAND,
+                 replied, tx.latencyUs);
+    xSemaphoreGive(statsMutex);
+}
+
+void MotorBus::recordAttempt(BusError error) {
+    replyAttempts.fetch_add(1, std::memory_order_relaxed);
+    if (error == BusError::TIMEOUT) {
+        replyTimeouts.fetch_add(1, std::memory_order_relaxed);
+    } else if (error == BusError::CHECKSUM) {
+        replyChecksumErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MotorBus::workerTaskWrapper(void* param) {
+    static_cast<MotorBus*>(param)->workerLoop();
+}
+
+void MotorBus::workerLoop() {
+    for (;;) {
+        // 紧急事务先于一切排队事务
+        if (BusTransaction* urgentTx = urgent.exchange(nullptr)) {
+            sendUrgent(*urgentTx);
+            continue;
+        }
+        BusTransaction* tx = nextTransaction();
+        if (!tx) {
+            uint32_t delayUs;
+            if (!nextRetryDelay(delayUs)) {
+                // 队列为空且没有等待重试的事务：阻塞等待新事务提交
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            } else if (delayUs < portTICK_PERIOD_MS * 1000UL) {
+                // 不足一个节拍的退避忙等，期间检查紧急事务
+                const uint32_t startUs = micros();
+                while (micros() - startUs < delayUs && !urgent.load()) {
+                    delayMicroseconds(10);
+                }
+            } else {
+                // 退避期间仍可被新事务唤醒
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(delayUs / 1000));
+            }
+            continue;
+        }
+        // 上一事务完成后立即执行下一事务，不插入任何延时
+        dispatch(*tx);
+    }
+}
+
+void MotorBus::dispatch(BusTransaction& tx) {
+    if (tx.linkRate != 0) {
+        // 链路速率切换：上一事务已收发完毕，直接切换
+        complete(tx, transport && transport->setBitRate(tx.linkRate) ? BusError::NONE : BusError::NO_PORT);
+        return;
+    }
+    // 占用时间包括收发及等待应答，不包括重试退避；事务完成后可能被销毁，先取出类别
+    const size_t cls = static_cast<size_t>(tx.trafficClass());
+    const uint32_t startUs = micros();
+    advanceCycle(startUs);
+    if (tx.burstNext) {
+        processBurst(tx);
+    } else {
+        process(tx);
+    }
+    const uint32_t elapsedUs = micros() - startUs;
+    busyUs.fetch_add(elapsedUs, std::memory_order_relaxed);
+
+    cycleUsedUs[cls] += elapsedUs;
+    ++cycleTransactions[cls];
+    if (cycleBudgetUs[cls] != 0) {
+        creditUs[cls] -= static_cast<int32_t>(elapsedUs);
+    }
+}
+
+void MotorBus::sendUrgent(BusTransaction& tx) {
+    dropSetpoints();
+    dispatch(tx);
+}
+
+void MotorBus::dropSetpoints() {
+    const size_t lanes[] = {0, 1 + static_cast<size_t>(BusClass::SETPOINT)};
+    for (size_t lane : lanes) {
+        // 逐个取出并把其它事务放回队尾，一轮之后恢复原有顺序
+        for (UBaseType_t n = uxQueueMessagesWaiting(queues[lane]); n > 0; --n) {
+            BusTransaction* tx = nullptr;
+            if (xQueueReceive(queues[lane], &tx, 0) != pdTRUE) {
+                break;
+            }
+            if (tx->linkRate == 0 && tx->trafficClass() == BusClass::SETPOINT) {
+                failChain(*tx, BusError::PREEMPTED);
+            } else {
+                xQueueSend(queues[lane], &tx, 0);
+            }
+        }
+    }
+    for (auto& slot : deferred) {
+        if (slot && slot->trafficClass() == BusClass::SETPOINT) {
+            BusTransaction* tx = slot;
+            slot = nullptr;
+            complete(*tx, BusError::PREEMPTED);
+        }
+    }
+}
+
+void MotorBus::yieldTick() {
+    if (inWorker()) {
+        ulTaskNotifyTake(pdTRUE, 1);
+    } else {
+        vTaskDelay(1);
+    }
+}
+
+size_t MotorBus::laneOf(const BusTransaction& tx) {
+    return tx.priority == BusPriority::HIGH ? 0 : 1 + static_cast<size_t>(tx.trafficClass());
+}
+
+BusTransaction* MotorBus::nextTransaction() {
+    const uint32_t now = micros();
+    advanceCycle(now);
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        if (lane > 0 && !hasBudget(lane - 1)) {
+            // 预算耗尽：该类事务留在队列中，顺延到下一周期
+            if (hasWaiting(lane - 1)) {
+                cycleDeferred[lane - 1] = true;
+            }
+            continue;
+        }
+        for (auto& slot : deferred) {
+            if (slot && laneOf(*slot) == lane &&
+                static_cast<int32_t>(now - slot->retryAtUs) >= 0) {
+                BusTransaction* tx = slot;
+                slot = nullptr;
+                return tx;
+            }
+        }
+        BusTransaction* tx = nullptr;
+        if (xQueueReceive(queues[lane], &tx, 0) == pdTRUE) {
+            return tx;
+        }
+    }
+    return nullptr;
+}
+
+bool MotorBus::nextRetryDelay(uint32_t& delayUs) const {
+    const uint32_t now = micros();
+    bool found = false;
+    for (auto slot : deferred) {
+        // 预算已耗尽的类别要等到下一周期，由下面的周期边界处理
+        if (!slot || (laneOf(*slot) > 0 && !hasBudget(laneOf(*slot) - 1))) {
+            continue;
+        }
+        int32_t remaining = static_cast<int32_t>(slot->retryAtUs - now);
+        uint32_t wait = remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+        if (!found || wait < delayUs) {
+            delayUs = wait;
+            found = true;
+        }
+    }
+    for (size_t cls = 0; cls < CLASS_COUNT; ++cls) {
+        if (!hasBudget(cls) && hasWaiting(cls)) {
+            int32_t remaining = static_cast<int32_t>(cycleStartUs + cyclePeriodUs - now);
+            uint32_t wait = remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+            if (!found || wait < delayUs) {
+                delayUs = wait;
+                found = true;
+            }
+            break;
+        }
+    }
+    return found;
+}
+
+bool MotorBus::hasBudget(size_t cls) const {
+    return cyclePeriodUs == 0 || cycleBudgetUs[cls] == 0 || creditUs[cls] > 0;
+}
+
+bool MotorBus::hasWaiting(size_t cls) const {
+    if (uxQueueMessagesWaiting(queues[1 + cls]) > 0) {
+        return true;
+    }
+    for (auto slot : deferred) {
+        if (slot && laneOf(*slot) == 1 + cls) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MotorBus::advanceCycle(uint32_t nowUs) {
+    const uint32_t elapsedUs = nowUs - cycleStartUs;
+    const bool changed = budgetChanged.load();
+    if (!changed && (cyclePeriodUs == 0 || elapsedUs < cyclePeriodUs)) {
+        return;
+    }
+
+    // 空闲时可能一次跨过多个周期：只有紧接着的下一周期承接透支
+    const uint32_t cycles = cyclePeriodUs ? elapsedUs / cyclePeriodUs : 0;
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    if (cyclePeriodUs != 0) {
+        scheduleCycles += cycles > 0 ? cycles : 1;
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            slotUsedUs[c] += cycleUsedUs[c];
+            if (cycleUsedUs[c] > slotMaxUs[c]) {
+                slotMaxUs[c] = cycleUsedUs[c];
+            }
+            slotTransactions[c] += cycleTransactions[c];
+            if (cycleBudgetUs[c] != 0 && cycleUsedUs[c] > cycleBudgetUs[c]) {
+                ++slotOverruns[c];
+            }
+            if (cycleDeferred[c]) {
+                ++slotDeferrals[c];
+            }
+        }
+    }
+    if (changed) {
+        budgetChanged.store(false);
+        cyclePeriodUs = budgetPeriodUs;
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            cycleBudgetUs[c] = budgetUs[c];
+        }
+    }
+    xSemaphoreGive(statsMutex);
+
+    const bool contiguous = !changed && cycles == 1;
+    // 连续运行时保持周期相位，空闲之后或配置变更时从当前时刻重新开始
+    cycleStartUs = contiguous ? cycleStartUs + cyclePeriodUs : nowUs;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+        const int32_t debt = (contiguous && creditUs[c] < 0) ? creditUs[c] : 0;
+        creditUs[c] = static_cast<int32_t>(cycleBudgetUs[c]) + debt;
+        cycleUsedUs[c] = 0;
+        cycleTransactions[c] = 0;
+        cycleDeferred[c] = false;
+    }
+}
+
+void MotorBus::process(BusTransaction& tx) {
+    for (;;) {
+        BusError error = attempt(tx);
+        if (tx.expectReply && error != BusError::WRITE_FAILED && error != BusError::NO_PORT &&
+            error != BusError::PREEMPTED) {
+            recordAttempt(error);
+        }
+        if (error == BusError::NONE || !scheduleRetry(tx, error)) {
+            complete(tx, error);
+            return;
+        }
+        if (inWorker()) {
+            // 总线任务中：事务已转入退避列表，先执行其它事务
+            return;
+        }
+        // 总线任务未启动：在调用者上下文中等待退避结束
+        int32_t remaining = static_cast<int32_t>(tx.retryAtUs - micros());
+        if (remaining > 0) {
+            delayMicroseconds(static_cast<uint32_t>(remaining));
+        }
+    }
+}
+
+BusError MotorBus::attempt(BusTransaction& tx) {
+    if (!transport || tx.request.length < 3) {
+        return BusError::NO_PORT;
+    }
+
+    Emm42::ResponseParser parser;
+    parser.begin(tx.address(), tx.funcCode(), tx.checksumType);
+    tx.response.clear();
+
+    const uint32_t startUs = micros();
+    if (tx.attempts++ == 0) {
+        tx.firstSendUs = startUs;
+    }
+    const Emm42::ByteSpan frame = tx.request.span();
+    if (!transport->writeFrames(&frame, 1)) {
+        return BusError::WRITE_FAILED;
+    }
+    txBytes.fetch_add(frame.size, std::memory_order_relaxed);
+
+    if (!tx.expectReply) {
+        tx.latencyUs = micros() - tx.firstSendUs;
+        return BusError::NONE;
+    }
+
+    // 期限自发送完成起计时
+    const uint32_t sentUs = micros();
+    const uint32_t windowUs = replyWindowUs(tx);
+    for (;;) {
+        while (transport->available() > 0) {
+            int byteRead = transport->read();
+            if (byteRead < 0) {
+                break;
+            }
+            rxBytes.fetch_add(1, std::memory_order_relaxed);
+            if (parser.feed(static_cast<uint8_t>(byteRead)) == Emm42::ResponseParser::Status::COMPLETE) {
+                tx.response = parser.frame();
+                tx.latencyUs = micros() - tx.firstSendUs;
+                return classify(parser, tx.funcCode());
+            }
+        }
+
+        uint32_t elapsedUs = micros() - sentUs;
+        if (elapsedUs >= windowUs) {
+            break;
+        }
+        if (urgent.load()) {
+            // 命令帧已完整发出，放弃等待应答，让紧急事务立即使用总线
+            tx.response = parser.frame();
+            tx.latencyUs = micros() - tx.firstSendUs;
+            return BusError::PREEMPTED;
+        }
+        // 应答通常在数百微秒内到达：先短暂忙等，超过窗口后再让出 CPU
+        if (elapsedUs < REPLY_SPIN_US) {
+            delayMicroseconds(10);
+        } else {
+            yieldTick();
+        }
+    }
+
+    // 超时：保留已收到的部分数据，便于上层诊断
+    tx.response = parser.frame();
+    tx.latencyUs = micros() - tx.firstSendUs;
+    return parser.checksumErrors() > 0 ? BusError::CHECKSUM : BusError::TIMEOUT;
+}
+
+bool MotorBus::scheduleRetry(BusTransaction& tx, BusError error) {
+    if (!isRetryable(error) || tx.attempts > tx.maxRetries) {
+        return false;
+    }
+    uint32_t backoffUs = BACKOFF_BASE_US << (tx.attempts - 1);
+    if (backoffUs > BACKOFF_MAX_US) {
+        backoffUs = BACKOFF_MAX_US;
+    }
+    const uint32_t now = micros();
+    // 预算不足以再完成一次尝试时直接以本次错误结束
+    if (tx.budgetUs != 0 &&
+        (now - tx.firstSendUs) + backoffUs + replyWindowUs(tx) > tx.budgetUs) {
+        return false;
+    }
+    tx.retryAtUs = now + backoffUs;
+
+    if (!inWorker()) {
+        return true;    // 同步执行路径由调用者等待退避
+    }
+    for (auto& slot : deferred) {
+        if (!slot) {
+            slot = &tx;
+            return true;
+        }
+    }
+    return false;       // 退避列表已满：放弃重试
+}
+
+uint32_t MotorBus::replyWireUs(const BusTransaction& tx) const {
+    return replyWireUs(tx.funcCode());
+}
+
+uint32_t MotorBus::replyWireUs(uint8_t funcCode) const {
+    uint32_t replyBytes = Emm42::responseLength(funcCode);
+    if (replyBytes == 0) {
+        replyBytes = Emm42::MAX_FRAME_LEN;
+    }
+    return transport ? transport->replyWireUs(replyBytes) : 0;
+}
+
+uint32_t MotorBus::replyWindowUs(const BusTransaction& tx) const {
+    return tx.deadlineUs + replyWireUs(tx);
+}
+
+// 首次尝试超时（一个应答窗口）+ 首次退避 + 重发的应答窗口，与 scheduleRetry() 的预算检查一致；
+// 超过忙等窗口后按节拍让出 CPU，超时判定可能晚于窗口近一个节拍，留两个节拍的余量
+uint32_t MotorBus::retryBudgetUs(uint8_t funcCode, uint32_t deadlineUs) const {
+    return 2 * (deadlineUs + replyWireUs(funcCode)) + BACKOFF_BASE_US + 2 * portTICK_PERIOD_MS * 1000;
+}
+
+BusError MotorBus::classify(const Emm42::ResponseParser& parser, uint8_t funcCode) {
+    if (parser.isErrorReply()) {
+        return BusError::INVALID_COMMAND;
+    }
+    const Emm42::Frame& frame = parser.frame();
+    if (Emm42::isAckFunction(funcCode) && frame.length >= 3 && frame.bytes[2] == Emm42::REPLY_CONDITION) {
+        return BusError::REJECTED;
+    }
+    return BusError::NONE;
+}
+
+const char* busClassName(BusClass cls) {
+    switch (cls) {
+        case BusClass::SETPOINT:   return "setpoint";
+        case BusClass::TELEMETRY:  return "telemetry";
+        case BusClass::DIAGNOSTIC: return "diagnostic";
+        case BusClass::COUNT:      break;
+    }
+    return "unknown";
+}
+
+const char* busErrorName(BusError error) {
+    switch (error) {
+        case BusError::NONE:            return "NONE";
+        case BusError::PENDING:         return "PENDING";
+        case BusError::TIMEOUT:         return "TIMEOUT";
+        case BusError::CHECKSUM:        return "CHECKSUM";
+        case BusError::REJECTED:        return "REJECTED";
+        case BusError::INVALID_COMMAND: return "INVALID_COMMAND";
+        case BusError::WRITE_FAILED:    return "WRITE_FAILED";
+        case BusError::QUEUE_FULL:      return "QUEUE_FULL";
+        case BusError::NO_PORT:         return "NO_PORT";
+        case BusError::CIRCUIT_OPEN:    return "CIRCUIT_OPEN";
+        case BusError::PREEMPTED:       return "PREEMPTED";
+        case BusError::BAD_REPLY:       return "BAD_REPLY";
+    }
+    return "UNKNOWN";
+}
+
+void MotorBus::complete(BusTransaction& tx, BusError error) {
+    tx.error = error;
+    // 只统计实际发送过的事务（排除队列已满、速率切换等）
+    if (tx.attempts > 0) {
+        recordStats(tx, error);
+    }
+    if (tx.onComplete) {
+        tx.onComplete(tx, tx.context);
+    }
+    // 置位 done 之后事务对象可能立即被等待者销毁，需提前取出等待者的完成信号
+    SemaphoreHandle_t waiter = tx.waiter;
+    tx.done.store(true);
+    if (waiter && waiter != taskCompletionSignal) {
+        xSemaphoreGive(waiter);
+    }
+}
+
+void MotorBus::processBurst(BusTransaction& head) {
+    // 展开突发链表；完成回调之后事务可能被销毁，此后只通过本地数组访问
+    BusTransaction* members[MAX_BURST];
+    size_t count = 0;
+    for (BusTransaction* p = &head; p && count < MAX_BURST; ) {
+        BusTransaction* next = p->burstNext;
+        p->burstNext = nullptr;
+        members[count++] = p;
+        p = next;
+    }
+
+    if (!transport) {
+        for (size_t i = 0; i < count; ++i) {
+            complete(*members[i], BusError::NO_PORT);
+        }
+        return;
+    }
+
+    // 全部命令帧交给传输层一次写出
+    Emm42::ByteSpan frames[MAX_BURST];
+    Emm42::ResponseParser parsers[MAX_BURST];
+    bool pending[MAX_BURST];
+    uint32_t windows[MAX_BURST];
+    uint32_t wireUs = 0;
+    size_t pendingCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        BusTransaction& tx = *members[i];
+        frames[i] = tx.request.span();
+        tx.response.clear();
+        parsers[i].begin(tx.address(), tx.funcCode(), tx.checksumType);
+        pending[i] = tx.expectReply;
+        if (pending[i]) {
+            // 应答期限自整次写入完成起计时，需计入排在前面的应答的传输时间
+            wireUs += replyWireUs(tx);
+            windows[i] = tx.deadlineUs + wireUs;
+            ++pendingCount;
+        }
+    }
+
+    uint32_t length = 0;
+    for (size_t i = 0; i < count; ++i) {
+        length += frames[i].size;
+    }
+    const uint32_t startUs = micros();
+    for (size_t i = 0; i < count; ++i) {
+        members[i]->attempts = 1;
+        members[i]->firstSendUs = startUs;
+    }
+    if (!transport->writeFrames(frames, count)) {
+        for (size_t i = 0; i < count; ++i) {
+            complete(*members[i], BusError::WRITE_FAILED);
+        }
+        return;
+    }
+    txBytes.fetch_add(length, std::memory_order_relaxed);
+    const uint32_t sentUs = micros();
+    for (size_t i = 0; i < count; ++i) {
+        if (!pending[i]) {
+            members[i]->latencyUs = sentUs - startUs;
+            complete(*members[i], BusError::NONE);
+        }
+    }
+
+    // 每个字节交给所有未完成的解析器，各解析器只认领与自身地址/功能码匹配的应答
+    while (pendingCount > 0) {
+        while (pendingCount > 0 && transport->available() > 0) {
+            int byteRead = transport->read();
+            if (byteRead < 0) {
+                break;
+            }
+            rxBytes.fetch_add(1, std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i) {
+                if (pending[i] &&
+                    parsers[i].feed(static_cast<uint8_t>(byteRead)) == Emm42::ResponseParser::Status::COMPLETE) {
+                    pending[i] = false;
+                    --pendingCount;
+                    members[i]->response = parsers[i].frame();
+                    members[i]->latencyUs = micros() - startUs;
+                    BusError result = classify(parsers[i], members[i]->funcCode());
+                    recordAttempt(result);
+                    complete(*members[i], result);
+                }
+            }
+        }
+
+        // 突发中的事务不重试：命令已随同步触发帧一并发出，应答丢失不代表命令丢失
+        uint32_t elapsedUs = micros() - sentUs;
+        for (size_t i = 0; i < count; ++i) {
+            if (pending[i] && elapsedUs >= windows[i]) {
+                pending[i] = false;
+                --pendingCount;
+                members[i]->response = parsers[i].frame();
+                members[i]->latencyUs = micros() - startUs;
+                BusError result = parsers[i].checksumErrors() > 0 ? BusError::CHECKSUM : BusError::TIMEOUT;
+                recordAttempt(result);
+                complete(*members[i], result);
+            }
+        }
+        if (pendingCount == 0) {
+            break;
+        }
+        if (urgent.load()) {
+            // 全部命令帧已发出，放弃其余应答
+            for (size_t i = 0; i < count; ++i) {
+                if (pending[i]) {
+                    pending[i] = false;
+                    members[i]->response = parsers[i].frame();
+                    members[i]->latencyUs = micros() - startUs;
+                    complete(*members[i], BusError::PREEMPTED);
+                }
+            }
+            break;
+        }
+        if (elapsedUs < REPLY_SPIN_US) {
+            delayMicroseconds(10);
+        } else {
+            yieldTick();
+        }
+    }
+}
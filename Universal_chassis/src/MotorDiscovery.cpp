@@ -0,0 +1,121 @@
+#include "StepperMotor/MotorDiscovery.h"
+#include <Arduino.h>
+#include <memory>
+
+namespace {
+
+// 每条总线一次提交的探测事务数（不超过总线队列深度）
+constexpr size_t CHUNK = 8;
+
+} // namespace
+
+MotorDiscovery::MotorDiscovery(MotorBus* const* buses, size_t count) {
+    for (size_t i = 0; i < count && busCount < MAX_BUSES; ++i) {
+        if (buses[i]) {
+            this->buses[busCount++] = buses[i];
+        }
+    }
+}
+
+void MotorDiscovery::setAddressRange(uint8_t first, uint8_t last) {
+    firstAddr = first == 0 ? 1 : first;
+    lastAddr = last < firstAddr ? firstAddr : last;
+}
+
+bool MotorDiscovery::run(MotorTable& table) {
+    const uint32_t startUs = micros();
+    table = MotorTable();
+
+    // 1. 以默认的 0x6B 固定校验探测全部地址
+    probe(table, ChecksumType::FIXED, true);
+    // 2. 未应答的地址再以 XOR、CRC8 校验各试一次
+    probe(table, ChecksumType::XOR, false);
+    probe(table, ChecksumType::CRC8, false);
+    // 3. 读取已发现驱动器的配置参数
+    readConfigs(table);
+
+    table.elapsedUs = micros() - startUs;
+    return table.count > 0 && table.conflicts == 0;
+}
+
+bool MotorDiscovery::known(const MotorTable& table, uint8_t address, uint8_t bus) {
+    return table.find(address, bus) != nullptr;
+}
+
+void MotorDiscovery::probe(MotorTable& table, ChecksumType type, bool countConflicts) {
+    // 事务对象较大，放在堆上以免占用调用任务的栈
+    std::unique_ptr<BusTransaction[]> txs(new BusTransaction[MAX_BUSES * CHUNK]);
+    uint8_t addrs[MAX_BUSES][CHUNK];
+    size_t counts[MAX_BUSES];
+
+    uint8_t next[MAX_BUSES];
+    for (size_t b = 0; b < busCount; ++b) {
+        next[b] = firstAddr;
+    }
+
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        // 各总线提交一批待探测地址，之后统一等待，总线之间并行执行
+        for (size_t b = 0; b < busCount; ++b) {
+            counts[b] = 0;
+            while (counts[b] < CHUNK && next[b] != 0 && next[b] <= lastAddr) {
+                const uint8_t addr = next[b];
+                next[b] = addr == 0xFF ? 0 : addr + 1;
+                if (known(table, addr, static_cast<uint8_t>(b))) {
+                    continue;
+                }
+                BusTransaction& tx = txs[b * CHUNK + counts[b]];
+                StepperMotor(addr, buses[b], type).prepareReadFirmwareVersion(tx);
+                tx.deadlineUs = probeDeadlineUs;
+                tx.maxRetries = 0;
+                tx.budgetUs = 0;
+                tx.priority = BusPriority::LOW;
+                buses[b]->submit(tx);
+                addrs[b][counts[b]++] = addr;
+            }
+        }
+
+        for (size_t b = 0; b < busCount; ++b) {
+            for (size_t i = 0; i < counts[b]; ++i) {
+                pending = true;
+                BusTransaction& tx = txs[b * CHUNK + i];
+                buses[b]->wait(tx);
+
+                MotorProfile profile;
+                if (StepperMotor(addrs[b][i], buses[b], type)
+                        .parseFirmwareVersion(tx, profile.firmwareVersion, profile.hardwareVersion)) {
+                    if (table.count < MotorTable::MAX_MOTORS) {
+                        profile.address = addrs[b][i];
+                        profile.bus = static_cast<uint8_t>(b);
+                        profile.checksumType = type;
+                        table.motors[table.count++] = profile;
+                    }
+                } else if (countConflicts && tx.error == BusError::CHECKSUM) {
+                    ++table.conflicts;
+                }
+            }
+        }
+    }
+}
+
+void MotorDiscovery::readConfigs(MotorTable& table) {
+    std::unique_ptr<BusTransaction[]> txs(new BusTransaction[MotorTable::MAX_MOTORS]);
+
+    for (size_t i = 0; i < table.count; ++i) {
+        const MotorProfile& profile = table.motors[i];
+        StepperMotor(profile.address, buses[profile.bus], profile.checksumType).prepareReadDriverConfig(txs[i]);
+        txs[i].deadlineUs = probeDeadlineUs;
+        txs[i].maxRetries = 1;
+        txs[i].budgetUs = 0;
+        txs[i].priority = BusPriority::LOW;
+        buses[profile.bus]->submit(txs[i]);
+    }
+
+    for (size_t i = 0; i < table.count; ++i) {
+        MotorProfile& profile = table.motors[i];
+        buses[profile.bus]->wait(txs[i]);
+        profile.configValid = StepperMotor(profile.address, buses[profile.bus], profile.checksumType)
+                                  .parseDriverConfig(txs[i], profile.config);
+    }
+}
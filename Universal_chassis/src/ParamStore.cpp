@@ -0,0 +1,215 @@
+#include "ParamStore/ParamStore.h"
+#include <Preferences.h>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+
+// NVS 中参数块的键名
+constexpr const char* BLOCK_KEY = "params";
+
+// 可按名称访问的参数：名称 + 在参数块中的偏移（均为 float）
+struct ParamEntry {
+    const char* name;
+    size_t offset;
+    bool positive;      // 须为正数
+};
+
+constexpr ParamEntry PARAMS[] = {
+    {"wheel_radius",         offsetof(ParamBlock, wheelRadius),         true},
+    {"wheel_base",           offsetof(ParamBlock, wheelBase),           false},
+    {"track_width",          offsetof(ParamBlock, trackWidth),          true},
+    {"reduction_ratio",      offsetof(ParamBlock, reductionRatio),      true},
+    {"default_acceleration", offsetof(ParamBlock, defaultAcceleration), false},
+    {"default_subdivision",  offsetof(ParamBlock, defaultSubdivision),  true},
+    {"default_speed",        offsetof(ParamBlock, defaultSpeed),        false},
+};
+
+constexpr size_t PARAM_COUNT = sizeof(PARAMS) / sizeof(PARAMS[0]);
+
+const ParamEntry* findParam(const char* name) {
+    if (!name) {
+        return nullptr;
+    }
+    for (const auto& entry : PARAMS) {
+        if (strcmp(entry.name, name) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+ParamStore::ParamStore(const char* nvsNamespace)
+    : nvsNamespace(nvsNamespace)
+{
+    memset(&block, 0, sizeof(block));
+    mutex = xSemaphoreCreateMutex();
+}
+
+bool ParamStore::begin(const ChassisGeometry& geometry, const CarControllerConfig& config) {
+    ParamBlock loaded;
+    bool valid = false;
+    Preferences prefs;
+    if (prefs.begin(nvsNamespace, true)) {
+        valid = prefs.getBytesLength(BLOCK_KEY) == sizeof(ParamBlock) &&
+                prefs.getBytes(BLOCK_KEY, &loaded, sizeof(loaded)) == sizeof(loaded) &&
+                loaded.magic == ParamBlock::MAGIC && loaded.version == ParamBlock::VERSION &&
+                loaded.size == sizeof(ParamBlock) && loaded.crc == blockCrc(loaded);
+        prefs.end();
+    }
+
+    if (!valid) {
+        // 版本不符或损坏：使用默认值，驱动器表缓存为空
+        memset(&loaded, 0, sizeof(loaded));
+        loaded.magic = ParamBlock::MAGIC;
+        loaded.version = ParamBlock::VERSION;
+        loaded.size = sizeof(ParamBlock);
+        loaded.wheelRadius = geometry.wheelRadius;
+        loaded.wheelBase = geometry.wheelBase;
+        loaded.trackWidth = geometry.trackWidth;
+        loaded.reductionRatio = geometry.reductionRatio;
+        loaded.defaultAcceleration = config.defaultAcceleration;
+        loaded.defaultSubdivision = config.defaultSubdivision;
+        loaded.defaultSpeed = config.defaultSpeed;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    block = loaded;
+    xSemaphoreGive(mutex);
+    return valid;
+}
+
+bool ParamStore::save() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    block.crc = blockCrc(block);
+    ParamBlock copy = block;
+    xSemaphoreGive(mutex);
+
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) {
+        return false;
+    }
+    bool ok = prefs.putBytes(BLOCK_KEY, &copy, sizeof(copy)) == sizeof(copy);
+    prefs.end();
+    return ok;
+}
+
+ChassisGeometry ParamStore::geometry() const {
+    ChassisGeometry g;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    g.wheelRadius = block.wheelRadius;
+    g.wheelBase = block.wheelBase;
+    g.trackWidth = block.trackWidth;
+    g.reductionRatio = block.reductionRatio;
+    xSemaphoreGive(mutex);
+    return g;
+}
+
+CarControllerConfig ParamStore::controlConfig() const {
+    CarControllerConfig c;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    c.defaultAcceleration = block.defaultAcceleration;
+    c.defaultSubdivision = block.defaultSubdivision;
+    c.defaultSpeed = block.defaultSpeed;
+    xSemaphoreGive(mutex);
+    return c;
+}
+
+bool ParamStore::set(const char* name, float value) {
+    const ParamEntry* entry = findParam(name);
+    if (!entry || !std::isfinite(value) || value < 0.0f || (entry->positive && value == 0.0f)) {
+        return false;
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    memcpy(reinterpret_cast<uint8_t*>(&block) + entry->offset, &value, sizeof(value));
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool ParamStore::get(const char* name, float& value) const {
+    const ParamEntry* entry = findParam(name);
+    if (!entry) {
+        return false;
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    memcpy(&value, reinterpret_cast<const uint8_t*>(&block) + entry->offset, sizeof(value));
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+size_t ParamStore::paramCount() {
+    return PARAM_COUNT;
+}
+
+const char* ParamStore::paramName(size_t index) {
+    return index < PARAM_COUNT ? PARAMS[index].name : nullptr;
+}
+
+bool ParamStore::loadMotorTable(MotorTable& table) const {
+    table = MotorTable();
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (size_t i = 0; i < block.motorCount && i < MotorTable::MAX_MOTORS; ++i) {
+        const CachedMotor& cached = block.motors[i];
+        MotorProfile& profile = table.motors[table.count++];
+        profile.address = cached.address;
+        profile.bus = cached.bus;
+        profile.checksumType = static_cast<ChecksumType>(cached.checksumType);
+        profile.firmwareVersion = cached.firmwareVersion;
+        profile.hardwareVersion = cached.hardwareVersion;
+        profile.configValid = true;
+        profile.config.motorType = cached.motorType;
+        profile.config.cmdResponse = static_cast<CommandResponse>(cached.cmdResponse);
+        profile.config.subdivision = cached.subdivision;
+    }
+    xSemaphoreGive(mutex);
+    return table.count > 0;
+}
+
+void ParamStore::storeMotorTable(const MotorTable& table) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    block.motorCount = 0;
+    memset(block.motors, 0, sizeof(block.motors));
+    for (size_t i = 0; i < table.count; ++i) {
+        const MotorProfile& profile = table.motors[i];
+        if (!profile.configValid) {
+            continue;
+        }
+        CachedMotor& cached = block.motors[block.motorCount++];
+        cached.address = profile.address;
+        cached.bus = profile.bus;
+        cached.checksumType = static_cast<uint8_t>(profile.checksumType);
+        cached.firmwareVersion = profile.firmwareVersion;
+        cached.hardwareVersion = profile.hardwareVersion;
+        cached.motorType = profile.config.motorType;
+        cached.cmdResponse = static_cast<uint8_t>(profile.config.cmdResponse);
+        cached.subdivision = profile.config.subdivision;
+    }
+    xSemaphoreGive(mutex);
+}
+
+void ParamStore::clearMotorTable() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    block.motorCount = 0;
+    memset(block.motors, 0, sizeof(block.motors));
+    xSemaphoreGive(mutex);
+}
+
+// CRC-32（IEEE 802.3，反射多项式 0xEDB88320），逐位计算，参数块只在启动与保存时校验
+uint32_t ParamStore::crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t ParamStore::blockCrc(const ParamBlock& block) {
+    const size_t header = offsetof(ParamBlock, crc) + sizeof(block.crc);
+    return crc32(reinterpret_cast<const uint8_t*>(&block) + header, sizeof(ParamBlock) - header);
+}
@@ -1,101 +1,312 @@
 #include "StepperMotor/StepperMotor.h"
 #include <Arduino.h>  // 提供 millis() 和 delay() 等函数
+#include <cstdlib>
+
+namespace {
+
+// 驱动配置参数区长度（0x42 应答与 0x48 修改命令中的 21 个参数）
+constexpr size_t DRIVER_CONFIG_PARAM_BYTES = 28;
+
+// 串口波特率选项（协议中以序号表示）
+constexpr uint32_t BAUD_RATES[] = {9600, 19200, 25000, 38400, 57600, 115200, 256000, 512000, 921600};
+// CAN 通讯速率选项（协议中以序号表示）
+constexpr uint32_t CAN_RATES[] = {10000, 20000, 50000, 83333, 100000, 125000, 250000, 500000, 800000, 1000000};
+
+template <size_t N>
+uint32_t rateFromCode(const uint32_t (&table)[N], uint8_t code) {
+    return code < N ? table[code] : 0;
+}
+
+// 找不到完全匹配时取最接近的选项
+template <size_t N>
+uint8_t codeFromRate(const uint32_t (&table)[N], uint32_t rate) {
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < N; ++i) {
+        uint32_t diff = rate > table[i] ? rate - table[i] : table[i] - rate;
+        uint32_t bestDiff = rate > table[best] ? rate - table[best] : table[best] - rate;
+        if (diff < bestDiff) best = i;
+    }
+    return best;
+}
+
+// 解析 21 个驱动配置参数（p 指向电机类型字节）
+void decodeDriverConfig(const uint8_t* p, DriverConfig& config) {
+    config.motorType = p[0];
+    config.pulseControlMode = p[1];
+    config.commPortMode = p[2];
+    config.enPinEffectiveLevel = p[3];
+    config.dirPinEffectiveDirection = p[4];
+    config.subdivision = p[5] == 0 ? 256 : p[5];
+    config.subdivisionInterpolation = (p[6] != 0);
+    config.autoSleep = (p[7] != 0);
+    config.openLoopCurrent = Emm42::readU16(&p[8]);
+    config.closedLoopMaxCurrent = Emm42::readU16(&p[10]);
+    config.maxOutputVoltage = Emm42::readU16(&p[12]);
+    config.serialBaudRate = rateFromCode(BAUD_RATES, p[14]);
+    config.canCommRate = rateFromCode(CAN_RATES, p[15]);
+    config.id = p[16];
+    config.commChecksum = p[17];
+    config.cmdResponse = static_cast<CommandResponse>(p[18]);
+    config.stallProtectionEnabled = (p[19] != 0);
+    config.stallThresholdSpeed = Emm42::readU16(&p[20]);
+    config.stallThresholdCurrent = Emm42::readU16(&p[22]);
+    config.stallDetectionTime = Emm42::readU16(&p[24]);
+    config.positionArrivalWindow = Emm42::readU16(&p[26]) * 0.1f;   // 单位 0.1°
+}
+
+// 按协议排列 21 个驱动配置参数，与 decodeDriverConfig 互逆
+void encodeDriverConfig(const DriverConfig& config, uint8_t* p) {
+    auto putU16 = [](uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value >> 8);
+        out[1] = static_cast<uint8_t>(value & 0xFF);
+    };
+    p[0] = config.motorType;
+    p[1] = config.pulseControlMode;
+    p[2] = config.commPortMode;
+    p[3] = config.enPinEffectiveLevel;
+    p[4] = config.dirPinEffectiveDirection;
+    p[5] = config.subdivision >= 256 ? 0 : static_cast<uint8_t>(config.subdivision);
+    p[6] = config.subdivisionInterpolation ? 0x01 : 0x00;
+    p[7] = config.autoSleep ? 0x01 : 0x00;
+    putU16(&p[8], config.openLoopCurrent);
+    putU16(&p[10], config.closedLoopMaxCurrent);
+    putU16(&p[12], config.maxOutputVoltage);
+    p[14] = codeFromRate(BAUD_RATES, config.serialBaudRate);
+    p[15] = codeFromRate(CAN_RATES, config.canCommRate);
+    p[16] = config.id;
+    p[17] = config.commChecksum;
+    p[18] = static_cast<uint8_t>(config.cmdResponse);
+    p[19] = config.stallProtectionEnabled ? 0x01 : 0x00;
+    putU16(&p[20], config.stallThresholdSpeed);
+    putU16(&p[22], config.stallThresholdCurrent);
+    putU16(&p[24], config.stallDetectionTime);
+    putU16(&p[26], static_cast<uint16_t>(config.positionArrivalWindow * 10.0f + 0.5f));
+}
+
+// 免应答速度设定值验证参数
+constexpr int16_t SETPOINT_TOLERANCE_RPM = 3;   // 转速容差
+constexpr uint32_t SETPOINT_BASE_GRACE_MS = 60; // 基础宽限时间（覆盖遥测周期与指令处理延迟）
+
+} // namespace
 
 // 构造函数实现
-StepperMotor::StepperMotor(uint8_t motorAddr, HardwareSerial* serial, ChecksumType checksumType, uint32_t timeout_ms)
-    : motorAddr(motorAddr), port(serial), timeout_ms(timeout_ms), checksumType(checksumType)
+StepperMotor::StepperMotor(uint8_t motorAddr, MotorBus* bus, ChecksumType checksumType, uint32_t timeout_ms)
+    : motorAddr(motorAddr), motorBus(bus), timeout_ms(timeout_ms), checksumType(checksumType)
 {
-    // 如果需要，可在此进行串口初始化配置（例如设置波特率）
-    // 本示例不做额外配置，按上层传入的 HardwareSerial 对象进行操作
+    // 串口由 MotorBus 独占，本类只负责组帧与解析
 }
 
-// 私有方法：计算校验字节
-uint8_t StepperMotor::calculateChecksum(const std::vector<uint8_t>& data) {
-    switch (checksumType) {
-        case ChecksumType::FIXED:
-            return 0x6B;
-        case ChecksumType::XOR: {
-            uint8_t checksum = 0;
-            for (auto byte : data) {
-                checksum ^= byte;
-            }
-            return checksum;
-        }
-        case ChecksumType::CRC8: {
-            // 使用 CRC-8 算法，采用多项式 0x07，初始值为 0
-            uint8_t crc = 0;
-            for (auto byte : data) {
-                crc ^= byte;
-                for (int i = 0; i < 8; ++i) {
-                    if (crc & 0x80) {
-                        crc = (crc << 1) ^ 0x07;
-                    } else {
-                        crc <<= 1;
-                    }
-                }
+// 初始化一次事务：填入命令帧、校验方式与超时
+void StepperMotor::prepare(BusTransaction& tx, Emm42::ByteSpan request) const {
+    uint8_t funcCode = request.size > 1 ? request.data[1] : 0;
+    tx.prepare(request, checksumType, deadlineFor(funcCode), retryLimit);
+    tx.budgetUs = callBudgetUs;
+}
+
+// 构造控制命令事务：免应答模式下驱动器不回复控制命令，发送完成即结束；
+// 总线上没有地址 1 的驱动器时广播命令无人应答，同样不等待
+void StepperMotor::prepareControl(BusTransaction& tx, Emm42::ByteSpan request) const {
+    prepare(tx, request);
+    tx.expectReply = !unacknowledged && (motorAddr != 0 || broadcastReplies);
+}
+
+// 单次尝试的应答期限：构造时指定了 timeout_ms 则统一使用，否则按功能码
+uint32_t StepperMotor::deadlineFor(uint8_t funcCode) const {
+    return timeout_ms ? timeout_ms * 1000UL : Emm42::replyDeadlineUs(funcCode);
+}
+
+// 至少容纳一次重发的调用预算
+uint32_t StepperMotor::retryBudgetUs(uint8_t funcCode) const {
+    return motorBus ? motorBus->retryBudgetUs(funcCode, deadlineFor(funcCode)) : 0;
+}
+
+// 阻塞执行事务并返回结果
+BusError StepperMotor::run(BusTransaction& tx) {
+    if (!admit(tx)) {
+        return tx.error;
+    }
+    BusError error = motorBus->execute(tx);
+    recordOutcome(tx);
+    return error;
+}
+
+/*************************************************** 熔断器 *************************************/
+const char* motorHealthName(MotorHealth health) {
+    switch (health) {
+        case MotorHealth::HEALTHY:  return "HEALTHY";
+        case MotorHealth::DEGRADED: return "DEGRADED";
+        case MotorHealth::OPEN:     return "OPEN";
+    }
+    return "UNKNOWN";
+}
+
+void StepperMotor::configureBreaker(uint8_t tripThreshold, uint32_t probeIntervalMs) {
+    breakerTripThreshold = tripThreshold > 0 ? tripThreshold : 1;
+    breakerProbeIntervalMs = probeIntervalMs;
+}
+
+// 标记为不在线：直接熔断，按探测间隔尝试恢复
+void StepperMotor::markAbsent() {
+    if (motorAddr == 0) {
+        return;
+    }
+    consecutiveFailures = breakerTripThreshold;
+    healthState = MotorHealth::OPEN;
+    lastProbeMs = millis();
+}
+
+// 熔断器准入检查
+bool StepperMotor::admit(BusTransaction& tx) {
+    if (motorAddr == 0) {
+        return true;    // 广播命令由所有电机接收，不因某一应答者失效而停止
+    }
+    switch (healthState) {
+        case MotorHealth::HEALTHY:
+            return true;
+        case MotorHealth::DEGRADED:
+            tx.maxRetries = 0;
+            return true;
+        case MotorHealth::OPEN: {
+            uint32_t now = millis();
+            if (now - lastProbeMs >= breakerProbeIntervalMs) {
+                // 以本次事务作为探测，成功即恢复
+                lastProbeMs = now;
+                tx.maxRetries = 0;
+                return true;
             }
-            return crc;
+            tx.fail(BusError::CIRCUIT_OPEN);
+            return false;
         }
-        default:
-            return 0x6B;
     }
+    return true;
 }
 
-// 私有方法：发送命令并接收回复
-bool StepperMotor::sendCommand(const std::vector<uint8_t>& command, std::vector<uint8_t>& response) {
-    if (!port) {
+bool StepperMotor::submit(BusTransaction& tx) {
+    if (!motorBus) {
+        tx.fail(BusError::NO_PORT);
         return false;
     }
-    
-    response.clear();
-    
-    // 清空接收缓冲区中的数据
-    while (port->available()) {
-        port->read();
-    }
-    
-    // 发送命令数据
-    size_t bytesSent = port->write(command.data(), command.size());
-    port->flush(); // 确保数据发送完成
-    if (bytesSent != command.size()) {
+    if (!admit(tx)) {
         return false;
     }
-    
-    // 等待回复数据，使用超时机制
-    unsigned long startTime = millis();
-    while (millis() - startTime < timeout_ms) {
-        if (port->available() > 0) {
-            // 稍作延时，确保数据稳定
-            vTaskDelay(10);    //无阻塞延时
-            // 读取所有可用的数据
-            while (port->available()) {
-                int byteRead = port->read();
-                if (byteRead >= 0) {
-                    response.push_back(static_cast<uint8_t>(byteRead));
+    return motorBus->submit(tx);
+}
+
+BusError StepperMotor::await(BusTransaction& tx) {
+    BusError error = motorBus ? motorBus->wait(tx) : tx.error;
+    recordOutcome(tx);
+    return error;
+}
+
+// 只有驱动器是否应答才反映其健康状态；总线自身的错误与免应答事务不计入
+void StepperMotor::recordOutcome(const BusTransaction& tx) {
+    if (motorAddr == 0 || !tx.expectReply) {
+        return;
+    }
+    switch (tx.error) {
+        case BusError::NONE:
+        case BusError::REJECTED:
+        case BusError::INVALID_COMMAND:
+            consecutiveFailures = 0;
+            healthState = MotorHealth::HEALTHY;
+            break;
+        case BusError::TIMEOUT:
+        case BusError::CHECKSUM:
+            if (consecutiveFailures < 255) {
+                ++consecutiveFailures;
+            }
+            if (consecutiveFailures >= breakerTripThreshold) {
+                if (healthState != MotorHealth::OPEN) {
+                    lastProbeMs = millis();
                 }
+                healthState = MotorHealth::OPEN;
+            } else {
+                healthState = MotorHealth::DEGRADED;
             }
-            break; // 数据接收完成，跳出循环
-        }
-        vTaskDelay(1);
+            break;
+        default:
+            break;
+    }
+}
+
+// 检查事务应答是否为 "地址 + 功能码 + 0x02 + 校验"
+bool StepperMotor::checkAck(const BusTransaction& tx) const {
+    if (!tx.expectReply) {
+        return tx.ok();
     }
-    
-    if (response.empty()) {
-        // 超时未收到数据
+    if (!tx.ok() || tx.response.size() < 3) {
         return false;
     }
-    
-    // 对于回复数据，假定最后一个字节为校验字节，验证其正确性
-    if (!response.empty()) {
-        std::vector<uint8_t> dataWithoutChecksum(response.begin(), response.end() - 1);
-        uint8_t expectedChecksum = calculateChecksum(dataWithoutChecksum);
-        uint8_t receivedChecksum = response.back();
-        if (expectedChecksum != receivedChecksum) {
-            // 校验失败
-            return false;
-        }
+    // 广播地址（0）的命令由地址为 1 的电机代为回复
+    return (motorAddr == 0 || tx.response[0] == motorAddr) &&
+           tx.response[1] == tx.funcCode() && tx.response[2] == Emm42::REPLY_OK;
+}
+
+// 检查读取类事务的应答地址、功能码与长度
+bool StepperMotor::checkReply(const BusTransaction& tx) const {
+    return tx.ok() && tx.response.size() == Emm42::responseLength(tx.funcCode()) &&
+           tx.response[0] == motorAddr && tx.response[1] == tx.funcCode();
+}
+
+// 已完成事务校验或解析失败的原因：总线自身的错误，或应答内容不符
+BusError StepperMotor::failureOf(const BusTransaction& tx) const {
+    return tx.ok() ? BusError::BAD_REPLY : tx.error;
+}
+
+// 控制命令事务的结果
+BusError StepperMotor::ackError(const BusTransaction& tx) const {
+    return checkAck(tx) ? BusError::NONE : failureOf(tx);
+}
+
+// 私有方法：通过总线发送命令帧并接收应答帧（阻塞至事务完成）
+BusResult StepperMotor::transfer(Emm42::ByteSpan request, Emm42::Frame& response) {
+    if (!motorBus) {
+        return BusError::NO_PORT;
     }
-    
-    return true;
+    if (request.size < 3) {
+        return BusError::INVALID_COMMAND;
+    }
+    BusTransaction tx;
+    prepare(tx, request);
+    BusError error = run(tx);
+    response = tx.response;
+    return error;
+}
+
+// 私有方法：发送读取命令，检查应答地址、功能码与长度
+BusResult StepperMotor::query(Emm42::ByteSpan request, Emm42::Frame& response) {
+    if (!motorBus) {
+        return BusError::NO_PORT;
+    }
+    BusTransaction tx;
+    prepare(tx, request);
+    run(tx);
+    response = tx.response;
+    return checkReply(tx) ? BusError::NONE : failureOf(tx);
+}
+
+// 私有方法：发送控制/修改命令，期望回复：地址 + 功能码 + 0x02 + 校验字节
+BusResult StepperMotor::command(Emm42::ByteSpan request) {
+    if (!motorBus) {
+        return BusError::NO_PORT;
+    }
+    BusTransaction tx;
+    prepare(tx, request);
+    run(tx);
+    return ackError(tx);
+}
+
+// 私有方法：计算校验字节（旧接口，转发至 Emm42::checksum）
+uint8_t StepperMotor::calculateChecksum(const std::vector<uint8_t>& data) {
+    return Emm42::checksum(checksumType, Emm42::ByteSpan(data.data(), data.size()));
+}
+
+// 私有方法：发送命令并接收回复（旧接口，转发至 transfer）
+BusResult StepperMotor::sendCommand(const std::vector<uint8_t>& command, std::vector<uint8_t>& response) {
+    Emm42::Frame frame;
+    BusResult ok = transfer(Emm42::ByteSpan(command.data(), command.size()), frame);
+    response.assign(frame.data(), frame.data() + frame.size());
+    return ok;
 }
 
 // 私有方法：将 16 位无符号整数转换为字节序列并添加到缓冲区（大端顺序）
@@ -112,499 +323,560 @@ void StepperMotor::appendUint32(std::vector<uint8_t>& buf, uint32_t value) {
     buf.push_back(static_cast<uint8_t>(value & 0xFF));
 }
 
-// 新增函数实现：构造命令帧
-// 内部函数：构造命令帧
+// 内部函数：构造命令帧（旧接口）
 std::vector<uint8_t> StepperMotor::buildFrame(uint8_t funcCode, const std::vector<uint8_t>& payload) {
     std::vector<uint8_t> frame;
-    // 添加地址
+    frame.reserve(payload.size() + 3);
     frame.push_back(motorAddr);
-    // 添加功能码
     frame.push_back(funcCode);
-    // 添加指令数据（如果有）
-    if (!payload.empty()) {
-        frame.insert(frame.end(), payload.begin(), payload.end());
-    }
-    // 计算校验字节并追加
-    uint8_t checksum = calculateChecksum(frame);
-    frame.push_back(checksum);
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.push_back(calculateChecksum(frame));
     return frame;
 }
 /*************************************************** 写入命令 *************************************/
 // 实现电机使能控制命令
-bool StepperMotor::enableMotor(bool enable, bool sync) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0xAB);                     // 固定命令数据标识
-    payload.push_back(enable ? 0x01 : 0x00);       // 使能状态：1-使能，0-失能
-    payload.push_back(sync ? 0x01 : 0x00);           // 多机同步标志：1-同步，0-立即执行
-    
-    auto frame = buildFrame(0xF3, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) {
-        return false;
+BusResult StepperMotor::enableMotor(bool enable, bool sync) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareEnable(tx, enable, sync);
+    run(tx);
+    return ackError(tx);
+}
+
+// 构造电机使能控制命令事务
+void StepperMotor::prepareEnable(BusTransaction& tx, bool enable, bool sync) const {
+    // 地址 + 0xF3 + 0xAB + 使能状态 + 多机同步标志 + 校验字节
+    prepareControl(tx, Emm42::encode<0xF3>(motorAddr, checksumType, 0xAB,
+                                           enable ? 0x01 : 0x00,    // 使能状态：1-使能，0-失能
+                                           sync ? 0x01 : 0x00).span()); // 多机同步标志：1-同步，0-立即执行
+}
+
+// 实现速度模式控制命令
+BusResult StepperMotor::setSpeedMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareSpeedMode(tx, direction, speedRpm, accelerateLevel, sync);
+    run(tx);
+    return ackError(tx);
+}
+
+// 实现位置模式控制命令
+BusResult StepperMotor::setPositionMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, uint32_t pulse, bool absolute, bool sync) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    preparePositionMode(tx, direction, speedRpm, accelerateLevel, pulse, absolute, sync);
+    run(tx);
+    return ackError(tx);
+}
+
+// 实现立即停止命令
+BusResult StepperMotor::stopMotor(bool sync) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareStop(tx, sync);
+    run(tx);
+    return ackError(tx);
+}
+
+// 实现多机同步运动命令
+BusResult StepperMotor::syncMove() {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareSyncMove(tx);
+    run(tx);
+    return ackError(tx);
+}
+
+/*************************************************** 异步事务构造 *************************************/
+// 构造速度模式命令事务
+void StepperMotor::prepareSpeedMode(BusTransaction& tx, uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync) {
+    // 地址 + 0xF6 + 方向 + 速度（2字节大端序）+ 加速度档位 + 多机同步标志 + 校验字节
+    auto frame = Emm42::encode<0xF6>(motorAddr, checksumType, direction, Emm42::U16{speedRpm},
+                                     accelerateLevel, sync ? 0x01 : 0x00);
+    prepareControl(tx, frame.span());
+    if (unacknowledged) {
+        recordSpeedSetpoint(direction, speedRpm, accelerateLevel);
     }
-    // 期望回复：地址 + 0xF3 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xF3 || response[2] != 0x02) {
-        return false;
+}
+
+// 构造位置模式命令事务
+void StepperMotor::preparePositionMode(BusTransaction& tx, uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel,
+                                       uint32_t pulse, bool absolute, bool sync) {
+    // 地址 + 0xFD + 方向 + 速度(2) + 加速度档位 + 脉冲数(4) + 相对/绝对标志 + 多机同步标志 + 校验字节
+    auto frame = Emm42::encode<0xFD>(motorAddr, checksumType, direction, Emm42::U16{speedRpm},
+                                     accelerateLevel, Emm42::U32{pulse},
+                                     absolute ? 0x01 : 0x00,    // 模式标志：1-绝对，0-相对
+                                     sync ? 0x01 : 0x00);
+    prepareControl(tx, frame.span());
+    if (!absolute) {
+        tx.maxRetries = 0;          // 相对运动不可重发：应答丢失时命令可能已被执行
     }
-    return true;
+    pendingSpeed.active = false;    // 切换到位置模式后不再验证速度设定值
 }
 
-// 实现速度模式控制命令
-bool StepperMotor::setSpeedMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool sync) {
-    std::vector<uint8_t> payload;
-    payload.push_back(direction);          // 旋转方向：0-CW，1-CCW
-    appendUint16(payload, speedRpm);         // 速度（2字节大端序）
-    payload.push_back(accelerateLevel);      // 加速度档位
-    payload.push_back(sync ? 0x01 : 0x00);     // 多机同步标志
-    
-    auto frame = buildFrame(0xF6, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) {
+// 构造立即停止命令事务
+void StepperMotor::prepareStop(BusTransaction& tx, bool sync) {
+    prepareStopCommand(tx, sync);
+    pendingSpeed.active = false;
+}
+
+// 只构造立即停止命令事务
+void StepperMotor::prepareStopCommand(BusTransaction& tx, bool sync) const {
+    // 地址 + 0xFE + 0x98 + 多机同步标志 + 校验字节
+    prepareControl(tx, Emm42::encode<0xFE>(motorAddr, checksumType, 0x98, sync ? 0x01 : 0x00).span());
+    tx.priority = BusPriority::HIGH;   // 停止命令优先于队列中的其它事务
+}
+
+// 构造多机同步运动命令事务
+void StepperMotor::prepareSyncMove(BusTransaction& tx) const {
+    // 地址 + 0xFF + 0x66 + 校验字节
+    auto frame = Emm42::encode<0xFF>(motorAddr, checksumType, 0x66);
+    prepareControl(tx, frame.span());
+    tx.maxRetries = 0;              // 同步触发只在首次送达时有意义
+}
+
+// 构造读取实时转速事务
+void StepperMotor::prepareReadRealTimeSpeed(BusTransaction& tx) const {
+    prepare(tx, Emm42::encode<0x35>(motorAddr, checksumType).span());
+}
+
+// 构造读取实时位置事务
+void StepperMotor::prepareReadRealTimePosition(BusTransaction& tx) const {
+    prepare(tx, Emm42::encode<0x36>(motorAddr, checksumType).span());
+}
+
+// 同步启动突发：命令帧与同步触发帧在同一次写入中发出
+bool StepperMotor::submitSyncBurst(BusTransaction* const* txs, size_t count, BusTransaction& syncTx) {
+    prepareSyncMove(syncTx);
+    if (!motorBus || count + 1 > MotorBus::MAX_BURST) {
         return false;
     }
-    // 期望回复：地址 + 0xF6 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xF6 || response[2] != 0x02) {
-        return false;
+    BusTransaction* burst[MotorBus::MAX_BURST];
+    for (size_t i = 0; i < count; ++i) {
+        burst[i] = txs[i];
     }
+    burst[count] = &syncTx;
+    return motorBus->submitBurst(burst, count + 1);
+}
+
+// 解析读取实时转速事务的应答
+bool StepperMotor::parseRealTimeSpeed(const BusTransaction& tx, int16_t& speed) const {
+    // 期望返回：地址 + 0x35 + 符号（1字节）+ 2字节转速 + 校验字节，共 6 字节
+    if (tx.funcCode() != 0x35 || !checkReply(tx)) return false;
+    speed = Emm42::readSigned16(&tx.response.bytes[2]);
     return true;
 }
 
-// 实现位置模式控制命令
-bool StepperMotor::setPositionMode(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, uint32_t pulse, bool absolute, bool sync) {
-    std::vector<uint8_t> payload;
-    payload.push_back(direction);          // 旋转方向：0-CW，1-CCW
-    appendUint16(payload, speedRpm);         // 速度（2字节大端序）
-    payload.push_back(accelerateLevel);      // 加速度档位
-    appendUint32(payload, pulse);            // 脉冲数（4字节大端序）
-    payload.push_back(absolute ? 0x01 : 0x00); // 模式标志：1-绝对，0-相对
-    payload.push_back(sync ? 0x01 : 0x00);     // 多机同步标志
-    
-    auto frame = buildFrame(0xFD, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) {
-        return false;
+// 构造读取系统状态参数事务
+void StepperMotor::prepareReadSystemStatus(BusTransaction& tx) const {
+    prepare(tx, Emm42::encode<0x43>(motorAddr, checksumType, 0x7A).span());
+}
+
+// 构造读取固件版本事务
+void StepperMotor::prepareReadFirmwareVersion(BusTransaction& tx) const {
+    prepare(tx, Emm42::encode<0x1F>(motorAddr, checksumType).span());
+}
+
+// 解析读取固件版本事务的应答
+bool StepperMotor::parseFirmwareVersion(const BusTransaction& tx, uint8_t& firmware, uint8_t& hardware) const {
+    // 期望返回：地址 + 0x1F + 固件版本 + 硬件版本 + 校验字节，共 5 字节
+    if (tx.funcCode() != 0x1F || !checkReply(tx)) return false;
+    firmware = tx.response.bytes[2];
+    hardware = tx.response.bytes[3];
+    return true;
+}
+
+// 构造读取驱动配置参数事务
+void StepperMotor::prepareReadDriverConfig(BusTransaction& tx) const {
+    prepare(tx, Emm42::encode<0x42>(motorAddr, checksumType, 0x6C).span());
+}
+
+// 解析读取驱动配置参数事务的应答
+bool StepperMotor::parseDriverConfig(const BusTransaction& tx, DriverConfig& config) const {
+    // 期望返回 33 字节：地址 + 0x42 + 0x21 + 0x15 + 21 个配置参数（28 字节）+ 校验字节
+    if (tx.funcCode() != 0x42 || !checkReply(tx)) return false;
+    const uint8_t* r = tx.response.bytes;
+    if (r[2] != 0x21 || r[3] != 0x15) return false;
+    decodeDriverConfig(&r[4], config);
+    return true;
+}
+
+// 解析读取系统状态参数事务的应答
+bool StepperMotor::parseSystemStatus(const BusTransaction& tx, SystemStatus& status) const {
+    // 期望返回 31 字节：地址 + 0x43 + 字节数(0x1F) + 参数个数(0x09) + 9 个参数 + 校验字节
+    if (tx.funcCode() != 0x43 || !checkReply(tx)) return false;
+    const uint8_t* r = tx.response.bytes;
+    if (r[2] != 0x1F || r[3] != 0x09) return false;
+    status.busVoltage = Emm42::readU16(&r[4]);
+    status.phaseCurrent = Emm42::readU16(&r[6]);
+    status.calibratedEncoderValue = Emm42::readU16(&r[8]);
+    status.targetPosition = Emm42::readSigned32(&r[10]);     // 符号 + 4 字节
+    status.realTimeSpeed = Emm42::readSigned16(&r[15]);      // 符号 + 2 字节
+    status.realTimePosition = Emm42::readSigned32(&r[18]);   // 符号 + 4 字节
+    status.positionError = Emm42::readSigned32(&r[23]);      // 符号 + 4 字节
+    status.readyStatus = r[28];
+    status.motorStatus = r[29];
+    return true;
+}
+
+// 解析读取实时位置事务的应答
+bool StepperMotor::parseRealTimePosition(const BusTransaction& tx, int32_t& position) const {
+    // 期望返回：地址 + 0x36 + 符号（1字节）+ 4字节位置值 + 校验字节，共 8 字节
+    if (tx.funcCode() != 0x36 || !checkReply(tx)) return false;
+    position = Emm42::readSigned32(&tx.response.bytes[2]);
+    return true;
+}
+
+/*************************************************** 免应答模式 *************************************/
+// 启用/关闭免应答模式：启用前确认驱动器不会回复控制命令
+BusResult StepperMotor::enableUnacknowledgedMode(bool enable) {
+    if (!enable) {
+        unacknowledged = false;
+        pendingSpeed.active = false;
+        return BusError::NONE;
     }
-    // 期望回复：地址 + 0xFD + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xFD || response[2] != 0x02) {
-        return false;
+    // 广播命令无人应答时无需（也无法）读取驱动配置确认
+    if (motorAddr == 0 && !broadcastReplies) {
+        unacknowledged = true;
+        return BusError::NONE;
     }
-    return true;
+    DriverConfig config;
+    BusResult result = readDriverConfig(config);
+    if (!result) {
+        return result;
+    }
+    if (config.cmdResponse != CommandResponse::NONE) {
+        return BusError::REJECTED;      // 驱动器仍会回复控制命令
+    }
+    unacknowledged = true;
+    return BusError::NONE;
 }
 
-// 实现立即停止命令
-bool StepperMotor::stopMotor(bool sync) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x98);                     // 固定停止命令数据
-    payload.push_back(sync ? 0x01 : 0x00);         // 多机同步标志
-    
-    auto frame = buildFrame(0xFE, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) {
-        return false;
+// 按已知的驱动器应答设置切换本地模式
+void StepperMotor::assumeCommandResponse(CommandResponse mode) {
+    unacknowledged = (mode == CommandResponse::NONE);
+    pendingSpeed.active = false;
+}
+
+// 修改控制命令应答设置并同步切换本地模式
+BusResult StepperMotor::setCommandResponse(CommandResponse mode, bool store) {
+    DriverConfig config;
+    BusResult result = readDriverConfig(config);
+    if (!result) {
+        return result;
     }
-    // 期望回复：地址 + 0xFE + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xFE || response[2] != 0x02) {
-        return false;
+    config.cmdResponse = mode;
+    // 修改命令本身不属于控制命令，驱动器仍会应答
+    result = modifyDriverConfig(config, store);
+    if (!result) {
+        return result;
     }
-    return true;
+    unacknowledged = (mode == CommandResponse::NONE);
+    pendingSpeed.active = false;
+    return BusError::NONE;
 }
 
-// 实现多机同步运动命令
-bool StepperMotor::syncMove() {
-    // 构造多机同步运动命令帧：地址 + 0xFF + 0x66 + 校验字节
-    std::vector<uint8_t> payload;
-    payload.push_back(0x66);  // 固定命令数据
-    auto frame = buildFrame(0xFF, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) {
-        return false;
+// 记录免应答速度设定值，待下一次遥测读取时验证
+void StepperMotor::recordSpeedSetpoint(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel) {
+    // 重复下发相同的设定值时沿用原计时，避免每个控制周期都推迟判定
+    if (pendingSpeed.active && pendingSpeed.direction == direction &&
+        pendingSpeed.speedRpm == speedRpm && pendingSpeed.accelerateLevel == accelerateLevel) {
+        return;
+    }
+    pendingSpeed.active = true;
+    pendingSpeed.direction = direction;
+    pendingSpeed.speedRpm = speedRpm;
+    pendingSpeed.accelerateLevel = accelerateLevel;
+    pendingSpeed.startRpm = lastMeasuredRpm;
+    pendingSpeed.issuedMs = millis();
+    // 加速度档位 a（非 0）时每 (256 - a) * 50us 转速变化 1 RPM，
+    // 宽限时间需覆盖转速变化到可分辨（两倍容差）所需的时间
+    uint32_t rampMs = accelerateLevel == 0 ? 0
+        : static_cast<uint32_t>(2 * SETPOINT_TOLERANCE_RPM) * (256 - accelerateLevel) / 20;
+    pendingSpeed.graceMs = SETPOINT_BASE_GRACE_MS + rampMs;
+}
+
+// 用实测转速验证最近一次免应答速度设定值
+SetpointCheck StepperMotor::verifySpeedSetpoint(int16_t measuredRpm) {
+    lastMeasuredRpm = measuredRpm;
+    if (!pendingSpeed.active) {
+        return SetpointCheck::NONE;
     }
-    // 期望回复：地址 + 0xFF + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xFF || response[2] != 0x02) {
+
+    // 带符号比较：方向 1 的实时转速符号位为 0x01（负值），与 readSigned16 一致
+    int32_t target = pendingSpeed.direction ? -static_cast<int32_t>(pendingSpeed.speedRpm)
+                                            : static_cast<int32_t>(pendingSpeed.speedRpm);
+    int32_t measured = measuredRpm;
+    int32_t remaining = std::abs(target - measured);
+    int32_t initial = std::abs(target - static_cast<int32_t>(pendingSpeed.startRpm));
+    // 转向与设定值相反时不算达到（例如反向命令丢失，车轮仍以原速度反转）
+    bool wrongWay = (target > 0 && measured < 0) || (target < 0 && measured > 0);
+
+    // 已达到设定值，或转速明显朝设定值变化：驱动器已收到命令
+    if ((!wrongWay && remaining <= SETPOINT_TOLERANCE_RPM) || initial - remaining > SETPOINT_TOLERANCE_RPM) {
+        pendingSpeed.active = false;
+        return SetpointCheck::CONFIRMED;
+    }
+    if (millis() - pendingSpeed.issuedMs < pendingSpeed.graceMs) {
+        return SetpointCheck::PENDING;
+    }
+    ++lostSetpoints;
+    return SetpointCheck::LOST;
+}
+
+// 重发最近一次未确认的速度设定值
+BusResult StepperMotor::resendSpeedSetpoint() {
+    if (!motorBus) {
+        return BusError::NO_PORT;
+    }
+    BusTransaction tx;
+    if (!prepareResendSpeedSetpoint(tx)) {
+        return BusError::NONE;      // 没有待重发的设定值
+    }
+    run(tx);
+    return ackError(tx);
+}
+
+// 构造重发事务
+bool StepperMotor::prepareResendSpeedSetpoint(BusTransaction& tx) {
+    if (!pendingSpeed.active) {
         return false;
     }
+    PendingSpeedSetpoint setpoint = pendingSpeed;
+    pendingSpeed.active = false;    // 强制 recordSpeedSetpoint 重新计时
+    prepareSpeedMode(tx, setpoint.direction, setpoint.speedRpm, setpoint.accelerateLevel, false);
     return true;
 }
 
 /***************************************************读取命令 *************************************/
 // 读取固件版本和硬件版本
-bool StepperMotor::readFirmwareVersion(uint8_t &firmware, uint8_t &hardware) {
-    auto frame = buildFrame(0x1F);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readFirmwareVersion(uint8_t &firmware, uint8_t &hardware) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x1F + 固件版本 + 硬件版本 + 校验字节，共 5 字节
-    if (response.size() != 5 || response[0] != motorAddr || response[1] != 0x1F)
-        return false;
+    BusResult result = query(Emm42::encode<0x1F>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
     firmware = response[2];
     hardware = response[3];
-    return true;
+    return BusError::NONE;
 }
 
 // 读取相电阻和相电感
-bool StepperMotor::readPhaseResistanceInductance(uint16_t &resistance, uint16_t &inductance) {
-    auto frame = buildFrame(0x20);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readPhaseResistanceInductance(uint16_t &resistance, uint16_t &inductance) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x20 + R_H + R_L + L_H + L_L + 校验字节，共 7 字节
-    if (response.size() != 7 || response[0] != motorAddr || response[1] != 0x20)
-        return false;
-    resistance = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-    inductance = (static_cast<uint16_t>(response[4]) << 8) | response[5];
-    return true;
+    BusResult result = query(Emm42::encode<0x20>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    resistance = Emm42::readU16(&response.bytes[2]);
+    inductance = Emm42::readU16(&response.bytes[4]);
+    return BusError::NONE;
 }
 
 // 读取位置环 PID 参数
-bool StepperMotor::readPIDParameters(uint32_t &Kp, uint32_t &Ki, uint32_t &Kd) {
-    auto frame = buildFrame(0x21);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readPIDParameters(uint32_t &Kp, uint32_t &Ki, uint32_t &Kd) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x21 + Kp(4) + Ki(4) + Kd(4) + 校验字节，共 15 字节
-    if (response.size() != 15 || response[0] != motorAddr || response[1] != 0x21)
-        return false;
-    Kp = (static_cast<uint32_t>(response[2]) << 24) |
-         (static_cast<uint32_t>(response[3]) << 16) |
-         (static_cast<uint32_t>(response[4]) << 8)  | response[5];
-    Ki = (static_cast<uint32_t>(response[6]) << 24) |
-         (static_cast<uint32_t>(response[7]) << 16) |
-         (static_cast<uint32_t>(response[8]) << 8)  | response[9];
-    Kd = (static_cast<uint32_t>(response[10]) << 24) |
-         (static_cast<uint32_t>(response[11]) << 16) |
-         (static_cast<uint32_t>(response[12]) << 8)  | response[13];
-    return true;
+    BusResult result = query(Emm42::encode<0x21>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    Kp = Emm42::readU32(&response.bytes[2]);
+    Ki = Emm42::readU32(&response.bytes[6]);
+    Kd = Emm42::readU32(&response.bytes[10]);
+    return BusError::NONE;
 }
 
 // 读取总线电压
-bool StepperMotor::readBusVoltage(uint16_t &voltage) {
-    auto frame = buildFrame(0x24);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readBusVoltage(uint16_t &voltage) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x24 + V_H + V_L + 校验字节，共 5 字节
-    if (response.size() != 5 || response[0] != motorAddr || response[1] != 0x24)
-        return false;
-    voltage = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-    return true;
+    BusResult result = query(Emm42::encode<0x24>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    voltage = Emm42::readU16(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取相电流
-bool StepperMotor::readPhaseCurrent(uint16_t &current) {
-    auto frame = buildFrame(0x27);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readPhaseCurrent(uint16_t &current) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x27 + current_H + current_L + 校验字节，共 5 字节
-    if (response.size() != 5 || response[0] != motorAddr || response[1] != 0x27)
-        return false;
-    current = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-    return true;
+    BusResult result = query(Emm42::encode<0x27>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    current = Emm42::readU16(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取经过线性校准后的编码器值
-bool StepperMotor::readCalibratedEncoder(uint16_t &encoder) {
-    auto frame = buildFrame(0x31);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readCalibratedEncoder(uint16_t &encoder) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x31 + encoder_H + encoder_L + 校验字节，共 5 字节
-    if (response.size() != 5 || response[0] != motorAddr || response[1] != 0x31)
-        return false;
-    encoder = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-    return true;
+    BusResult result = query(Emm42::encode<0x31>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    encoder = Emm42::readU16(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取输入脉冲数
-bool StepperMotor::readInputPulse(int32_t &pulse) {
-    auto frame = buildFrame(0x32);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readInputPulse(int32_t &pulse) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x32 + 符号（1字节）+ 4字节脉冲数 + 校验字节，共 8 字节
-    if (response.size() != 8 || response[0] != motorAddr || response[1] != 0x32)
-        return false;
-    uint32_t raw = (static_cast<uint32_t>(response[3]) << 24) |
-                   (static_cast<uint32_t>(response[4]) << 16) |
-                   (static_cast<uint32_t>(response[5]) << 8)  | response[6];
-    pulse = (response[2] == 0x01) ? -static_cast<int32_t>(raw) : static_cast<int32_t>(raw);
-    return true;
+    BusResult result = query(Emm42::encode<0x32>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    pulse = Emm42::readSigned32(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取电机目标位置
-bool StepperMotor::readTargetPosition(int32_t &position) {
-    auto frame = buildFrame(0x33);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readTargetPosition(int32_t &position) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x33 + 符号（1字节）+ 4字节位置值 + 校验字节，共 8 字节
-    if (response.size() != 8 || response[0] != motorAddr || response[1] != 0x33)
-        return false;
-    uint32_t raw = (static_cast<uint32_t>(response[3]) << 24) |
-                   (static_cast<uint32_t>(response[4]) << 16) |
-                   (static_cast<uint32_t>(response[5]) << 8)  | response[6];
-    position = (response[2] == 0x01) ? -static_cast<int32_t>(raw) : static_cast<int32_t>(raw);
-    return true;
+    BusResult result = query(Emm42::encode<0x33>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    position = Emm42::readSigned32(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取电机实时转速
-bool StepperMotor::readRealTimeSpeed(int16_t &speed) {
-    auto frame = buildFrame(0x35);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望返回：地址 + 0x35 + 符号（1字节）+ 2字节转速 + 校验字节，共 6 字节
-    if (response.size() != 6 || response[0] != motorAddr || response[1] != 0x35)
-        return false;
-    uint16_t raw = (static_cast<uint16_t>(response[3]) << 8) | response[4];
-    speed = (response[2] == 0x01) ? -static_cast<int16_t>(raw) : static_cast<int16_t>(raw);
-    return true;
+BusResult StepperMotor::readRealTimeSpeed(int16_t &speed) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareReadRealTimeSpeed(tx);
+    run(tx);
+    return parseRealTimeSpeed(tx, speed) ? BusError::NONE : failureOf(tx);
 }
 
 // 读取电机实时位置
-bool StepperMotor::readRealTimePosition(int32_t &position) {
-    auto frame = buildFrame(0x36);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望返回：地址 + 0x36 + 符号（1字节）+ 4字节位置值 + 校验字节，共 8 字节
-    if (response.size() != 8 || response[0] != motorAddr || response[1] != 0x36)
-        return false;
-    uint32_t raw = (static_cast<uint32_t>(response[3]) << 24) |
-                   (static_cast<uint32_t>(response[4]) << 16) |
-                   (static_cast<uint32_t>(response[5]) << 8)  | response[6];
-    position = (response[2] == 0x01) ? -static_cast<int32_t>(raw) : static_cast<int32_t>(raw);
-    return true;
+BusResult StepperMotor::readRealTimePosition(int32_t &position) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareReadRealTimePosition(tx);
+    run(tx);
+    return parseRealTimePosition(tx, position) ? BusError::NONE : failureOf(tx);
 }
 
 // 读取电机位置误差
-bool StepperMotor::readPositionError(int32_t &error) {
-    auto frame = buildFrame(0x37);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readPositionError(int32_t &error) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x37 + 符号（1字节）+ 4字节误差值 + 校验字节，共 8 字节
-    if (response.size() != 8 || response[0] != motorAddr || response[1] != 0x37)
-        return false;
-    uint32_t raw = (static_cast<uint32_t>(response[3]) << 24) |
-                   (static_cast<uint32_t>(response[4]) << 16) |
-                   (static_cast<uint32_t>(response[5]) << 8)  | response[6];
-    error = (response[2] == 0x01) ? -static_cast<int32_t>(raw) : static_cast<int32_t>(raw);
-    return true;
+    BusResult result = query(Emm42::encode<0x37>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
+    error = Emm42::readSigned32(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 // 读取电机状态标志位
-bool StepperMotor::readMotorStatus(uint8_t &status) {
-    auto frame = buildFrame(0x3A);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
+BusResult StepperMotor::readMotorStatus(uint8_t &status) {
+    Emm42::Frame response;
     // 期望返回：地址 + 0x3A + 状态字节 + 校验字节，共 4 字节
-    if (response.size() != 4 || response[0] != motorAddr || response[1] != 0x3A)
-        return false;
+    BusResult result = query(Emm42::encode<0x3A>(motorAddr, checksumType).span(), response);
+    if (!result) return result;
     status = response[2];
-    return true;
+    return BusError::NONE;
 }
 
 // 读取驱动配置参数
-bool StepperMotor::readDriverConfig(DriverConfig &config) {
-    auto frame = buildFrame(0x42, {0x6C});
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望返回总字节数约33字节（协议要求返回21个配置参数）
-    if (response.size() < 33 || response[0] != motorAddr || response[1] != 0x42)
-        return false;
-    // 以下映射基于协议描述（各字段可能根据实际硬件文档调整）
-    config.motorType = response[2];
-    config.pulseControlMode = response[3];
-    config.commPortMode = response[4];
-    config.enPinEffectiveLevel = response[5];
-    config.dirPinEffectiveDirection = response[6];
-    config.subdivision = (static_cast<uint16_t>(response[7]) << 8) | response[8];
-    config.subdivisionInterpolation = (response[9] != 0);
-    config.autoSleep = (response[10] != 0);
-    config.openLoopCurrent = (static_cast<uint16_t>(response[11]) << 8) | response[12];
-    config.closedLoopMaxCurrent = (static_cast<uint16_t>(response[13]) << 8) | response[14];
-    config.maxOutputVoltage = (static_cast<uint16_t>(response[15]) << 8) | response[16];
-    config.serialBaudRate = (static_cast<uint32_t>(response[17]) << 24) | (static_cast<uint32_t>(response[18]) << 16)
-                            | (static_cast<uint32_t>(response[19]) << 8) | response[20];
-    config.canCommRate = (static_cast<uint32_t>(response[21]) << 24) | (static_cast<uint32_t>(response[22]) << 16)
-                         | (static_cast<uint32_t>(response[23]) << 8) | response[24];
-    config.id = response[25];
-    config.commChecksum = response[26];
-    config.cmdResponse = response[27];
-    config.stallProtectionEnabled = (response[28] != 0);
-    config.stallThresholdSpeed = (static_cast<uint16_t>(response[29]) << 8) | response[30];
-    config.stallThresholdCurrent = (static_cast<uint16_t>(response[31]) << 8) | response[32];
-    return true;
+BusResult StepperMotor::readDriverConfig(DriverConfig &config) {
+    Emm42::Frame response;
+    // 期望返回 33 字节：地址 + 0x42 + 0x21 + 0x15 + 21 个配置参数（28 字节）+ 校验字节
+    BusResult result = query(Emm42::encode<0x42>(motorAddr, checksumType, 0x6C).span(), response);
+    if (!result) return result;
+    if (response[2] != 0x21 || response[3] != 0x15) return BusError::BAD_REPLY;
+    decodeDriverConfig(&response.bytes[4], config);
+    return BusError::NONE;
 }
 
 // 读取系统状态参数
-bool StepperMotor::readSystemStatus(SystemStatus &status) {
-    auto frame = buildFrame(0x43, {0x7A});
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望返回约31字节数据（协议中说明返回9个参数）
-    if (response.size() < 31 || response[0] != motorAddr || response[1] != 0x43)
-        return false;
-    // 以下字段按照协议描述依次解析（具体字节偏移根据实际返回数据可能需要调整）
-    status.busVoltage = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-    status.phaseCurrent = (static_cast<uint16_t>(response[4]) << 8) | response[5];
-    status.calibratedEncoderValue = (static_cast<uint16_t>(response[6]) << 8) | response[7];
-    status.targetPosition = (static_cast<int32_t>(response[8]) << 24) | (static_cast<int32_t>(response[9]) << 16)
-                            | (static_cast<int32_t>(response[10]) << 8) | response[11];
-    status.realTimeSpeed = (static_cast<uint16_t>(response[12]) << 8) | response[13];
-    status.realTimePosition = (static_cast<int32_t>(response[14]) << 24) | (static_cast<int32_t>(response[15]) << 16)
-                             | (static_cast<int32_t>(response[16]) << 8) | response[17];
-    status.positionError = (static_cast<int32_t>(response[18]) << 24) | (static_cast<int32_t>(response[19]) << 16)
-                           | (static_cast<int32_t>(response[20]) << 8) | response[21];
-    status.readyStatus = response[22];
-    status.motorStatus = response[23];
-    return true;
+BusResult StepperMotor::readSystemStatus(SystemStatus &status) {
+    if (!motorBus) return BusError::NO_PORT;
+    BusTransaction tx;
+    prepareReadSystemStatus(tx);
+    run(tx);
+    return parseSystemStatus(tx, status) ? BusError::NONE : failureOf(tx);
 }
 
 // 读取电机实时目标位置
-bool StepperMotor::readRealTimeTargetPosition(int32_t &targetPosition) {
-    // 构造命令帧，功能码为 0x33，无额外 payload 数据
-    auto frame = buildFrame(0x33);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response))
-        return false;
-    
-    // 检查返回数据长度：应为 8 字节（地址 + 0x33 + 符号 + 4字节目标位置 + 校验字节）
-    if (response.size() != 8 || response[0] != motorAddr || response[1] != 0x33)
-        return false;
-    
-    uint8_t sign = response[2];  // 第3个字节为符号
-    // 提取后面4字节为目标位置数据（大端顺序）
-    uint32_t rawValue = (static_cast<uint32_t>(response[3]) << 24) |
-                        (static_cast<uint32_t>(response[4]) << 16) |
-                        (static_cast<uint32_t>(response[5]) << 8)  |
-                        (static_cast<uint32_t>(response[6]));
-    
-    // 根据符号进行转换：0x01 表示负数，0x00 表示正数
-    if (sign == 0x01)
-        targetPosition = -static_cast<int32_t>(rawValue);
-    else if (sign == 0x00)
-        targetPosition = static_cast<int32_t>(rawValue);
-    else
-        return false;  // 非法符号位
-    
-    return true;
+BusResult StepperMotor::readRealTimeTargetPosition(int32_t &targetPosition) {
+    Emm42::Frame response;
+    // 检查返回数据长度：应为 8 字节（地址 + 0x34 + 符号 + 4字节实时目标位置 + 校验字节）
+    BusResult result = query(Emm42::encode<0x34>(motorAddr, checksumType).span(), response);
+    if (!result)
+        return result;
+
+    // 符号位：0x01 表示负数，0x00 表示正数，其它为非法值
+    uint8_t sign = response[2];
+    if (sign != 0x00 && sign != 0x01)
+        return BusError::BAD_REPLY;
+    targetPosition = Emm42::readSigned32(&response.bytes[2]);
+    return BusError::NONE;
 }
 
 /************************************* 修改命令 *************************************/
 // 修改任意细分命令
-bool StepperMotor::modifySubdivision(uint8_t subdivision, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x8A); // 子命令：修改细分
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.push_back(subdivision); // 细分值（00表示256细分，其它值为对应细分数）
-    auto frame = buildFrame(0x84, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x84 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x84 || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::modifySubdivision(uint8_t subdivision, bool store) {
+    // 地址 + 0x84 + 0x8A + 存储标志 + 细分值（00表示256细分）+ 校验字节
+    return command(Emm42::encode<0x84>(motorAddr, checksumType, 0x8A, store ? 0x01 : 0x00, subdivision).span());
 }
 
 // 修改任意 ID 地址命令
-bool StepperMotor::modifyMotorID(uint8_t newID, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x4B); // 子命令：修改ID地址
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.push_back(newID); // 新的ID地址
-    auto frame = buildFrame(0xAE, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0xAE + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xAE || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::modifyMotorID(uint8_t newID, bool store) {
+    // 地址 + 0xAE + 0x4B + 存储标志 + 新ID地址 + 校验字节
+    return command(Emm42::encode<0xAE>(motorAddr, checksumType, 0x4B, store ? 0x01 : 0x00, newID).span());
 }
 
 // 切换开环/闭环模式命令
-bool StepperMotor::switchControlMode(uint8_t mode, bool store) {
+BusResult StepperMotor::switchControlMode(uint8_t mode, bool store) {
     // mode: 0x01 表示开环模式，0x02 表示闭环模式
-    std::vector<uint8_t> payload;
-    payload.push_back(0x69); // 子命令：切换模式
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.push_back(mode); // 模式标志
-    auto frame = buildFrame(0x46, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x46 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x46 || response[2] != 0x02)
-        return false;
-    return true;
+    return command(Emm42::encode<0x46>(motorAddr, checksumType, 0x69, store ? 0x01 : 0x00, mode).span());
 }
 
 // 修改开环模式工作电流命令
-bool StepperMotor::modifyOpenLoopCurrent(uint16_t current, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x33); // 子命令：修改开环模式电流
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.push_back(static_cast<uint8_t>((current >> 8) & 0xFF));  // 高字节
-    payload.push_back(static_cast<uint8_t>(current & 0xFF));         // 低字节
-    auto frame = buildFrame(0x44, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x44 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x44 || response[2] != 0x02)
-        return false;
-    return true;
-}
-
-// 修改驱动配置参数命令
-bool StepperMotor::modifyDriverConfig(const std::vector<uint8_t>& configData, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0xD1); // 子命令：修改驱动配置参数
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.insert(payload.end(), configData.begin(), configData.end());
-    auto frame = buildFrame(0x48, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x48 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x48 || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::modifyOpenLoopCurrent(uint16_t current, bool store) {
+    // 地址 + 0x44 + 0x33 + 存储标志 + 电流值（2字节）+ 校验字节
+    return command(Emm42::encode<0x44>(motorAddr, checksumType, 0x33, store ? 0x01 : 0x00, Emm42::U16{current}).span());
+}
+
+// 修改驱动配置参数命令（长度随参数数据变化，使用容量固定的 Emm42::Frame）
+BusResult StepperMotor::modifyDriverConfig(const std::vector<uint8_t>& configData, bool store) {
+    Emm42::Frame frame;
+    frame.push(motorAddr);
+    frame.push(0x48);
+    frame.push(0xD1); // 子命令：修改驱动配置参数
+    frame.push(store ? 0x01 : 0x00); // 存储标志
+    if (!frame.append(Emm42::ByteSpan(configData.data(), configData.size())) || !frame.seal(checksumType)) {
+        return BusError::INVALID_COMMAND; // 参数数据超出单帧容量，未发送
+    }
+    return command(frame.span());
+}
+
+// 修改驱动配置参数命令（结构体版本）
+BusResult StepperMotor::modifyDriverConfig(const DriverConfig& config, bool store) {
+    // 地址 + 0x48 + 0xD1 + 存储标志 + 21 个配置参数（28 字节，与 0x42 应答相同排列）+ 校验字节
+    Emm42::Frame frame;
+    frame.push(motorAddr);
+    frame.push(0x48);
+    frame.push(0xD1);
+    frame.push(store ? 0x01 : 0x00);
+    uint8_t params[DRIVER_CONFIG_PARAM_BYTES];
+    encodeDriverConfig(config, params);
+    if (!frame.append(Emm42::ByteSpan(params, sizeof(params))) || !frame.seal(checksumType)) {
+        return BusError::INVALID_COMMAND;
+    }
+    return command(frame.span());
 }
 
 // 修改位置环 PID 参数命令
-bool StepperMotor::modifyPIDParameters(uint32_t Kp, uint32_t Ki, uint32_t Kd, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0xC3); // 子命令：修改位置环 PID 参数
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    appendUint32(payload, Kp);
-    appendUint32(payload, Ki);
-    appendUint32(payload, Kd);
-    auto frame = buildFrame(0x4A, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x4A + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x4A || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::modifyPIDParameters(uint32_t Kp, uint32_t Ki, uint32_t Kd, bool store) {
+    // 地址 + 0x4A + 0xC3 + 存储标志 + Kp(4) + Ki(4) + Kd(4) + 校验字节
+    return command(Emm42::encode<0x4A>(motorAddr, checksumType, 0xC3, store ? 0x01 : 0x00,
+                                       Emm42::U32{Kp}, Emm42::U32{Ki}, Emm42::U32{Kd}).span());
 }
 
 // 存储一组速度模式参数命令
-bool StepperMotor::storeSpeedModeParameters(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool enableEn, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x1C); // 子命令：存储速度模式参数
-    payload.push_back(store ? 0x01 : 0x00); // 存储/清除标志
-    payload.push_back(direction);
-    appendUint16(payload, speedRpm);
-    payload.push_back(accelerateLevel);
-    payload.push_back(enableEn ? 0x01 : 0x00);
-    auto frame = buildFrame(0xF7, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0xF7 + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0xF7 || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::storeSpeedModeParameters(uint8_t direction, uint16_t speedRpm, uint8_t accelerateLevel, bool enableEn, bool store) {
+    // 地址 + 0xF7 + 0x1C + 存储/清除标志 + 方向 + 速度(2) + 加速度档位 + En控制 + 校验字节
+    return command(Emm42::encode<0xF7>(motorAddr, checksumType, 0x1C, store ? 0x01 : 0x00, direction,
+                                       Emm42::U16{speedRpm}, accelerateLevel, enableEn ? 0x01 : 0x00).span());
 }
 
 // 修改通讯控制的输入速度是否缩小10倍输入命令
-bool StepperMotor::modifyInputSpeedScaling(bool enable, bool store) {
-    std::vector<uint8_t> payload;
-    payload.push_back(0x71); // 子命令：修改输入速度缩放
-    payload.push_back(store ? 0x01 : 0x00); // 存储标志
-    payload.push_back(enable ? 0x01 : 0x00);
-    auto frame = buildFrame(0x4F, payload);
-    std::vector<uint8_t> response;
-    if (!sendCommand(frame, response)) return false;
-    // 期望回复：地址 + 0x4F + 0x02 + 校验字节
-    if (response.size() < 3 || response[0] != motorAddr || response[1] != 0x4F || response[2] != 0x02)
-        return false;
-    return true;
+BusResult StepperMotor::modifyInputSpeedScaling(bool enable, bool store) {
+    // 地址 + 0x4F + 0x71 + 存储标志 + 使能 + 校验字节
+    return command(Emm42::encode<0x4F>(motorAddr, checksumType, 0x71, store ? 0x01 : 0x00, enable ? 0x01 : 0x00).span());
 }
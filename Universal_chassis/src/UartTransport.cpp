@@ -0,0 +1,42 @@
+#include "StepperMotor/UartTransport.h"
+#include <cstring>
+
+bool UartTransport::writeFrames(const Emm42::ByteSpan* frames, size_t count) {
+    if (!port || count == 0 || count > MAX_WRITE_FRAMES) {
+        return false;
+    }
+
+    // 拼接全部命令帧，一次写出
+    uint8_t buffer[MAX_WRITE_FRAMES * Emm42::MAX_FRAME_LEN];
+    size_t length = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (frames[i].size > Emm42::MAX_FRAME_LEN) {
+            return false;
+        }
+        memcpy(buffer + length, frames[i].data, frames[i].size);
+        length += frames[i].size;
+    }
+
+    size_t bytesSent = port->write(buffer, length);
+    port->flush(); // 确保数据发送完成
+    return bytesSent == length;
+}
+
+bool UartTransport::setBitRate(uint32_t rate) {
+    if (!port || rate == 0) {
+        return false;
+    }
+    port->flush();
+    port->updateBaudRate(rate);
+    // 丢弃按旧波特率收到的残留字节
+    while (port->available() > 0) {
+        port->read();
+    }
+    return true;
+}
+
+uint32_t UartTransport::replyWireUs(size_t frameLen) const {
+    uint32_t baud = port ? port->baudRate() : 0;
+    // 8N1：每字节 10 位
+    return baud ? static_cast<uint32_t>(frameLen * 10ULL * 1000000ULL / baud) : 0;
+}
@@ -6,6 +6,11 @@
 
 #include <Arduino.h>
 #include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+#include "StepperMotor/CanTransport.h"
+#include "StepperMotor/BaudNegotiator.h"
+#include "StepperMotor/MotorDiscovery.h"
+#include "ParamStore/ParamStore.h"
 #include "CarController/CarController.h"
 #include "KinematicsModel/KinematicsModel.h"
 #include "freertos/FreeRTOS.h"
@@ -13,27 +18,78 @@
 #include "task/Mqtt_Control.hpp"
 #include "task/Usb_Control.hpp"
 #include "utils/Logger.hpp"
+#include "utils/BootProfiler.hpp"
 #include "config.h"
+#include "pins.h"
 #include "control/ControlManager.hpp"
+#if MICROROS_ENABLED
 #include "task/Microsros_Control.hpp"
+#endif
 
 
 
+#if MOTOR_BUS_CAN
+// CAN 总线：四个车轮共用一条 CAN 总线，应答按 ID 仲裁互不冲突
+TwaiTransport canTransport(MOTOR_CAN_TX, MOTOR_CAN_RX, MOTOR_CAN_BITRATE);
+MotorBus motorBus(&canTransport);
+
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
+#elif MOTOR_BUS_COUNT == 2
+// 双总线：右侧两轮接 Serial01，左侧两轮接 Serial02，两条总线各有独立的总线任务
+HardwareSerial Serial01(1);
+HardwareSerial Serial02(2);
+MotorBus busRight(&Serial01);
+MotorBus busLeft(&Serial02);
+
+// 每条总线一个广播电机（地址 0）及两个车轮电机；
+// 左侧总线没有地址 1 的驱动器，CarController 构造时将 motor0Left 设为广播不等待应答
+StepperMotor motor0Right(0, &busRight, ChecksumType::FIXED);
+StepperMotor motor0Left(0, &busLeft, ChecksumType::FIXED);
+StepperMotor motor1(1, &busRight, ChecksumType::FIXED);
+StepperMotor motor2(2, &busRight, ChecksumType::FIXED);
+StepperMotor motor3(3, &busLeft, ChecksumType::FIXED);
+StepperMotor motor4(4, &busLeft, ChecksumType::FIXED);
+
+// 每条总线各自协商波特率并监测链路质量
+StepperMotor* rightMotors[] = {&motor1, &motor2};
+StepperMotor* leftMotors[] = {&motor3, &motor4};
+BaudNegotiator baudRight(&busRight, rightMotors, 2);
+BaudNegotiator baudLeft(&busLeft, leftMotors, 2);
+#else
 // 初始化 ESP32 硬件串口（示例使用 Serial00）
 HardwareSerial Serial00(0);
 
+// 电机总线调度器：独占 Serial00，串行化所有电机事务
+MotorBus motorBus(&Serial00);
+
 // 创建主控板及四个轮的步进电机实例
-StepperMotor motor0(0, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor1(1, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor2(2, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor3(3, &Serial00, ChecksumType::FIXED, 1000);
-StepperMotor motor4(4, &Serial00, ChecksumType::FIXED, 1000);
+StepperMotor motor0(0, &motorBus, ChecksumType::FIXED);
+StepperMotor motor1(1, &motorBus, ChecksumType::FIXED);
+StepperMotor motor2(2, &motorBus, ChecksumType::FIXED);
+StepperMotor motor3(3, &motorBus, ChecksumType::FIXED);
+StepperMotor motor4(4, &motorBus, ChecksumType::FIXED);
+
+// 启动时协商波特率，运行时监测链路质量并在误码率升高时自动降速
+StepperMotor* busMotors[] = {&motor1, &motor2, &motor3, &motor4};
+BaudNegotiator baudNegotiator(&motorBus, busMotors, 4);
+#endif
 
 // 创建普通轮运动学模型实例：例子中轮子半径为 0.09m, 轮距 0.45m(v1.1)
 NormalWheelKinematics normalKinematics(0.09f, 0.45f, 6);
 
-// 创建 CarController 对象（传入四个轮及主控板电机和运动学模型）
+// 创建 CarController 对象（传入四个轮及各总线的广播电机和运动学模型）
+#if MOTOR_BUS_COUNT == 2 && !MOTOR_BUS_CAN
+CarController carController(&motor1, &motor2, &motor3, &motor4, {&motor0Right, &motor0Left}, &normalKinematics);
+#else
 CarController carController(&motor1, &motor2, &motor3, &motor4, &motor0, &normalKinematics);
+#endif
+
+// 持久化参数（NVS）
+ParamStore paramStore;
 
 // 在全局声明 MQTT 控制对象
 MqttControl mqttControl(0); // 默认1000ms发布一次状态
@@ -41,17 +97,25 @@ MqttControl mqttControl(0); // 默认1000ms发布一次状态
 // 在全局声明 USB 控制对象
 UsbControl usbControl(0);
 
+#if MICROROS_ENABLED
 // 在全局声明 MicroROS 控制对象
 MicrorosControl microrosControl;
+#endif
+
+// 网络初始化任务：WiFi / MQTT / micro-ROS 的连接耗时较长，在独立任务中进行，不阻塞电机总线与 USB
+static void networkBootTask(void* param) {
+    (void)param;
+    mqttControl.begin();
+#if MICROROS_ENABLED
+    microrosControl.begin();
+    BootProfiler::mark("microros");
+#endif
+    vTaskDelete(NULL);
+}
 
 void setup() {
-    Serial00.begin(961200, SERIAL_8N1, RX, TX);
-    Serial.begin(115200); 
+    BootProfiler::mark("setup");
 
-    while (!Serial.available()) {
-        vTaskDelay(pdMS_TO_TICKS(100));
-    }
-    
     // 初始化日志系统，默认为NONE级别（不输出任何日志）
     // 可以通过编译时定义DEBUG_MODE来启用调试日志
     // #define DEBUG_MODE
@@ -60,20 +124,124 @@ void setup() {
     #else
         Logger::init(LOG_LEVEL_NONE);  // 默认不输出任何日志
     #endif
-    
+
+    // USB 虚拟串口：不等待主机连接
+    Serial.begin(115200);
     Logger::info("MAIN", "System initializing...");
 
-    
-    // 初始化ControlManager
-    ControlManager::getInstance().init(&carController);
-    
-    mqttControl.begin();
-    
+    // 载入持久化参数（几何参数、默认控制参数、驱动器表缓存），无效时使用下面构造时的默认值
+    if (!paramStore.begin(normalKinematics.geometry(), carController.getConfig())) {
+        Logger::warn("MAIN", "No valid parameters in NVS, using defaults");
+    }
+    carController.setGeometry(paramStore.geometry());
+    carController.configure(paramStore.controlConfig());
+    ControlManager::getInstance().setParamStore(&paramStore);
+    BootProfiler::mark("params");
+
+    // 阶段 1：打开电机串口并启动总线任务
+#if MOTOR_BUS_CAN
+    canTransport.begin();
+    motorBus.begin();
+#elif MOTOR_BUS_COUNT == 2
+    Serial01.begin(MOTOR_BUS_BAUD, SERIAL_8N1, MOTOR_UART_RIGHT_RX, MOTOR_UART_RIGHT_TX);
+    Serial02.begin(MOTOR_BUS_BAUD, SERIAL_8N1, MOTOR_UART_LEFT_RX, MOTOR_UART_LEFT_TX);
+    // 启动两条总线的总线任务（优先级高于控制任务），两侧车轮的事务并行执行
+    busRight.begin();
+    busLeft.begin();
+#else
+    Serial00.begin(MOTOR_BUS_BAUD, SERIAL_8N1, RX, TX);
+    // 启动总线任务（优先级高于控制任务），此后所有电机事务由总线任务执行
+    motorBus.begin();
+#endif
+    BootProfiler::mark("motor_bus");
+
+    // 阶段 2：USB 控制。控制任务在电机总线就绪后才启动，此前收到的命令暂存在命令信箱中，
+    //         启动时已过时的速度/移动命令被作废（ControlManager::STALE_MOTION_MS）
+    ControlManager::getInstance().init(&carController, false);
+    ControlManager::getInstance().setLoopRate(CONTROL_LOOP_HZ);
     usbControl.begin();
-    
-    microrosControl.begin();
-    
+    BootProfiler::mark("usb_ready");
+
+    // 阶段 3：网络栈与下面的电机总线协商/探测并行初始化
+    xTaskCreate(networkBootTask, "networkBoot", 8192, NULL, 1, NULL);
+    BootProfiler::mark("net_start");
+
+    // 阶段 4：电机总线协商、探测与使能，完成后启动控制任务
+    // 协商电机总线波特率（CAN 总线无需协商）；协商时识别各车轮的校验方式，因此在驱动器探测之前进行，
+    // 未接入的车轮不参与协商，由下面的探测标记为不在线
+#if MOTOR_BUS_CAN
+#elif MOTOR_BUS_COUNT == 2
+    BaudNegotiator* negotiators[] = {&baudRight, &baudLeft};
+    for (auto negotiator : negotiators) {
+        if (negotiator->negotiate()) {
+            Logger::info("MAIN", "Motor bus baud rate: %lu (%u drivers)", static_cast<unsigned long>(negotiator->currentRate()),
+                         static_cast<unsigned>(negotiator->onlineCount()));
+        } else {
+            Logger::error("MAIN", "Motor bus baud negotiation failed");
+        }
+        negotiator->startSupervisor();
+    }
+#else
+    if (baudNegotiator.negotiate()) {
+        Logger::info("MAIN", "Motor bus baud rate: %lu (%u drivers)", static_cast<unsigned long>(baudNegotiator.currentRate()),
+                     static_cast<unsigned>(baudNegotiator.onlineCount()));
+    } else {
+        Logger::error("MAIN", "Motor bus baud negotiation failed");
+    }
+    baudNegotiator.startSupervisor();
+#endif
+    BootProfiler::mark("baud");
+
+    // 驱动器表：优先使用参数存储中上次探测的结果，缓存缺失或与车轮不符时重新探测
+    MotorTable motorTable;
+    if (paramStore.loadMotorTable(motorTable) && carController.coversWheels(motorTable) &&
+        carController.applyMotorTable(motorTable)) {
+        Logger::info("MAIN", "Using cached motor table: %u motors", static_cast<unsigned>(motorTable.count));
+    } else {
+        // 探测总线上的驱动器并按实际配置设置车轮（校验方式、每圈整步数、细分、应答模式）
+        MotorBus* discoveryBuses[CarController::MAX_BUSES] = {};
+        for (size_t b = 0; b < carController.getBusCount(); ++b) {
+            discoveryBuses[b] = carController.getBus(b);
+        }
+        MotorDiscovery discovery(discoveryBuses, carController.getBusCount());
+        discovery.run(motorTable);
+        for (size_t i = 0; i < motorTable.count; ++i) {
+            const MotorProfile& m = motorTable.motors[i];
+            Logger::info("MAIN", "Motor bus %u addr %u: fw %u hw %u, type %u, subdivision %u",
+                         m.bus, m.address, m.firmwareVersion, m.hardwareVersion,
+                         m.configValid ? m.config.motorType : 0, m.configValid ? m.config.subdivision : 0);
+        }
+        Logger::info("MAIN", "Motor discovery: %u found in %lu us", static_cast<unsigned>(motorTable.count),
+                     static_cast<unsigned long>(motorTable.elapsedUs));
+        if (motorTable.conflicts > 0) {
+            Logger::error("MAIN", "Motor discovery: %lu address conflicts", static_cast<unsigned long>(motorTable.conflicts));
+        }
+        if (!carController.applyMotorTable(motorTable)) {
+            Logger::error("MAIN", "Motor bus misconfigured: missing wheels or inconsistent driver settings");
+        }
+        // 缓存探测结果（默认细分数以驱动器实际设置为准），下次启动直接使用
+        paramStore.set("default_subdivision", carController.getConfig().defaultSubdivision);
+        paramStore.storeMotorTable(motorTable);
+        if (!paramStore.save()) {
+            Logger::error("MAIN", "Failed to save parameters");
+        }
+    }
+    BootProfiler::mark("discovery");
+
+    BusResult enabled = carController.enableMotors(true);
+    if (!enabled) {
+        Logger::error("MAIN", "Enable motors failed: %s", busErrorName(enabled.error));
+    }
+    // 启动阶段的探测与配置读取不受限；控制任务启动前开启周期预算
+    for (size_t b = 0; b < carController.getBusCount(); ++b) {
+        carController.getBus(b)->setCycleBudget(MOTOR_BUS_CYCLE_US, MOTOR_BUS_SETPOINT_BUDGET_US,
+                                                MOTOR_BUS_TELEMETRY_BUDGET_US, MOTOR_BUS_DIAGNOSTIC_BUDGET_US);
+    }
+    ControlManager::getInstance().start();
+    BootProfiler::mark("motors_ready");
+
     Logger::info("MAIN", "System initialized successfully");
+    BootProfiler::report();
 }
 
 void loop() {
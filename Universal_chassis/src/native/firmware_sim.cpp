@@ -0,0 +1,457 @@
+/*
+ * @Description: 全固件虚拟时间仿真入口（[env:native_firmware]）
+ *
+ * 在 Linux 上运行完整的 main.cpp（setup() / loop()、USB 与 MQTT 控制任务、波特率协商与探测），
+ * 调度由 lib/NativeHal 的虚拟时间模式接管（NativeSim.h）：任务按优先级在单核上轮流运行，
+ * 时间只随任务阻塞与计时调用推进，相同的种子与脚本得到相同的调度顺序与统计结果，并可快于真实时间运行。
+ *
+ *  - 电机总线（单总线 UART 配置的 Serial00）接进程内驱动器仿真（sim/Emm42Emulator.h，地址 1~4），
+ *    帧传输时间计入虚拟时间；
+ *  - USB 虚拟串口（Serial）由脚本注入命令行，--usb-pty 时同时接到一个伪终端，上位机工具可以直接打开；
+ *  - MQTT 经 WiFi 垫片使用主机 TCP，设置 UC_NET_HOST=127.0.0.1 指向本机 Broker（须配合 --speed 1）；
+ *  - 结束时输出任务调度统计、启动里程碑、队列深度、命令到首个运动帧的端到端延迟与总线仿真计数。
+ *
+ * 脚本每行一个事件，时刻为自启动起的毫秒数，# 开头为注释：
+ *   500   usb {"command":"speed","vx":0.3,"vy":0,"omega":0}
+ *   3000  wifi down | wifi up
+ *   4000  stall 2 on | stall 2 off
+ *   5000  faults <延迟us> <抖动us> <丢字节概率> <翻转概率>
+ *
+ * 运行：
+ *   pio run -e native_firmware && .pio/build/native_firmware/program --script sim/scripts/reconnect.txt
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <WiFi.h>
+#include "NativeSim.h"
+#include "Emm42Emulator.h"
+#include "config.h"
+#include "utils/BootProfiler.hpp"
+
+void setup();
+void loop();
+
+namespace {
+
+struct Options {
+    uint32_t durationMs = 10000;
+    double speed = 0.0;
+    uint32_t seed = 1;
+    const char* script = nullptr;
+    bool usbPty = false;
+    const char* link = nullptr;
+    Emm42Sim::LinkFaults faults;
+};
+
+void usage(const char* name) {
+    fprintf(stderr,
+            "用法: %s [选项]\n"
+            "  --duration S          仿真时长（秒，默认 10）\n"
+            "  --speed X             虚拟时间最高为真实时间的 X 倍，0 为不限速（默认）；接外部输入时用 1\n"
+            "  --seed N              总线故障注入随机种子\n"
+            "  --script FILE         事件脚本\n"
+            "  --usb-pty             USB 虚拟串口同时接到伪终端\n"
+            "  --link PATH           为伪终端从设备创建符号链接\n"
+            "  --latency US          驱动器应答处理延迟（默认 100）\n"
+            "  --jitter US           应答附加随机延迟上限\n"
+            "  --drop P              每字节丢失概率\n"
+            "  --corrupt P           每字节翻转一位的概率\n",
+            name);
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--usb-pty") == 0) {
+            opt.usbPty = true;
+            continue;
+        }
+        if (!value) {
+            return false;
+        }
+        ++i;
+        if (strcmp(arg, "--duration") == 0) {
+            opt.durationMs = static_cast<uint32_t>(strtod(value, nullptr) * 1000.0);
+        } else if (strcmp(arg, "--speed") == 0) {
+            opt.speed = strtod(value, nullptr);
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt.seed = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--script") == 0) {
+            opt.script = value;
+        } else if (strcmp(arg, "--link") == 0) {
+            opt.link = value;
+        } else if (strcmp(arg, "--latency") == 0) {
+            opt.faults.latencyUs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--jitter") == 0) {
+            opt.faults.jitterUs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(arg, "--drop") == 0) {
+            opt.faults.dropRate = strtod(value, nullptr);
+        } else if (strcmp(arg, "--corrupt") == 0) {
+            opt.faults.corruptRate = strtod(value, nullptr);
+        } else {
+            return false;
+        }
+    }
+    return opt.durationMs > 0;
+}
+
+//============================== 端到端延迟 ==============================
+
+// 运动命令（speed / move / stop）到达 USB 的时刻，等待第一个运动帧写到电机总线
+std::deque<uint64_t> pendingCommands;
+std::vector<uint32_t> commandLatencyUs;
+
+bool isMotionCommand(const std::string& line) {
+    return line.find("\"command\"") != std::string::npos &&
+           (line.find("\"speed\"") != std::string::npos || line.find("\"move\"") != std::string::npos ||
+            line.find("\"stop\"") != std::string::npos);
+}
+
+// 电机总线上写出运动帧：此前到达的运动命令全部计为已送达（被合并的命令一并计入）
+void motionFrameWritten(uint64_t nowUs) {
+    while (!pendingCommands.empty() && pendingCommands.front() <= nowUs) {
+        commandLatencyUs.push_back(static_cast<uint32_t>(nowUs - pendingCommands.front()));
+        pendingCommands.pop_front();
+    }
+}
+
+//============================== 串口后端 ==============================
+
+// 电机总线：驱动器仿真，帧按字节时间在线路上传输，flush() 阻塞到发送完成
+class EmulatorPort : public SerialBackend {
+public:
+    explicit EmulatorPort(Emm42Sim::Emm42Bus& bus) : bus(bus) {}
+
+    void setBaud(uint32_t baud) override {
+        bus.setHostBaud(baud);
+        bus.flushReplies();
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        const uint64_t now = NativeSim::nowUs();
+        const uint64_t startUs = std::max(now, lineFreeUs);
+        bus.write(data, size, startUs);
+        lineFreeUs = startUs + bus.wireUs(size);
+        // 速度模式 / 位置模式 / 立即停止
+        if (size >= 2 && (data[1] == 0xF6 || data[1] == 0xFD || data[1] == 0xFE)) {
+            motionFrameWritten(now);
+        }
+        return size;
+    }
+
+    int available() override { return bus.available(NativeSim::nowUs()); }
+
+    int read() override { return bus.read(NativeSim::nowUs()); }
+
+    void flush() override { NativeSim::sleepUntilUs(lineFreeUs); }
+
+private:
+    Emm42Sim::Emm42Bus& bus;
+    uint64_t lineFreeUs = 0;
+};
+
+// USB 虚拟串口：输入来自脚本与伪终端，输出写到伪终端（没有时写到标准输出）
+class UsbPort : public SerialBackend {
+public:
+    void openPty(const char* link) {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            perror("posix_openpt");
+            exit(1);
+        }
+        const char* slaveName = ptsname(master);
+        // 保持从设备打开：没有客户端时主设备读取不会返回 EIO
+        slave = open(slaveName, O_RDWR | O_NOCTTY);
+        struct termios tio;
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        if (link) {
+            unlink(link);
+            if (symlink(slaveName, link) != 0) {
+                perror("symlink");
+            }
+        }
+        fprintf(stderr, "firmware_sim: USB on %s%s%s\n", slaveName, link ? " -> " : "", link ? link : "");
+    }
+
+    // 脚本注入一行命令
+    void inject(const std::string& line) {
+        receive(line.data(), line.size());
+        receive("\n", 1);
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        const int fd = master >= 0 ? master : STDOUT_FILENO;
+        size_t sent = 0;
+        while (sent < size) {
+            ssize_t n = ::write(fd, data + sent, size - sent);
+            if (n <= 0) {
+                break;      // 伪终端没有读取方时丢弃
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return size;
+    }
+
+    int available() override {
+        pollPty();
+        return static_cast<int>(input.size());
+    }
+
+    int read() override {
+        pollPty();
+        if (input.empty()) {
+            return -1;
+        }
+        uint8_t b = input.front();
+        input.pop_front();
+        return b;
+    }
+
+private:
+    void pollPty() {
+        if (master < 0) {
+            return;
+        }
+        char buffer[256];
+        ssize_t n;
+        while ((n = ::read(master, buffer, sizeof(buffer))) > 0) {
+            receive(buffer, static_cast<size_t>(n));
+        }
+    }
+
+    // 输入字节按行登记运动命令的到达时刻
+    void receive(const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            input.push_back(static_cast<uint8_t>(data[i]));
+            if (data[i] == '\n') {
+                if (isMotionCommand(line)) {
+                    pendingCommands.push_back(NativeSim::nowUs());
+                }
+                line.clear();
+            } else if (data[i] != '\r') {
+                line += data[i];
+            }
+        }
+    }
+
+    int master = -1;
+    int slave = -1;
+    std::deque<uint8_t> input;
+    std::string line;
+};
+
+//============================== 事件脚本 ==============================
+
+struct Event {
+    uint32_t atMs;
+    std::string action;
+    std::string argument;
+};
+
+bool loadScript(const char* path, std::vector<Event>& events) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    char text[1024];
+    int lineNo = 0;
+    while (fgets(text, sizeof(text), file)) {
+        ++lineNo;
+        std::string line(text);
+        while (!line.empty() && isspace(static_cast<unsigned char>(line.back()))) {
+            line.pop_back();
+        }
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        char* end = nullptr;
+        Event event;
+        event.atMs = static_cast<uint32_t>(strtoul(line.c_str() + start, &end, 0));
+        const char* p = end;
+        while (*p == ' ' || *p == '\t') ++p;
+        const char* actionEnd = p;
+        while (*actionEnd && *actionEnd != ' ' && *actionEnd != '\t') ++actionEnd;
+        event.action.assign(p, actionEnd);
+        while (*actionEnd == ' ' || *actionEnd == '\t') ++actionEnd;
+        event.argument = actionEnd;
+        if (end == line.c_str() + start || (event.action != "usb" && event.action != "wifi" &&
+                                            event.action != "stall" && event.action != "faults")) {
+            fprintf(stderr, "%s:%d: invalid event: %s\n", path, lineNo, line.c_str());
+            fclose(file);
+            return false;
+        }
+        events.push_back(event);
+    }
+    fclose(file);
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.atMs < b.atMs; });
+    return true;
+}
+
+Options options;
+Emm42Sim::Emm42Bus* motorSim = nullptr;
+UsbPort usbPort;
+std::vector<Event> events;
+
+void apply(const Event& event) {
+    if (event.action == "usb") {
+        usbPort.inject(event.argument);
+    } else if (event.action == "wifi") {
+        WiFi.setLinkUp(event.argument != "down");
+    } else if (event.action == "stall") {
+        unsigned address = 0;
+        char state[8] = {};
+        if (sscanf(event.argument.c_str(), "%u %7s", &address, state) == 2) {
+            if (Emm42Sim::VirtualDriver* driver = motorSim->driver(static_cast<uint8_t>(address))) {
+                driver->setStalled(strcmp(state, "on") == 0);
+            }
+        }
+    } else if (event.action == "faults") {
+        Emm42Sim::LinkFaults faults;
+        if (sscanf(event.argument.c_str(), "%u %u %lf %lf", &faults.latencyUs, &faults.jitterUs,
+                   &faults.dropRate, &faults.corruptRate) >= 1) {
+            motorSim->setFaults(faults);
+        }
+    }
+}
+
+// 最高优先级：按时刻执行脚本事件，不受固件任务的调度影响
+void scriptTask(void*) {
+    for (const Event& event : events) {
+        NativeSim::sleepUntilUs(static_cast<uint64_t>(event.atMs) * 1000);
+        apply(event);
+    }
+    vTaskDelete(NULL);
+}
+
+//============================== 报告 ==============================
+
+uint32_t percentile(std::vector<uint32_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+void printReport() {
+    fprintf(stdout, "\n==== firmware_sim: %.3f s virtual, seed %lu ====\n", NativeSim::nowUs() / 1e6,
+            static_cast<unsigned long>(options.seed));
+
+    NativeSim::TaskStats tasks[32];
+    size_t taskCount = std::min(NativeSim::taskStats(tasks, 32), static_cast<size_t>(32));
+    fprintf(stdout, "\n%-16s %4s %8s %10s %6s %12s %12s %12s\n", "task", "prio", "runs", "cpu(ms)", "cpu%",
+            "wait-avg(us)", "wait-max(us)", "max-gap(ms)");
+    const double totalUs = static_cast<double>(NativeSim::nowUs());
+    for (size_t i = 0; i < taskCount; ++i) {
+        const NativeSim::TaskStats& t = tasks[i];
+        fprintf(stdout, "%-16s %4u %8lu %10.1f %6.2f %12.1f %12llu %12.1f%s\n", t.name, t.priority,
+                static_cast<unsigned long>(t.runs), t.cpuUs / 1000.0, totalUs > 0 ? t.cpuUs * 100.0 / totalUs : 0.0,
+                t.runs ? static_cast<double>(t.readyWaitTotalUs) / t.runs : 0.0,
+                static_cast<unsigned long long>(t.readyWaitMaxUs), t.maxGapUs / 1000.0,
+                t.finished ? "  (finished)" : "");
+    }
+
+    fprintf(stdout, "\nboot milestones (us since reset):");
+    for (size_t i = 0; i < BootProfiler::count(); ++i) {
+        BootProfiler::Milestone m = BootProfiler::at(i);
+        if (m.name) {
+            fprintf(stdout, "  %s %lu", m.name, static_cast<unsigned long>(m.us));
+        }
+    }
+    fprintf(stdout, "\n");
+
+    NativeSim::QueueStats queues[32];
+    size_t queueCount = std::min(NativeSim::queueStats(queues, 32), static_cast<size_t>(32));
+    fprintf(stdout, "\n%-16s %6s %8s %10s %8s %8s\n", "queue", "length", "waiting", "high-water", "sends",
+            "full");
+    for (size_t i = 0; i < queueCount; ++i) {
+        const NativeSim::QueueStats& q = queues[i];
+        if (!q.name) {
+            continue;   // 未登记名称的临时队列
+        }
+        fprintf(stdout, "%-16s %6u %8u %10u %8lu %8lu\n", q.name, q.length, q.waiting, q.highWater,
+                static_cast<unsigned long>(q.sends), static_cast<unsigned long>(q.fullRejects));
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t v : commandLatencyUs) {
+        sum += v;
+    }
+    fprintf(stdout, "\ncommand -> first motion frame: count %zu  avg %.0f us  p50 %lu us  p99 %lu us  max %lu us"
+            "  undelivered %zu\n", commandLatencyUs.size(),
+            commandLatencyUs.empty() ? 0.0 : static_cast<double>(sum) / commandLatencyUs.size(),
+            static_cast<unsigned long>(percentile(commandLatencyUs, 0.5)),
+            static_cast<unsigned long>(percentile(commandLatencyUs, 0.99)),
+            static_cast<unsigned long>(percentile(commandLatencyUs, 1.0)), pendingCommands.size());
+
+    const Emm42Sim::BusCounters& c = motorSim->counters();
+    fprintf(stdout, "motor bus emulator: frames %lu  ignored %lu  replies %lu  dropped %lu  corrupted %lu\n",
+            static_cast<unsigned long>(c.frames), static_cast<unsigned long>(c.ignored),
+            static_cast<unsigned long>(c.replies), static_cast<unsigned long>(c.droppedBytes),
+            static_cast<unsigned long>(c.corruptedBytes));
+    fflush(stdout);
+}
+
+// 最高优先级：到时输出报告并结束进程（其余任务停在各自的阻塞点上，不做析构）
+void reportTask(void*) {
+    NativeSim::sleepUntilUs(static_cast<uint64_t>(options.durationMs) * 1000);
+    printReport();
+    _Exit(0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (options.script && !loadScript(options.script, events)) {
+        return 2;
+    }
+
+    // 与 ESP32 Arduino 一样，setup() / loop() 在优先级 1 的 loopTask 中运行
+    NativeSim::beginVirtualTime("loopTask", 1, options.speed);
+
+    static Emm42Sim::Emm42Bus bus(MOTOR_BUS_BAUD, options.seed);
+    bus.setFaults(options.faults);
+    for (uint8_t addr = 1; addr <= 4; ++addr) {
+        bus.addDriver(addr);
+    }
+    motorSim = &bus;
+    static EmulatorPort motorPort(bus);
+    HardwareSerial::attachBackend(0, &motorPort);
+
+    if (options.usbPty) {
+        usbPort.openPty(options.link);
+    }
+    HardwareSerial::attachBackend(HardwareSerial::USB_CDC, &usbPort);
+
+    xTaskCreate(reportTask, "simReport", 4096, NULL, 24, NULL);
+    if (!events.empty()) {
+        xTaskCreate(scriptTask, "simScript", 4096, NULL, 23, NULL);
+    }
+
+    setup();
+    for (;;) {
+        loop();
+    }
+}
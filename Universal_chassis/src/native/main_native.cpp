@@ -0,0 +1,174 @@
+/*
+ * @Description: 控制栈主机运行入口（[env:native]）
+ *
+ * 在 Linux 上以 lib/NativeHal 的 Arduino/FreeRTOS 垫片运行 MotorBus、StepperMotor、CarController 与
+ * ControlManager。启动流程与 main.cpp 相同（总线任务 → 探测 → 使能 → 周期预算 → 控制任务），
+ * 随后执行一段固定的运动脚本，输出里程计、总线统计与急停延迟，用于在工作站上配合 perf 与 sanitizer
+ * 分析热点路径。
+ *
+ * 电机总线：
+ *  - 默认使用进程内仿真总线（sim/EmulatedTransport.h，四个驱动器，地址 1~4）；
+ *  - 设置 UC_SERIAL1=<设备> 时经 HardwareSerial 垫片使用该串口，例如真实的 USB 转串口，
+ *    或 sim/emm42_pty 创建的伪终端。
+ *
+ * 运行：
+ *   pio run -e native && .pio/build/native/program [运行秒数，默认 6]
+ */
+
+#include <Arduino.h>
+#include <cstdlib>
+#include <memory>
+#include "StepperMotor/StepperMotor.h"
+#include "StepperMotor/MotorBus.h"
+#include "StepperMotor/MotorDiscovery.h"
+#include "ParamStore/ParamStore.h"
+#include "CarController/CarController.h"
+#include "KinematicsModel/KinematicsModel.h"
+#include "control/ControlManager.hpp"
+#include "utils/Logger.hpp"
+#include "utils/BootProfiler.hpp"
+#include "config.h"
+#include "EmulatedTransport.h"
+
+namespace {
+
+// 每 500 ms 输出一次里程计与车轮转速
+void printState(uint32_t startMs) {
+    ControlManager& manager = ControlManager::getInstance();
+    Odometer odom = manager.getOdometer();
+    CarState state = manager.getCarState();
+    Serial.printf("%6.2f s  x %7.3f  y %7.3f  theta %6.3f  wheels %5d %5d %5d %5d rpm\n",
+                  (millis() - startMs) / 1000.0, odom.x, odom.y, odom.theta,
+                  state.wheelSpeeds[0], state.wheelSpeeds[1], state.wheelSpeeds[2], state.wheelSpeeds[3]);
+}
+
+void printBusStats() {
+    ControlManager& manager = ControlManager::getInstance();
+    for (size_t b = 0; b < manager.getBusCount(); ++b) {
+        std::unique_ptr<BusStatsReport> report(new BusStatsReport());
+        if (!manager.getBusStats(b, *report)) {
+            continue;
+        }
+        Serial.printf("\nbus %zu: window %lu ms, utilisation %.1f %%\n", b,
+                      static_cast<unsigned long>(report->windowMs), report->utilisation);
+        Serial.printf("  addr func   count retry tmout   avg(us)   p99(us)   max(us)\n");
+        for (size_t i = 0; i < report->entryCount; ++i) {
+            const BusStatsSummary& e = report->entries[i];
+            Serial.printf("  %4u  %02X %8lu %5lu %5lu %9lu %9lu %9lu\n", e.address, e.funcCode,
+                          static_cast<unsigned long>(e.count), static_cast<unsigned long>(e.retries),
+                          static_cast<unsigned long>(e.timeouts), static_cast<unsigned long>(e.avgUs),
+                          static_cast<unsigned long>(e.p99Us), static_cast<unsigned long>(e.maxUs));
+        }
+    }
+    EStopStats estop = manager.getEStopStats();
+    Serial.printf("\nestop: count %lu  last %lu us  max %lu us  unconfirmed %lu\n",
+                  static_cast<unsigned long>(estop.count), static_cast<unsigned long>(estop.lastUs),
+                  static_cast<unsigned long>(estop.maxUs), static_cast<unsigned long>(estop.unconfirmed));
+    LoopStats loop = manager.getLoopStats();
+    Serial.printf("loop: %lu Hz  cycles %lu  overruns %lu  skipped %lu  jitter avg %lu p99 %lu max %lu us"
+                  "  work avg %lu p99 %lu max %lu us\n",
+                  static_cast<unsigned long>(loop.rateHz), static_cast<unsigned long>(loop.cycles),
+                  static_cast<unsigned long>(loop.overruns), static_cast<unsigned long>(loop.skipped),
+                  static_cast<unsigned long>(loop.jitterAvgUs), static_cast<unsigned long>(loop.jitterP99Us),
+                  static_cast<unsigned long>(loop.jitterMaxUs), static_cast<unsigned long>(loop.workAvgUs),
+                  static_cast<unsigned long>(loop.workP99Us), static_cast<unsigned long>(loop.workMaxUs));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t runSeconds = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : 6;
+
+    Serial.begin(115200);
+    Logger::init(getenv("UC_DEBUG") ? LOG_LEVEL_DEBUG : LOG_LEVEL_INFO);
+    BootProfiler::mark("setup");
+
+    // 电机总线：指定串口设备时使用真实链路，否则使用进程内仿真总线
+    HardwareSerial motorPort(1);
+    Emm42Sim::Emm42Bus simBus(MOTOR_BUS_BAUD);
+    Emm42Sim::SteadyClock simClock;
+    Emm42Sim::EmulatedTransport simTransport(simBus, simClock);
+    std::unique_ptr<MotorBus> motorBus;
+    if (getenv("UC_SERIAL1")) {
+        motorPort.begin(MOTOR_BUS_BAUD);
+        motorBus.reset(new MotorBus(&motorPort));
+        Logger::info("NATIVE", "Motor bus on %s", getenv("UC_SERIAL1"));
+    } else {
+        for (uint8_t addr = 1; addr <= 4; ++addr) {
+            simBus.addDriver(addr);
+        }
+        motorBus.reset(new MotorBus(&simTransport));
+        Logger::info("NATIVE", "Motor bus on in-process emulator");
+    }
+
+    StepperMotor motor0(0, motorBus.get(), ChecksumType::FIXED);
+    StepperMotor motor1(1, motorBus.get(), ChecksumType::FIXED);
+    StepperMotor motor2(2, motorBus.get(), ChecksumType::FIXED);
+    StepperMotor motor3(3, motorBus.get(), ChecksumType::FIXED);
+    StepperMotor motor4(4, motorBus.get(), ChecksumType::FIXED);
+    NormalWheelKinematics kinematics(0.09f, 0.45f, 6);
+    CarController carController(&motor1, &motor2, &motor3, &motor4, &motor0, &kinematics);
+
+    ParamStore paramStore;
+    paramStore.begin(kinematics.geometry(), carController.getConfig());
+    carController.setGeometry(paramStore.geometry());
+    carController.configure(paramStore.controlConfig());
+    ControlManager::getInstance().setParamStore(&paramStore);
+
+    motorBus->begin();
+    BootProfiler::mark("motor_bus");
+    ControlManager::getInstance().init(&carController, false);
+    ControlManager::getInstance().setLoopRate(CONTROL_LOOP_HZ);
+
+    MotorTable motorTable;
+    MotorBus* buses[] = {motorBus.get()};
+    MotorDiscovery discovery(buses, 1);
+    discovery.run(motorTable);
+    Logger::info("NATIVE", "Motor discovery: %u found in %lu us", static_cast<unsigned>(motorTable.count),
+                 static_cast<unsigned long>(motorTable.elapsedUs));
+    if (!carController.applyMotorTable(motorTable)) {
+        Logger::error("NATIVE", "Motor bus misconfigured: missing wheels or inconsistent driver settings");
+    }
+    BootProfiler::mark("discovery");
+
+    BusResult enabled = carController.enableMotors(true);
+    if (!enabled) {
+        Logger::error("NATIVE", "Enable motors failed: %s", busErrorName(enabled.error));
+    }
+    motorBus->setCycleBudget(MOTOR_BUS_CYCLE_US, MOTOR_BUS_SETPOINT_BUDGET_US,
+                             MOTOR_BUS_TELEMETRY_BUDGET_US, MOTOR_BUS_DIAGNOSTIC_BUDGET_US);
+    ControlManager::getInstance().start();
+    BootProfiler::mark("motors_ready");
+    BootProfiler::report();
+
+    // 运动脚本：前进 → 原地旋转 → 位置运动 → 急停
+    ControlManager& manager = ControlManager::getInstance();
+    const uint32_t startMs = millis();
+    const uint32_t runMs = runSeconds * 1000;
+    uint32_t lastPrintMs = 0;
+    int phase = -1;
+    while (millis() - startMs < runMs) {
+        const uint32_t elapsed = millis() - startMs;
+        const int next = static_cast<int>(elapsed * 4 / runMs);
+        if (next != phase) {
+            phase = next;
+            switch (phase) {
+                case 0: manager.setSpeed(0.3f, 0.0f, 0.0f); break;
+                case 1: manager.setSpeed(0.0f, 0.0f, 0.5f); break;
+                case 2: manager.moveDistance(0.2f, 0.0f, 0.0f); break;
+                default: manager.setSpeed(0.2f, 0.0f, 0.2f); break;
+            }
+        }
+        if (elapsed - lastPrintMs >= 500) {
+            lastPrintMs = elapsed;
+            printState(startMs);
+        }
+        delay(10);
+    }
+    manager.stop(micros());
+    delay(100);
+    printState(startMs);
+    printBusStats();
+    // 后台任务（总线、控制）不会退出，直接结束进程
+    _Exit(0);
+}